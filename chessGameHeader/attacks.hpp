@@ -0,0 +1,91 @@
+#ifndef ATTACKS_HPP
+#define ATTACKS_HPP
+
+#include "bitboard.hpp"
+#include "../piecesHeader/pieceType.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+//PEXT can be picked at run time on x86, every other target only has the magic multiply
+#define ATTACKS_RUNTIME_PEXT 1
+#endif
+
+//Precomputed attack sets. Sliders use magic bitboards: the blockers on the
+//relevant rays are hashed (magic multiply, or PEXT on CPUs with BMI2) into an
+//index of a table holding the attack set for that exact blocker pattern.
+struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    unsigned shift;
+};
+
+extern Magic rookMagics[64];
+extern Magic bishopMagics[64];
+extern Bitboard knightAttackTable[64];
+extern Bitboard kingAttackTable[64];
+extern Bitboard pawnAttackTable[2][64];
+extern Bitboard betweenTable[64][64];
+extern Bitboard lineTable[64][64];
+extern bool sliderUsesPext;
+
+//Fills every table, runs once before main but is safe to call again.
+//allowPext = false forces the magic multiply path even on BMI2 hardware.
+void initAttacks(bool allowPext = true);
+
+#if defined(ATTACKS_RUNTIME_PEXT)
+//Out of line PEXT for builds that were not compiled with BMI2 enabled
+unsigned pextIndex(Bitboard occupancy, Bitboard mask);
+#endif
+
+inline unsigned magicIndex(const Magic& m, Bitboard occupancy){
+#if defined(__BMI2__)
+    return static_cast<unsigned>(_pext_u64(occupancy, m.mask));
+#else
+#if defined(ATTACKS_RUNTIME_PEXT)
+    if (sliderUsesPext){
+        return pextIndex(occupancy, m.mask);
+    }
+#endif
+    return static_cast<unsigned>(((occupancy & m.mask) * m.magic) >> m.shift);
+#endif
+}
+
+inline Bitboard rookAttacks(int sq, Bitboard occupancy){
+    const Magic& m = rookMagics[sq];
+    return m.attacks[magicIndex(m, occupancy)];
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupancy){
+    const Magic& m = bishopMagics[sq];
+    return m.attacks[magicIndex(m, occupancy)];
+}
+
+inline Bitboard queenAttacks(int sq, Bitboard occupancy){
+    return rookAttacks(sq, occupancy) | bishopAttacks(sq, occupancy);
+}
+
+inline Bitboard knightAttacks(int sq){
+    return knightAttackTable[sq];
+}
+
+inline Bitboard kingAttacks(int sq){
+    return kingAttackTable[sq];
+}
+
+//Squares a pawn of the given color on sq attacks
+inline Bitboard pawnAttacks(Color col, int sq){
+    return pawnAttackTable[static_cast<int>(col)][sq];
+}
+
+//Squares strictly between a and b when they share a rank, file or diagonal, otherwise empty
+inline Bitboard between(int a, int b){
+    return betweenTable[a][b];
+}
+
+//The full rank, file or diagonal through a and b (both included), otherwise empty
+inline Bitboard lineThrough(int a, int b){
+    return lineTable[a][b];
+}
+
+#endif /* ATTACKS_HPP */
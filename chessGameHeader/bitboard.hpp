@@ -0,0 +1,43 @@
+#ifndef BITBOARD_HPP
+#define BITBOARD_HPP
+
+#include <cstdint>
+
+//One bit per square, bit 0 is a1 and bit 63 is h8.
+typedef uint64_t Bitboard;
+
+//The rest of the game uses (row, col) with row 0 being rank 8 and col 0 being file a,
+//these convert between that and the bit index used by the bitboards.
+inline int squareIndex(int row, int col){
+    return (7 - row) * 8 + col;
+}
+
+inline int rowOf(int sq){
+    return 7 - (sq >> 3);
+}
+
+inline int colOf(int sq){
+    return sq & 7;
+}
+
+inline Bitboard squareBit(int sq){
+    return 1ULL << sq;
+}
+
+inline int popCount(Bitboard b){
+    return __builtin_popcountll(b);
+}
+
+//Index of the lowest set bit, b must not be empty
+inline int lsb(Bitboard b){
+    return __builtin_ctzll(b);
+}
+
+//Returns the lowest set bit and clears it from b
+inline int popLsb(Bitboard& b){
+    int sq = __builtin_ctzll(b);
+    b &= b - 1;
+    return sq;
+}
+
+#endif /* BITBOARD_HPP */
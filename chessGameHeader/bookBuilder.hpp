@@ -0,0 +1,87 @@
+#ifndef BOOKBUILDER_HPP
+#define BOOKBUILDER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "openingBook.hpp"
+#include "pgn.hpp"
+
+struct BookBuildOptions {
+    //Positions after this many plies are not put in the book
+    int maxPlies = 20;
+    //Moves played fewer times than this are left out
+    int minGames = 1;
+    int threads = 1;
+    //Games handed to a worker at a time
+    int batchSize = 256;
+};
+
+//Results after one move from one position, from the side that made the move
+struct MoveStats {
+    uint32_t wins;
+    uint32_t draws;
+    uint32_t losses;
+};
+
+struct StatsKey {
+    uint64_t key;
+    uint16_t move;
+
+    bool operator==(const StatsKey& other) const {
+        return key == other.key && move == other.move;
+    }
+};
+
+struct StatsKeyHash {
+    size_t operator()(const StatsKey& k) const {
+        return static_cast<size_t>(k.key ^ (k.move * 0x9E3779B97F4A7C15ULL));
+    }
+};
+
+//Statistics per (Polyglot key, move), spread over shards with a lock each so worker
+//threads adding games at the same time rarely wait for each other
+class BookStatistics {
+ private:
+   struct Shard {
+       std::mutex lock;
+       std::unordered_map<StatsKey, MoveStats, StatsKeyHash> moves;
+   };
+   int maxPlies;
+   std::vector<std::unique_ptr<Shard>> shards;
+   std::atomic<uint64_t> games;
+   std::atomic<uint64_t> rejected;
+
+   size_t shardOf(uint64_t key) const {
+       return static_cast<size_t>(key >> 32) % shards.size();
+   }
+
+ public:
+   explicit BookStatistics(int plies, int shardCount = 64);
+
+   //Counts the first maxPlies positions of every game with a result. Games with a move
+   //that does not parse are left out. Safe to call from several threads.
+   void addGames(const std::vector<PgnGame>& batch);
+   //Games that went into the statistics
+   uint64_t getGames() const;
+   //Games left out, without a result or with a move that could not be played
+   uint64_t getRejected() const;
+   MoveStats lookup(uint64_t key, uint16_t move) const;
+
+   //Records for the moves played at least minGames times that scored anything, weighted
+   //2 * wins + draws and scaled down together when that does not fit in 16 bits
+   std::vector<BookEntry> toEntries(int minGames) const;
+};
+
+//Streams the files through one reader and options.threads workers, only a few batches
+//of games are in memory at any time, and writes the book. False if nothing could be read
+//or the book could not be written.
+bool buildBook(const std::vector<std::string>& pgnFiles, const std::string& bookPath, const BookBuildOptions& options, std::ostream* log = nullptr);
+
+#endif /* BOOKBUILDER_HPP */
@@ -0,0 +1,98 @@
+#ifndef BOUNDEDQUEUE_HPP
+#define BOUNDEDQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+//Fixed size queue any number of threads can push to and pop from without a lock.
+//Every cell carries a sequence number saying whose turn it is: a pusher claims a
+//slot by moving the head on with a compare and swap and then publishes the value
+//by bumping the cell's sequence, a popper does the same from the tail.
+template <typename T>
+class BoundedQueue {
+ private:
+   struct Cell {
+       std::atomic<size_t> sequence;
+       T value;
+   };
+   std::unique_ptr<Cell[]> cells;
+   size_t mask;
+   //On their own cache lines so pushers and poppers do not slow each other down
+   alignas(64) std::atomic<size_t> head;
+   alignas(64) std::atomic<size_t> tail;
+
+ public:
+   //Capacity is rounded up to a power of two
+   explicit BoundedQueue(size_t capacity) : head(0), tail(0) {
+       size_t size = 2;
+       while (size < capacity){
+           size <<= 1;
+       }
+       cells.reset(new Cell[size]);
+       mask = size - 1;
+       for (size_t i = 0; i < size; ++i){
+           cells[i].sequence.store(i, std::memory_order_relaxed);
+       }
+   }
+   BoundedQueue(const BoundedQueue&) = delete;
+   BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+   size_t capacity() const {
+       return mask + 1;
+   }
+
+   //False when the queue is full, value is then left alone
+   bool tryPush(T& value){
+       size_t pos = head.load(std::memory_order_relaxed);
+       Cell* cell;
+       for (;;){
+           cell = &cells[pos & mask];
+           size_t sequence = cell->sequence.load(std::memory_order_acquire);
+           intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+           if (diff == 0){
+               if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                   break;
+               }
+           }
+           else if (diff < 0){
+               return false;
+           }
+           else {
+               pos = head.load(std::memory_order_relaxed);
+           }
+       }
+       cell->value = std::move(value);
+       cell->sequence.store(pos + 1, std::memory_order_release);
+       return true;
+   }
+
+   //False when the queue is empty
+   bool tryPop(T& value){
+       size_t pos = tail.load(std::memory_order_relaxed);
+       Cell* cell;
+       for (;;){
+           cell = &cells[pos & mask];
+           size_t sequence = cell->sequence.load(std::memory_order_acquire);
+           intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+           if (diff == 0){
+               if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                   break;
+               }
+           }
+           else if (diff < 0){
+               return false;
+           }
+           else {
+               pos = tail.load(std::memory_order_relaxed);
+           }
+       }
+       value = std::move(cell->value);
+       cell->sequence.store(pos + mask + 1, std::memory_order_release);
+       return true;
+   }
+};
+
+#endif /* BOUNDEDQUEUE_HPP */
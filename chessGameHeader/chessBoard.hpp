@@ -2,41 +2,70 @@
 #define CHESSBOARD_HPP
 
 #include <memory>
+#include <vector>
+#include "../piecesHeader/piece.hpp"
 #include "square.hpp"
-
-class Square;
+#include "position.hpp"
 
 // enum class Color {Black, White, none};
 
 class chessBoard{
 private:
-  std::unique_ptr<Square> board[8][8];
+  //views only, every piece lives in position as a one byte code
+  mutable Square board[8][8];
+  Position position;
+  //one record per move made through makeMove, the top one is what unmakeMove restores
+  std::vector<UndoState> undoStack;
+
+  void updateMoveState(int sourceX, int sourceY, int targetX, int targetY);
+  void bindSquares();
 
 public:
   chessBoard();
+  chessBoard(const chessBoard& other);
+  chessBoard& operator=(const chessBoard& other);
   Square& getSquare(int row, int col) const;
   void displayBoard();
   void displayBoardFromBlackSide();
   void setupBoard();
+  //Replaces the whole board, rights, counters and side to move included, and drops the
+  //move history. A malformed string is rejected and leaves the board as it was.
+  bool loadFEN(const char* fen);
+  std::string toFEN() const;
+
+  //bitboard state behind the squares
+  const Position& getPosition() const;
+  bool isOccupied(int row, int col) const;
+  PieceCode getPieceCode(int row, int col) const;
+  void setPieceCode(int row, int col, PieceCode code);
+
+  //legal moves straight from the bitboards, pins and checks included
+  void generateLegalMoves(Color side, MoveList& moves, GenStage stage = GenStage::ALL) const;
+  bool isLegalMove(int sourceX, int sourceY, int targetX, int targetY) const;
+  Move findLegalMove(int sourceX, int sourceY, int targetX, int targetY) const;
+  bool isInCheck(Color side) const;
 
 
+  //reversible moves, the board keeps its own stack of undo records
+  void makeMove(Move m);
+  bool unmakeMove();
+  int getPlyCount() const;
+  const std::vector<UndoState>& getUndoHistory() const;
+  uint64_t getHashKey() const;
+  //Times the current position has stood on the board, this time included. Only every
+  //second ply back to the last capture or pawn move can match, so that is all it scans.
+  int repetitionCount() const;
+
   //newFunction
   void movePiece(int sourceX, int sourceY, int targetX, int targetY);
   void capture(int sourceX, int sourceY, int targetX, int targetY);
 
   
 
-  //additional functions for pawn 
-  bool EnPassantPossible(int sourceX, int sourceY, int targetX, int targetY);
-  void perfomEnPassant(int sourceX, int sourceY, int targetX, int targetY);
-  bool pawnPromotionPossible(int sourceX, int sourceY, int targetX, int targetY);
-  void performPawnPromotion(int sourceX, int sourceY, int targetX, int targetY);
-
-
   //additional functions for king
-  bool willRemoveCheck(int sourceX, int sourceY, int targetX, int targetY, int kingX, int kingY) const ;
-  bool willKingGetChecked(int sourceX, int sourceY, int targetX, int targetY, int kingX, int kingY) const ;
-  bool isKingChecked(int sourceX, int sourceY, int targetX, int targetY, int kingX, int kingY) const ;
+  bool willRemoveCheck(int sourceX, int sourceY, int targetX, int targetY) const ;
+  bool willKingGetChecked(int sourceX, int sourceY, int targetX, int targetY) const ;
+  bool isKingChecked(int kingX, int kingY) const ;
 
 
 };
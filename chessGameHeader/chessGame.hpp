@@ -7,12 +7,16 @@
 
 
 #include "chessBoard.hpp"
+#include "move.hpp"
+#include "engine.hpp"
 
 
 class chessBoard;
 enum class Color;
 
 enum class gameStatus {IN_PROGRESS, CHECKMATE, DRAW, STALEMATE, CHECK};
+//Why a game with status DRAW ended
+enum class drawReason {NONE, REPETITION, FIFTY_MOVES, INSUFFICIENT_MATERIAL};
 
 
 using namespace std;
@@ -23,11 +27,17 @@ class chessGame{
    std::unique_ptr<chessBoard> board;
    std::pair<int, int> whiteKingPosition;
    std::pair<int, int> blackKingPosition;
-   vector<string> moves;
+   vector<Move> moves;
    bool lastMove;
    gameStatus gameStatusNow;
+   drawReason drawReasonNow;
    vector<string> player1Captured;
    vector<string> player2Captured;
+   vector<Move> redoMoves;
+
+   void applyMove(Move move);
+   void syncKingPositions();
+   void updateStatusAfterMove();
    
 
 
@@ -42,15 +52,28 @@ class chessGame{
    chessGame();
    void startGame();
    void makeMove(int sourceX, int sourceY, int targetX, int targetY, bool white);
+   void makeMove(Move move, bool white);
+   Move buildMove(int sourceX, int sourceY, int targetX, int targetY) const;
    void updateGameStatus(gameStatus status);
    gameStatus getGameStatus() const;
-   void addMoves(int row, int col);
+   drawReason getDrawReason() const;
+   void printGameResult() const;
+   void addMoves(Move move);
+   const vector<Move>& getMoveHistory() const;
    void printMoveHistory();
    string getStringOfMove(int targetX, int targetY) const;
    bool moveSucess();
    void updateKingPosition(Color color, int x, int y);
    void updateCaptured(Color col, string piece);
    void printCapturedPieces(bool white);
+   bool undoMove();
+   bool redoMove();
+   const chessBoard& getBoard() const;
+   //Material count kept by the board as it changes, White minus Black in centipawns
+   int getMaterialBalance() const;
+   void printMaterialBalance() const;
+   //Lets the engine pick and play the move for the side to move, false if it has none
+   bool playComputerMove(Engine& engine, const SearchLimits& limits, bool white);
    
 
 
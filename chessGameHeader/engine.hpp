@@ -0,0 +1,139 @@
+#ifndef ENGINE_HPP
+#define ENGINE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "position.hpp"
+#include "transpositionTable.hpp"
+#include "pawns.hpp"
+#include "tablebase.hpp"
+#include "syzygy.hpp"
+#include "openingBook.hpp"
+
+//Deepest ply the search keeps tables for, quiescence stops here as well
+const int MAX_PLY = 128;
+
+//Scores are centipawns from the side to move, mates count down from MATE_SCORE by ply
+const int MATE_SCORE = 32000;
+const int INFINITE_SCORE = 32001;
+//Syzygy wins carry no distance to mate, they score just below every mate the search finds
+const int SYZYGY_WIN_SCORE = MATE_SCORE - 2 * MAX_PLY;
+
+//Any limit left at 0 is not used, with nothing set the search stops at maxDepth
+struct SearchLimits {
+    int maxDepth = 64;
+    uint64_t maxNodes = 0;
+    int64_t maxTimeMs = 0;
+};
+
+//What the last completed iteration found
+struct SearchResult {
+    Move bestMove;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    double seconds = 0;
+    uint64_t nodesPerSecond = 0;
+    std::vector<Move> principalVariation;
+};
+
+//Computer player: negamax alpha-beta with iterative deepening and a capture only
+//quiescence search. Results go to a transposition table that can be shared with
+//other engines, which is how the Lazy SMP helper threads cooperate. Moves are tried
+//hash/PV move first, then captures by MVV-LVA, then killer moves, then quiet moves
+//by their history score.
+class Engine {
+ private:
+   Position position;
+   const Network* network;
+   //Per thread, evaluate is const but filling the cache is not
+   mutable PawnTable pawnTable;
+   //Endgame tables, positions they cover are scored from them instead of searched
+   const Tablebases* tablebases;
+   //Syzygy tables, probed where the own tables have nothing
+   const SyzygyTablebases* syzygy;
+   //Opening book consulted before searching, with its own random stream for reproducible picks
+   const OpeningBook* book;
+   BookSelection bookSelection;
+   uint64_t bookRandom;
+   //Either the engine's own table or one shared with other engines
+   std::unique_ptr<TranspositionTable> ownTable;
+   TranspositionTable* table;
+   //Zobrist keys of the game so far followed by the current search path, for repetitions
+   std::vector<uint64_t> keyHistory;
+
+   Move killers[MAX_PLY][2];
+   int history[2][64][64];
+   Move pvTable[MAX_PLY][MAX_PLY];
+   int pvLength[MAX_PLY];
+   //Principal variation of the last finished iteration, its moves are tried first
+   Move previousPv[MAX_PLY];
+   int previousPvLength;
+
+   SearchLimits limits;
+   std::chrono::steady_clock::time_point startTime;
+   uint64_t nodes;
+   bool stopped;
+   //Lazy SMP: the main search sets this when it finishes so every helper stops too
+   std::shared_ptr<std::atomic<bool>> stopSignal;
+   int threadCount;
+   //0 for the main search, helpers count up from 1
+   int threadId;
+
+   int negamax(int depth, int ply, int alpha, int beta);
+   int quiescence(int ply, int alpha, int beta);
+   void scoreMoves(const MoveList& moves, int* scores, Move pvMove, int ply) const;
+   void storeKiller(Move m, int ply);
+   bool isRepetition() const;
+   void extendFromTable(std::vector<Move>& line, int depth);
+   void checkLimits();
+   void resetSearchState();
+   void iterate(SearchResult& result, std::ostream* info);
+   bool probeRoot(const MoveList& rootMoves, SearchResult& result);
+   bool probeSyzygyRoot(SearchResult& result);
+
+ public:
+   explicit Engine(size_t hashMegabytes = DEFAULT_HASH_MB);
+   explicit Engine(TranspositionTable& sharedTable);
+   TranspositionTable& getTranspositionTable();
+   void setPosition(const Position& pos);
+   //Position plus the undo records of the moves that led to it, which count for repetitions.
+   //chessBoard::getUndoHistory gives exactly that for a game in progress.
+   void setPosition(const Position& pos, const std::vector<UndoState>& played);
+   const Position& getPosition() const;
+
+   //Evaluates with the network from now on, nullptr goes back to the piece-square score.
+   //The network has to stay loaded while the engine uses it.
+   void setNetwork(const Network* net);
+
+   //Plays straight from the tables once few enough pieces are left, nullptr turns them off.
+   //The tables have to stay loaded while the engine uses them.
+   void setTablebases(const Tablebases* tables);
+
+   //Same for Syzygy tables. Inside the search only positions right after a capture or
+   //pawn move are probed, at the root the DTZ files pick the move as well.
+   void setSyzygy(const SyzygyTablebases* tables);
+
+   //Plays book moves while the position is in the book, nullptr turns it off. The same
+   //seed always gives the same choices between weighted moves.
+   void setBook(const OpeningBook* openingBook, BookSelection selection = BookSelection::WeightedRandom, uint64_t seed = 1);
+
+   //Static evaluation from the side to move, read straight off the position's running score
+   //or the network's accumulator
+   int evaluate() const;
+
+   //With more than one thread the extra threads search the same root and share the table
+   void setThreads(int threads);
+   int getThreads() const;
+
+   //Searches until a limit is hit, each finished iteration is reported to info when given.
+   //The node and time limits apply to the main thread, helpers stop when it does.
+   SearchResult search(const SearchLimits& searchLimits, std::ostream* info = nullptr);
+};
+
+#endif /* ENGINE_HPP */
@@ -0,0 +1,27 @@
+#ifndef EVALUATION_HPP
+#define EVALUATION_HPP
+
+#include "../piecesHeader/pieceCode.hpp"
+
+//Material plus piece-square values for every piece code and square, one table for the
+//middlegame and one for the endgame. White entries are positive and black negative, so a
+//position's score is just the sum over its pieces and Position keeps that sum up to date.
+extern int midgameTable[12][64];
+extern int endgameTable[12][64];
+
+//How much each piece type counts towards the game phase, the start position adds up to MAX_PHASE
+constexpr int phaseWeight[6] = {0, 1, 1, 2, 4, 0};
+constexpr int MAX_PHASE = 24;
+
+//Fills the tables, runs before main
+void initEvaluation();
+
+//Blends the two scores by how much material is left, all middlegame at MAX_PHASE and all endgame at 0
+inline int taperedScore(int midgame, int endgame, int phase){
+    if (phase > MAX_PHASE){
+        phase = MAX_PHASE;
+    }
+    return (midgame * phase + endgame * (MAX_PHASE - phase)) / MAX_PHASE;
+}
+
+#endif /* EVALUATION_HPP */
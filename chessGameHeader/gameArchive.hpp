@@ -0,0 +1,135 @@
+#ifndef GAMEARCHIVE_HPP
+#define GAMEARCHIVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pgn.hpp"
+
+//Moves are coded as their rank in the legal move list once it is sorted by a cheap
+//guess of how likely each move is, so the moves people play get short codes
+const int ARCHIVE_SYMBOLS = 256;
+//Longest code, small enough for the decoder to look every code up in one table
+const int ARCHIVE_MAX_CODE_BITS = 12;
+
+//The legal moves of pos ordered the way the archive ranks them: captures of bigger
+//pieces with smaller ones first, then promotions, then quiet moves by how much the
+//piece-square tables say they gain. Ties keep the generator's order.
+void rankMoves(const Position& pos, MoveList& moves);
+
+//Canonical Huffman code over move ranks. Only the code lengths are stored, both sides
+//rebuild the same codes from them.
+class MoveCode {
+ private:
+   uint8_t lengths[ARCHIVE_SYMBOLS];
+   uint16_t codes[ARCHIVE_SYMBOLS];
+   //Indexed by the next ARCHIVE_MAX_CODE_BITS bits, the symbol and its length
+   std::vector<uint16_t> decodeTable;
+
+   void buildCodes();
+
+ public:
+   //A code that fits the ranks of ordinary games reasonably, for writers that cannot
+   //look at their games first
+   MoveCode();
+   //The best code for these rank counts. Every rank still gets a code, so any game
+   //can be written with it.
+   static MoveCode fromCounts(const uint64_t counts[ARCHIVE_SYMBOLS]);
+   //False if the lengths do not make a complete prefix code
+   bool setLengths(const uint8_t newLengths[ARCHIVE_SYMBOLS]);
+   const uint8_t* getLengths() const { return lengths; }
+
+   int length(int symbol) const { return lengths[symbol]; }
+   uint16_t code(int symbol) const { return codes[symbol]; }
+   //Symbol starting the bits, which hold the next ARCHIVE_MAX_CODE_BITS bits padded with zeros
+   int decode(unsigned bits, int& codeLength) const {
+       uint16_t entry = decodeTable[bits];
+       codeLength = entry >> 8;
+       return entry & 0xFF;
+   }
+};
+
+//One game as the archive keeps it. The FEN tag, when there is one, gives the start.
+struct ArchiveGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    GameResult result = GameResult::Unknown;
+    std::vector<Move> moves;
+
+    std::string tag(const std::string& name) const;
+};
+
+//Archive file layout, little endian:
+//  header: "CGGA", uint32 version, a code length per rank (256 bytes)
+//  games back to back, each: uint32 move bytes, uint16 plies, uint8 result, uint8 tag count,
+//        per tag uint8 name length, name, uint16 value length, value, then the coded moves
+//  footer: uint64 offset of each game, uint64 game count, "CGGX"
+const int ARCHIVE_HEADER_BYTES = 8 + ARCHIVE_SYMBOLS;
+const int ARCHIVE_TRAILER_BYTES = 12;
+
+//Appends games to a new archive one at a time, only the offsets stay in memory
+class GameArchiveWriter {
+ private:
+   FILE* file;
+   MoveCode moveCode;
+   std::vector<uint64_t> offsets;
+   uint64_t position;
+   std::vector<uint8_t> record;
+   bool failed;
+
+ public:
+   GameArchiveWriter();
+   ~GameArchiveWriter();
+   GameArchiveWriter(const GameArchiveWriter&) = delete;
+   GameArchiveWriter& operator=(const GameArchiveWriter&) = delete;
+
+   bool open(const char* path, const MoveCode& code = MoveCode());
+   //False if a move is not legal where it is played, or a tag is too long to store
+   bool add(const ArchiveGame& game);
+   //Writes the index, without it the archive cannot be read
+   bool close();
+   size_t size() const;
+};
+
+//A whole archive mapped read only. Any game can be decoded by its number without
+//touching the others.
+class GameArchive {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+   const unsigned char* index;
+   uint64_t gameCount;
+   MoveCode moveCode;
+
+   bool recordAt(uint64_t n, const unsigned char*& record, size_t& recordBytes) const;
+
+ public:
+   GameArchive();
+   ~GameArchive();
+   GameArchive(const GameArchive&) = delete;
+   GameArchive& operator=(const GameArchive&) = delete;
+
+   //False if the file cannot be mapped or its header or index do not check out
+   bool load(const char* path);
+   void unload();
+   size_t size() const;
+   size_t fileBytes() const;
+   //Tags and result only, the moves are left coded
+   bool readHeader(uint64_t n, ArchiveGame& game) const;
+   bool readGame(uint64_t n, ArchiveGame& game) const;
+};
+
+//Replays a PGN game into an archive game, false if a move cannot be played
+bool archiveFromPgn(const PgnGameView& pgn, ArchiveGame& game);
+
+//Converts a PGN file. With twoPasses the games are replayed once to count the move
+//ranks so the code fits them, otherwise the default code is used. Games with an illegal
+//move are left out and counted in skipped.
+bool convertPgnToArchive(const char* pgnPath, const char* archivePath, bool twoPasses,
+                         uint64_t& written, uint64_t& skipped, std::ostream* log = nullptr);
+
+#endif /* GAMEARCHIVE_HPP */
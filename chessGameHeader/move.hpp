@@ -0,0 +1,81 @@
+#ifndef MOVE_HPP
+#define MOVE_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "../piecesHeader/pieceType.hpp"
+
+//What kind of move it is, stored in the top 4 bits of a Move.
+//Bit 2 marks captures and bit 3 marks promotions, the low 2 bits of a
+//promotion give the piece (knight, bishop, rook, queen).
+enum MoveFlag {
+    QUIET = 0,
+    DOUBLE_PAWN_PUSH = 1,
+    KING_CASTLE = 2,
+    QUEEN_CASTLE = 3,
+    CAPTURE = 4,
+    EN_PASSANT = 5,
+    PROMOTION = 8,
+    PROMOTION_CAPTURE = 12
+};
+
+//A move packed into 16 bits: 6 bits source square, 6 bits target square, 4 bits flag.
+//Squares use the bitboard index (a1 = 0, h8 = 63).
+class Move {
+ private:
+   uint16_t data;
+
+ public:
+   Move() : data(0) {}
+   Move(int from, int to, int flag = QUIET) : data(static_cast<uint16_t>(from | (to << 6) | (flag << 12))) {}
+
+   int getFrom() const { return data & 63; }
+   int getTo() const { return (data >> 6) & 63; }
+   int getFlag() const { return data >> 12; }
+   bool isCapture() const { return (getFlag() & CAPTURE) != 0; }
+   bool isPromotion() const { return (getFlag() & PROMOTION) != 0; }
+   bool isEnPassant() const { return getFlag() == EN_PASSANT; }
+   bool isCastle() const { return getFlag() == KING_CASTLE || getFlag() == QUEEN_CASTLE; }
+   PieceType getPromotion() const { return static_cast<PieceType>(static_cast<int>(PieceType::Knight) + (getFlag() & 3)); }
+   uint16_t getRaw() const { return data; }
+   bool isNull() const { return data == 0; }
+
+   bool operator==(const Move& other) const { return data == other.data; }
+   bool operator!=(const Move& other) const { return data != other.data; }
+};
+
+//Coordinate notation such as "e2e4" or "e7e8q", built only when something needs to show it
+std::string moveToString(Move m);
+std::string squareToString(int sq);
+
+//Fixed capacity move list meant to live on the stack, no position has more than 218 legal moves
+class MoveList {
+ private:
+   Move moves[256];
+   int count;
+
+ public:
+   MoveList() : count(0) {}
+   void add(Move m) { moves[count++] = m; }
+   void clear() { count = 0; }
+   int size() const { return count; }
+   Move& operator[](int i) { return moves[i]; }
+   const Move& operator[](int i) const { return moves[i]; }
+   Move* begin() { return moves; }
+   Move* end() { return moves + count; }
+   const Move* begin() const { return moves; }
+   const Move* end() const { return moves + count; }
+   bool contains(Move m) const;
+};
+
+inline bool MoveList::contains(Move m) const {
+    for (int i = 0; i < count; ++i){
+        if (moves[i] == m){
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif /* MOVE_HPP */
@@ -0,0 +1,87 @@
+#ifndef NNUE_HPP
+#define NNUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../piecesHeader/pieceCode.hpp"
+
+//Efficiently updatable network. Input features are (piece, square) pairs seen from each
+//side, 768 per side. The first layer is kept as a running sum per side (the accumulator)
+//that a move only adds to and subtracts from. On top of it sit two small int8 layers and
+//a single output.
+const int NNUE_FEATURES = 768;
+const int NNUE_HIDDEN = 128;
+const int NNUE_L1 = 32;
+const int NNUE_L2 = 32;
+
+//Activations are clipped to [0, QA] and layer sums are shifted down by WEIGHT_SHIFT
+//before the next clip. The output divided by OUTPUT_SCALE is in centipawns.
+const int NNUE_QA = 127;
+const int NNUE_WEIGHT_SHIFT = 6;
+const int NNUE_OUTPUT_SCALE = 16;
+
+//First layer sums for both points of view, indexed by color
+struct alignas(32) Accumulator {
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+//Which instruction set the kernels use, picked once at startup from what the CPU has
+enum class SimdLevel {Scalar, SSE41, AVX2};
+
+SimdLevel detectSimdLevel();
+//Switches every kernel to the given level, lets tests compare the levels on one machine
+void selectSimdLevel(SimdLevel level);
+SimdLevel getSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+//Network weights mapped read only from a file. The file is a 64 byte header followed
+//by the arrays below in order, little endian, with no padding between them:
+//  header:   "CGNN", uint32 version, uint32 hidden size, zero filled to 64 bytes
+//  int16 featureWeights[768][128], int16 featureBias[128]
+//  int8  l1Weights[32][256],       int32 l1Bias[32]
+//  int8  l2Weights[32][32],        int32 l2Bias[32]
+//  int8  outputWeights[32],        int32 outputBias
+class Network {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+
+   const int16_t* featureWeights;
+   const int16_t* featureBias;
+   const int8_t* l1Weights;
+   const int32_t* l1Bias;
+   const int8_t* l2Weights;
+   const int32_t* l2Bias;
+   const int8_t* outputWeights;
+   const int32_t* outputBias;
+
+   void unload();
+
+ public:
+   Network();
+   ~Network();
+   Network(const Network&) = delete;
+   Network& operator=(const Network&) = delete;
+
+   //Maps the file, false if it cannot be opened or is not a network of this shape
+   bool load(const char* path);
+   bool isLoaded() const;
+
+   //Starts both sides of the accumulator from the bias, pieces are added after
+   void resetAccumulator(Accumulator& acc) const;
+   void addPiece(Accumulator& acc, PieceCode code, int sq) const;
+   void removePiece(Accumulator& acc, PieceCode code, int sq) const;
+   void movePiece(Accumulator& acc, PieceCode code, int from, int to) const;
+
+   //Score in centipawns from the side to move
+   int evaluate(const Accumulator& acc, Color sideToMove) const;
+
+   //Size in bytes of a network file
+   static size_t fileSize();
+};
+
+//Writes a network file with random weights, for tests and for checking a build end to end
+bool writeRandomNetwork(const char* path, uint64_t seed);
+
+#endif /* NNUE_HPP */
@@ -0,0 +1,67 @@
+#ifndef OPENINGBOOK_HPP
+#define OPENINGBOOK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "position.hpp"
+
+//Polyglot hashing: the key is the xor of the Random64 entries for every piece
+//(64 * kind + square, kind = 2 * type + 1 for white), each castling right (768 + n),
+//the en passant file when a pawn can take (772 + file) and white to move (780).
+uint64_t polyglotKey(const Position& pos);
+
+//Move in book format: to file, to rank, from file, from rank, 3 bits each, then the
+//promotion piece (1 knight .. 4 queen). Castling is the king taking its own rook.
+uint16_t toPolyglotMove(Move m);
+//The legal move the book move stands for, a null Move when there is none
+Move fromPolyglotMove(uint16_t bookMove, const Position& pos);
+
+//One 16 byte book record, stored big endian and sorted by key
+struct BookEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+    uint32_t learn;
+};
+
+struct BookMove {
+    Move move;
+    int weight;
+};
+
+enum class BookSelection {Best, WeightedRandom};
+
+//Polyglot .bin book mapped read only. Lookups binary search the mapped records and
+//write into the caller's array, nothing is allocated after load.
+class OpeningBook {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+   size_t entryCount;
+
+   BookEntry entryAt(size_t i) const;
+
+ public:
+   OpeningBook();
+   ~OpeningBook();
+   OpeningBook(const OpeningBook&) = delete;
+   OpeningBook& operator=(const OpeningBook&) = delete;
+
+   //False if the file cannot be mapped or is not a whole number of records
+   bool load(const char* path);
+   bool isLoaded() const;
+   size_t size() const;
+
+   //Legal book moves for the position, up to max of them, returns how many
+   int findMoves(const Position& pos, BookMove* out, int max) const;
+   //Heaviest move, or one drawn in proportion to the weights from randomState, which
+   //is advanced so the same seed always plays the same line. Null Move when out of book.
+   Move pickMove(const Position& pos, BookSelection selection, uint64_t& randomState) const;
+};
+
+//Sorts the entries by key and writes them as a book file
+bool writeBook(const char* path, std::vector<BookEntry> entries);
+
+#endif /* OPENINGBOOK_HPP */
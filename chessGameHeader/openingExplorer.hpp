@@ -0,0 +1,75 @@
+#ifndef OPENINGEXPLORER_HPP
+#define OPENINGEXPLORER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "positionIndex.hpp"
+
+struct OpeningExplorerOptions {
+    //Moves played after this many plies are not counted
+    int maxPlies = 30;
+    //Moves played fewer times than this are left out, and positions left without moves
+    int minGames = 1;
+};
+
+//What the stored games did after one move from one position
+struct ExplorerMove {
+    Move move;
+    uint32_t games;
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;
+    //Points per game in percent for the side that made the move, over the games with a result
+    double score;
+    //Average rating of the players who chose the move, 0 when none of them had a rating
+    int averageRating;
+};
+
+//Explorer file layout, little endian:
+//  header: "CGOE", uint32 version, uint64 node count
+//  nodes: per position uint64 Zobrist key, uint32 first move, uint32 move count,
+//        stored in Eytzinger order: the children of node k are 2k + 1 and 2k + 2
+//  moves: per move uint16 move, uint16 average rating, uint32 games, white wins, draws,
+//        black wins, each node's moves together and most played first, to the end of the file
+const int EXPLORER_HEADER_BYTES = 16;
+const int EXPLORER_NODE_BYTES = 16;
+const int EXPLORER_MOVE_BYTES = 20;
+
+//Counts the moves of the first options.maxPlies plies of every game and writes the
+//explorer file. False if it cannot be written.
+bool buildOpeningExplorer(const GameArchive& archive, const char* path,
+                          const OpeningExplorerOptions& options, std::ostream* log = nullptr);
+
+//Explorer file mapped read only. The nodes are laid out so a lookup walks down a
+//binary search tree stored breadth first, the first levels share a few cache lines
+//and the next levels are prefetched while the current one is compared.
+class OpeningExplorer {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+   const unsigned char* nodes;
+   const unsigned char* moves;
+   uint64_t nodeCount;
+   uint64_t moveCount;
+
+ public:
+   OpeningExplorer();
+   ~OpeningExplorer();
+   OpeningExplorer(const OpeningExplorer&) = delete;
+   OpeningExplorer& operator=(const OpeningExplorer&) = delete;
+
+   //False if the file cannot be mapped or its sizes do not match its header
+   bool load(const char* path);
+   void unload();
+   bool isLoaded() const;
+   //Positions with at least one move
+   size_t size() const;
+
+   //Legal moves played from the position, most played first, up to max of them.
+   //Returns how many were written.
+   int findMoves(const Position& pos, ExplorerMove* out, int max) const;
+};
+
+#endif /* OPENINGEXPLORER_HPP */
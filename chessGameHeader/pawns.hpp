@@ -0,0 +1,39 @@
+#ifndef PAWNS_HPP
+#define PAWNS_HPP
+
+#include <vector>
+
+#include "position.hpp"
+
+//Pawn structure terms for one pawn setup, White minus Black
+struct PawnEntry {
+    uint64_t key;
+    int midgame;
+    int endgame;
+    Bitboard passedPawns[2];
+};
+
+//Works the structure terms out from scratch: passed, isolated, doubled and backward pawns
+void evaluatePawns(const Position& position, PawnEntry& entry);
+
+//Cache of pawn structure results keyed by the pawn-only Zobrist key. Pawns move
+//rarely in a search, so nearly every probe is a hit. Each search thread keeps its
+//own table, so there is nothing to lock.
+class PawnTable {
+ private:
+   std::vector<PawnEntry> entries;
+   uint64_t hits;
+   uint64_t probes;
+
+ public:
+   //Entry count is rounded down to a power of two
+   explicit PawnTable(size_t entryCount = 16384);
+   void clear();
+
+   //Cached entry for the position's pawns, filled in first if it was not there
+   const PawnEntry& probe(const Position& position);
+   uint64_t getHits() const;
+   uint64_t getProbes() const;
+};
+
+#endif /* PAWNS_HPP */
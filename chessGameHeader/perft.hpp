@@ -0,0 +1,28 @@
+#ifndef PERFT_HPP
+#define PERFT_HPP
+
+#include <cstdint>
+#include <ostream>
+
+#include "position.hpp"
+
+//Counts the leaf nodes of the legal move tree to the given depth.
+//The last ply is bulk counted from the size of the move list. Moves are made and
+//taken back on the given position, which is left as it was.
+uint64_t perft(Position& position, int depth);
+
+//Same count, but prints the number of leaves below each root move
+uint64_t perftDivide(Position& position, int depth, std::ostream& out);
+
+//Reference positions with known leaf counts, used by the perft target and the tests
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t nodes;
+};
+
+extern const PerftCase perftSuite[];
+extern const int perftSuiteSize;
+
+#endif /* PERFT_HPP */
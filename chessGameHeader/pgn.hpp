@@ -0,0 +1,127 @@
+#ifndef PGN_HPP
+#define PGN_HPP
+
+#include <cstddef>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "position.hpp"
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+enum class GameResult {WhiteWin, BlackWin, Draw, Unknown};
+
+//One game as it stands in the file, moves still in SAN
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    std::string movetext;
+    GameResult result;
+
+    //Value of a tag, empty when the game does not have it
+    std::string tag(const std::string& name) const;
+};
+
+//Reads games one at a time so a collection never has to fit in memory
+class PgnReader {
+ private:
+   std::istream& in;
+   std::string pendingLine;
+   bool hasPending;
+
+ public:
+   explicit PgnReader(std::istream& input);
+   //False once there are no games left
+   bool next(PgnGame& game);
+};
+
+//One game as views into the text it was scanned from, nothing is copied. Tag values
+//are as written, so an escaped quote still has its backslash.
+struct PgnGameView {
+    std::vector<std::pair<std::string_view, std::string_view>> tags;
+    std::string_view movetext;
+    GameResult result;
+    //Where the game starts in the scanned text
+    size_t offset;
+
+    std::string_view tag(std::string_view name) const;
+};
+
+//Splits PGN text into games in place. A game is its tag lines followed by movetext up
+//to a line ending in the termination marker or the next tag line, lines starting with
+//'%' are skipped. The views stay valid for as long as the text does.
+class PgnScanner {
+ private:
+   const char* textStart;
+   const char* cursor;
+   const char* textEnd;
+
+ public:
+   explicit PgnScanner(std::string_view text);
+   //False once there are no games left. The game's vectors are reused, so scanning
+   //a file with one game object does not allocate after the first few games.
+   bool next(PgnGameView& game);
+
+   //Range over the games, the iterator holds the current game
+   class iterator {
+    private:
+      PgnScanner* scanner;
+      PgnGameView game;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = PgnGameView;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const PgnGameView*;
+      using reference = const PgnGameView&;
+
+      explicit iterator(PgnScanner* source = nullptr);
+      reference operator*() const { return game; }
+      pointer operator->() const { return &game; }
+      iterator& operator++();
+      bool operator==(const iterator& other) const { return scanner == other.scanner; }
+      bool operator!=(const iterator& other) const { return scanner != other.scanner; }
+   };
+   iterator begin() { return iterator(this); }
+   iterator end() { return iterator(); }
+};
+
+//A PGN file mapped read only, for scanning collections larger than memory
+class PgnFile {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+
+ public:
+   PgnFile();
+   ~PgnFile();
+   PgnFile(const PgnFile&) = delete;
+   PgnFile& operator=(const PgnFile&) = delete;
+
+   //False if the file cannot be opened or mapped, an empty file loads as empty text
+   bool load(const char* path);
+   void unload();
+   std::string_view text() const;
+};
+
+//Cuts text into at most count pieces of about the same size, each starting at the first
+//tag line of a game, so every piece can go to its own PgnScanner
+std::vector<std::string_view> splitAtGames(std::string_view text, int count);
+
+//The legal move a SAN token such as "Nbd7", "exd5", "e8=Q+" or "O-O" stands for,
+//a null Move if it is illegal or ambiguous
+Move parseSan(std::string_view san, const Position& pos);
+//SAN for a legal move, with the check or mate suffix
+std::string moveToSan(Move m, const Position& pos);
+
+//Sets pos to the game's start (its FEN tag or the usual start) and plays the movetext,
+//skipping comments, variations, move numbers and annotations. Stops after maxPlies
+//moves when that is not negative. False if a move cannot be played, moves then holds
+//the ones before it.
+bool playMovetext(const PgnGame& game, Position& pos, std::vector<Move>& moves, int maxPlies = -1);
+bool playMovetext(const PgnGameView& game, Position& pos, std::vector<Move>& moves, int maxPlies = -1);
+
+#endif /* PGN_HPP */
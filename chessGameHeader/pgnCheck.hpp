@@ -0,0 +1,61 @@
+#ifndef PGNCHECK_HPP
+#define PGNCHECK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "chessBoard.hpp"
+#include "pgn.hpp"
+
+enum class GameStatus {Ok, BadStart, IllegalMove};
+
+struct GameVerdict {
+    //Games are numbered from 0 in file order
+    uint64_t index;
+    //Where the game starts in the file
+    size_t offset;
+    GameStatus status;
+    //Moves played, for an illegal game the bad move is the one after these
+    int plies;
+};
+
+//Replays games on a chessBoard. The SAN resolver finds each move and the board's own
+//legal move list then has to contain it, so a bug in either shows up as a bad game.
+class GameChecker {
+ private:
+   chessBoard board;
+   Position position;
+   std::vector<Move> moves;
+
+ public:
+   GameVerdict check(const PgnGameView& game, uint64_t index);
+};
+
+struct PgnCheckOptions {
+    int threads = 1;
+    //Games a worker takes at a time
+    int batchSize = 64;
+    //Batches each queue between the stages holds
+    int queueSize = 64;
+};
+
+struct PgnCheckSummary {
+    uint64_t games = 0;
+    uint64_t failed = 0;
+    uint64_t plies = 0;
+};
+
+//Checks every game in text with a three stage pipeline: a reader thread cuts the text
+//into batches of whole games, worker threads check them, and the calling thread hands
+//the verdicts to emit in file order. The stages pass batches through lock free bounded
+//queues, and the reader never gets more than a few queues' worth of batches ahead of
+//the writer, so memory stays flat whatever the file size. Progress goes to progress
+//about once a second when it is given.
+PgnCheckSummary checkPgn(std::string_view text, const PgnCheckOptions& options,
+                         const std::function<void(const GameVerdict&)>& emit, std::ostream* progress = nullptr);
+
+#endif /* PGNCHECK_HPP */
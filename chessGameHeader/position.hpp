@@ -0,0 +1,167 @@
+#ifndef POSITION_HPP
+#define POSITION_HPP
+
+#include <string>
+
+#include "bitboard.hpp"
+#include "move.hpp"
+#include "zobrist.hpp"
+#include "evaluation.hpp"
+#include "nnue.hpp"
+#include "../piecesHeader/pieceCode.hpp"
+
+//Longest FEN writeFEN can produce, terminator included
+const int FEN_MAX_LENGTH = 96;
+
+//Castling right bits
+enum CastlingRight {
+    WHITE_KING_SIDE = 1,
+    WHITE_QUEEN_SIDE = 2,
+    BLACK_KING_SIDE = 4,
+    BLACK_QUEEN_SIDE = 8,
+    ALL_CASTLING = 15
+};
+
+//Which part of the legal moves to generate, captures include en passant and capture promotions
+enum class GenStage {ALL, CAPTURES, QUIETS};
+
+//Everything makeMove changes that cannot be worked out again from the move itself.
+//One of these per ply is enough to take a move back.
+struct UndoState {
+    Move move;
+    PieceType captured;
+    int8_t enPassantSquare;
+    uint8_t castlingRights;
+    uint16_t halfmoveClock;
+    uint64_t hashKey;
+};
+
+inline Color opposite(Color col){
+    return col == Color::White ? Color::Black : Color::White;
+}
+
+//Bitboard state of the board: one set per piece type and color plus the occupancy unions.
+//chessBoard keeps one of these as the real state, the Squares are only a view of it.
+class Position {
+ private:
+   Bitboard pieces[2][6];
+   Bitboard colorOccupancy[2];
+   Bitboard occupancy;
+   //What stands on each square, so piece lookups never scan the bitboards
+   PieceCode mailbox[64];
+   int castlingRights;
+   int enPassantSquare;
+   Color sideToMove;
+   int halfmoveClock;
+   int fullmoveNumber;
+   uint64_t hashKey;
+   //Zobrist key of the pawns alone, for the pawn structure cache
+   uint64_t pawnKey;
+   //Running evaluation terms, White minus Black, updated with the pieces like the key
+   int midgameScore;
+   int endgameScore;
+   int gamePhase;
+   int material[2];
+   //Optional network evaluation, its accumulator follows the pieces when a network is set
+   const Network* network;
+   Accumulator accumulator;
+
+   Bitboard pinnedPieces(Color side, int kingSq) const;
+   bool enPassantIsLegal(Color side, int from, int kingSq) const;
+   //Key of the en passant file, zero unless a pawn stands ready to take on the square
+   uint64_t enPassantKey() const;
+   bool setupIsLegal() const;
+
+ public:
+   Position();
+   void clear();
+   //Reads a FEN string in one pass, the move counters may be left off.
+   //False for a malformed string or a position that cannot arise in a game (kings
+   //missing, pawns on a back rank, the side not to move in check, an en passant square
+   //no double push could have left). The position is then left part way set up.
+   bool loadFEN(const char* fen);
+   //Writes the FEN of the position and a terminating zero to out, which needs
+   //FEN_MAX_LENGTH bytes. Returns the length without the terminator.
+   int writeFEN(char* out) const;
+   std::string toFEN() const;
+   void addPiece(Color col, PieceType type, int sq);
+   void removePiece(Color col, PieceType type, int sq);
+   void movePiece(Color col, PieceType type, int from, int to);
+   void clearSquare(int sq);
+   void addPiece(PieceCode code, int sq);
+
+   int getCastlingRights() const;
+   void setCastlingRights(int rights);
+   void updateCastlingRights(int from, int to);
+   int getEnPassantSquare() const;
+   void setEnPassantSquare(int sq);
+   Color getSideToMove() const;
+   void setSideToMove(Color side);
+
+   //Zobrist key, kept up to date by every change instead of being recomputed
+   uint64_t getHashKey() const;
+   uint64_t computeHashKey() const;
+   uint64_t getPawnKey() const {
+       return pawnKey;
+   }
+   uint64_t computePawnKey() const;
+   //Key after m without playing it, the en passant and castling parts are left out.
+   //Good enough to prefetch the child's table entry, not to identify the child.
+   uint64_t keyAfter(Move m) const;
+   //Tapered material and piece-square score from White's side, no scan of the board needed
+   int getEvaluation() const {
+       return taperedScore(midgameScore, endgameScore, gamePhase);
+   }
+   //Same score summed over every piece, only for checking the running one
+   int computeEvaluation() const;
+   int getGamePhase() const;
+   //Plain material count (pawn 100, knight 320, ...), White minus Black
+   int getMaterialBalance() const;
+   int getMaterial(Color col) const;
+
+   //Sets the network whose accumulator the position keeps, nullptr turns it off.
+   //The accumulator is rebuilt from the pieces on the board.
+   void setNetwork(const Network* net);
+   const Network* getNetwork() const;
+   const Accumulator& getAccumulator() const;
+   int getHalfmoveClock() const;
+   int getFullmoveNumber() const;
+   //Neither side can ever mate: bare kings, one knight or bishop in all, or only bishops
+   //that all stand on squares of the same color
+   bool hasInsufficientMaterial() const;
+
+   //Plays a move for the piece on its source square and records what is needed to take it back
+   void makeMove(Move m, UndoState& undo);
+   //Takes back the move recorded in undo, which must be the last one made
+   void unmakeMove(const UndoState& undo);
+
+   //Every piece of either color that attacks sq with the given occupancy
+   Bitboard attackersTo(int sq, Bitboard occupied) const;
+   bool isSquareAttacked(int sq, Color by) const;
+   bool isInCheck(Color side) const;
+   void generateLegalMoves(Color side, MoveList& moves, GenStage stage = GenStage::ALL) const;
+
+   Bitboard getPieces(Color col, PieceType type) const {
+       return pieces[static_cast<int>(col)][static_cast<int>(type)];
+   }
+   Bitboard getPieces(Color col) const {
+       return colorOccupancy[static_cast<int>(col)];
+   }
+   Bitboard getOccupancy() const {
+       return occupancy;
+   }
+   bool isOccupied(int sq) const {
+       return (occupancy & squareBit(sq)) != 0;
+   }
+   PieceCode pieceCodeAt(int sq) const {
+       return mailbox[sq];
+   }
+   PieceType pieceTypeAt(int sq) const {
+       return pieceTypeOf(mailbox[sq]);
+   }
+   Color colorAt(int sq) const {
+       return pieceColorOf(mailbox[sq]);
+   }
+};
+
+#endif /* POSITION_HPP */
@@ -0,0 +1,74 @@
+#ifndef POSITIONINDEX_HPP
+#define POSITIONINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "gameArchive.hpp"
+
+//A game reaching the position, after ply moves from its start
+struct PositionHit {
+    uint32_t game;
+    uint16_t ply;
+};
+
+struct PositionIndexOptions {
+    //Positions after this many plies are left out, 0 keeps them all
+    int maxPlies = 0;
+    //Positions sorted in memory at a time, each full run is written out and the runs
+    //are merged at the end, so this bounds the memory whatever the archive size
+    size_t runEntries = size_t(1) << 24;
+};
+
+//Index file layout, little endian:
+//  header: "CGPI", uint32 version
+//  a posting list per key in key order: varint count, then per hit varint game minus the
+//        previous hit's game and varint ply, hits sorted by game and ply
+//  directory: per key uint64 key, uint64 offset of its posting list
+//  footer: uint64 directory offset, uint64 key count, uint64 hit count, "CGPX"
+const int POSITION_INDEX_HEADER_BYTES = 8;
+const int POSITION_INDEX_TRAILER_BYTES = 28;
+
+//Replays every game of the archive and writes the index. The run files go next to
+//indexPath and are removed once merged. False if a file cannot be written.
+bool buildPositionIndex(const GameArchive& archive, const char* indexPath,
+                        const PositionIndexOptions& options, std::ostream* log = nullptr);
+
+//Index mapped read only. A lookup is a binary search of the directory and a walk over
+//one posting list, only the pages those touch are read.
+class PositionIndex {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+   const unsigned char* directory;
+   uint64_t keyCount;
+   uint64_t hitCount;
+
+   const unsigned char* postings(uint64_t key) const;
+
+ public:
+   PositionIndex();
+   ~PositionIndex();
+   PositionIndex(const PositionIndex&) = delete;
+   PositionIndex& operator=(const PositionIndex&) = delete;
+
+   //False if the file cannot be mapped or its header or footer do not check out
+   bool load(const char* path);
+   void unload();
+   bool isLoaded() const;
+   //Distinct positions
+   size_t size() const;
+   uint64_t hits() const;
+
+   //Times the position was reached over all games
+   uint64_t count(uint64_t key) const;
+   //Fills hits with the first max of them in game order and returns how many there are
+   uint64_t find(uint64_t key, std::vector<PositionHit>& hits, size_t max = SIZE_MAX) const;
+   uint64_t find(const Position& pos, std::vector<PositionHit>& hits, size_t max = SIZE_MAX) const {
+       return find(pos.getHashKey(), hits, max);
+   }
+};
+
+#endif /* POSITIONINDEX_HPP */
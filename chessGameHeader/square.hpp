@@ -1,21 +1,29 @@
 #ifndef SQUARE_HPP
 #define SQUARE_HPP
 
-#include "../piecesHeader/piece.hpp"
+#include "../piecesHeader/pieceCode.hpp"
 
 #include <memory>
 
 class Piece;
+class chessBoard;
 
+//A view of one square. Squares that belong to a board read and write the board's
+//Position directly, a square made on its own keeps its piece code itself.
 class Square {
  private:
-   std::unique_ptr<Piece>pieceType;
+   chessBoard* owner;
    int row;
    int col;
+   PieceCode code;
+
+   PieceCode currentCode() const;
+   void storeCode(PieceCode newCode);
    
  public:
    Square();
    Square(int r, int c);
+   Square(int r, int c, chessBoard* board);
    Piece& getPiece();
    bool isEmpty();
    void setPiece(std::unique_ptr<Piece> p);
@@ -23,6 +31,7 @@ class Square {
    int getRow();
    int getCol();
    std::unique_ptr<Piece> releasePiece();
+   PieceCode getPieceCode() const;
 };
 
-#endif /* SQUARE_HPP */
\ No newline at end of file
+#endif /* SQUARE_HPP */
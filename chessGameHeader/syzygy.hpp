@@ -0,0 +1,55 @@
+#ifndef SYZYGY_HPP
+#define SYZYGY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "position.hpp"
+
+//Result for the side to move. Cursed wins and blessed losses are won or lost on the
+//board but drawn under the fifty move rule.
+enum class WDLScore {Loss = -2, BlessedLoss = -1, Draw = 0, CursedWin = 1, Win = 2};
+
+struct SyzygyTable;
+
+//Syzygy tables: .rtbw files (win, draw or loss) and .rtbz files next to them (plies to
+//the next capture or pawn move). Registering a directory only reads the file names, a
+//file is mapped the first time a probe needs it. Probing reads the mapped files and a
+//per thread cache of decoded blocks, so any number of search threads can share one set.
+class SyzygyTablebases {
+ private:
+   std::vector<std::unique_ptr<SyzygyTable>> tables;
+   //Each table under the material of both colorings, see materialKey in syzygy.cpp
+   std::map<uint64_t, SyzygyTable*> byMaterial;
+   int maxPieces;
+
+ public:
+   SyzygyTablebases();
+   ~SyzygyTablebases();
+   SyzygyTablebases(const SyzygyTablebases&) = delete;
+   SyzygyTablebases& operator=(const SyzygyTablebases&) = delete;
+
+   //Registers every .rtbw file in the directories, given separated by ':'. Returns how
+   //many tables were added.
+   int load(const std::string& paths);
+   size_t size() const;
+   //Most pieces in any registered table, kings included, 0 with none
+   int getMaxPieces() const;
+
+   //False when a table needed is missing or castling is still possible. Captures are
+   //played out on pos, which is left as it was.
+   bool probeWDL(Position& pos, WDLScore& result) const;
+   //Plies to the next capture or pawn move with best play: positive when the side to
+   //move wins, negative when it loses, 0 for a draw. Off by one ply at most, like the
+   //files themselves. Cursed wins and blessed losses count 100 plies more.
+   bool probeDTZ(Position& pos, int& dtz) const;
+   //Move that wins in the fewest plies to the next capture or pawn move, draws, or
+   //loses in the most. Needs the DTZ file of the root's material as well.
+   bool probeRoot(Position& pos, Move& best, WDLScore& result) const;
+};
+
+#endif /* SYZYGY_HPP */
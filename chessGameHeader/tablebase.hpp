@@ -0,0 +1,100 @@
+#ifndef TABLEBASE_HPP
+#define TABLEBASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "position.hpp"
+
+//Kings included, every table covers at most this many pieces
+const int TB_MAX_PIECES = 5;
+
+//Result for the side to move
+enum class TBOutcome {Loss, Draw, Win};
+
+struct TBResult {
+    TBOutcome outcome;
+    //Plies to mate with best play from both sides, 0 for a draw or a side already mated
+    int plies;
+};
+
+//Name of the material on the board with the stronger side first, like "KQvK" or
+//"KRPvKR". Empty when it has more than TB_MAX_PIECES pieces.
+std::string tablebaseName(const Position& pos);
+
+//Turns a name in either order ("KvKQ" as well as "KQvK") into the one tables are
+//stored under, empty if it is not a valid material set
+std::string canonicalTablebaseName(const std::string& name);
+
+//One table file mapped read only. The file is a 32 byte header followed by one byte
+//per index, little endian:
+//  header: "CGTB", uint32 version, uint32 longest mate in plies, uint32 piece count,
+//          name zero filled to 16 bytes
+//The index is the side to move (stronger side first), then the king pair, then the
+//square of each other piece, stronger side's pieces first in the order Q R B N P.
+//Boards are turned so the stronger king stands on files a-d, and without pawns in the
+//a1-d1-d4 triangle, which leaves 462 king pairs, 1806 with pawns. Pawns take one of
+//48 squares, other pieces one of 64. Positions with the weaker side to play the
+//stronger side's role are looked up with the board mirrored and the colors swapped.
+class TablebaseFile {
+ private:
+   void* mapping;
+   size_t mappedBytes;
+   const uint8_t* values;
+   std::string name;
+   int pieceCount;
+   int longestMate;
+
+   void unload();
+
+ public:
+   TablebaseFile();
+   ~TablebaseFile();
+   TablebaseFile(const TablebaseFile&) = delete;
+   TablebaseFile& operator=(const TablebaseFile&) = delete;
+
+   //Maps the file, false if it cannot be opened or is not a table
+   bool load(const std::string& path);
+   const std::string& getName() const;
+   int getPieceCount() const;
+   int getLongestMate() const;
+   uint8_t valueAt(uint64_t index) const {
+       return values[index];
+   }
+};
+
+//Every table found in a directory. Probing only reads the mapped files, so any number
+//of search threads can share one set.
+class Tablebases {
+ private:
+   std::map<std::string, std::unique_ptr<TablebaseFile>> tables;
+   int maxPieces;
+
+ public:
+   Tablebases();
+
+   //Maps every .cgtb file in the directory, returns how many were added
+   int load(const std::string& directory);
+   bool contains(const std::string& name) const;
+   size_t size() const;
+   //Most pieces in any loaded table, 0 with none loaded
+   int getMaxPieces() const;
+
+   //False when there is no table for the material or the position has castling or
+   //en passant rights, which the tables leave out
+   bool probe(const Position& pos, TBResult& result) const;
+   //Same for a material name and board given as bitboards, used by the generator
+   bool probe(const Bitboard pieces[2][6], Color sideToMove, TBResult& result) const;
+};
+
+//Writes the named table to directory/<name>.cgtb by retrograde analysis, first making
+//every smaller table it reaches through a capture or a promotion that is not there yet.
+//Each pass over the index space is split between threads. Besides the table itself it
+//needs one bit per position.
+bool generateTablebase(const std::string& name, const std::string& directory, int threads, std::ostream* log = nullptr);
+
+#endif /* TABLEBASE_HPP */
@@ -0,0 +1,84 @@
+#ifndef TRANSPOSITIONTABLE_HPP
+#define TRANSPOSITIONTABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "move.hpp"
+
+//Size used when nothing else is asked for
+const size_t DEFAULT_HASH_MB = 16;
+
+//How a stored score relates to the real one
+enum TTBound : uint8_t {
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1,
+    BOUND_LOWER = 2,
+    BOUND_EXACT = 3
+};
+
+//Unpacked copy of an entry, what probe hands back
+struct TTData {
+    Move move;
+    int score;
+    int depth;
+    TTBound bound;
+};
+
+//One entry is two 64 bit words: the packed data and the key xored with that data.
+//Threads read and write the words without locks, a torn entry whose halves come
+//from different writes fails the xor check and is treated as a miss.
+struct TTEntry {
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+};
+
+//Four entries fill one 64 byte cache line, a probe touches a single line
+const int TT_BUCKET_SIZE = 4;
+
+struct alignas(64) TTBucket {
+    TTEntry entries[TT_BUCKET_SIZE];
+};
+
+//Hash table of search results shared by every search thread. Entries are kept by
+//depth, and entries from older searches are the first to be replaced.
+class TranspositionTable {
+ private:
+   TTBucket* buckets;
+   size_t bucketCount;
+   size_t allocatedBytes;
+   uint8_t generation;
+
+   TTBucket& bucketFor(uint64_t key) const {
+       //Multiply-high maps the key onto the bucket count without needing a power of two
+       return buckets[static_cast<size_t>((static_cast<unsigned __int128>(key) * bucketCount) >> 64)];
+   }
+
+ public:
+   explicit TranspositionTable(size_t megabytes = DEFAULT_HASH_MB);
+   ~TranspositionTable();
+   TranspositionTable(const TranspositionTable&) = delete;
+   TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+   //Frees the old table and allocates a new empty one, not safe while a search runs
+   void resize(size_t megabytes);
+   void clear();
+   //Called once per search so entries from earlier searches age out
+   void newSearch();
+
+   bool probe(uint64_t key, TTData& out) const;
+   void store(uint64_t key, Move move, int score, int depth, TTBound bound);
+
+   //Starts pulling the bucket for key into cache so the probe after it does not stall
+   void prefetch(uint64_t key) const {
+       __builtin_prefetch(&bucketFor(key));
+   }
+
+   //Used entries from the current search per thousand, from a sample at the start of the table
+   int hashfull() const;
+   size_t getSizeInBytes() const;
+   size_t getEntryCount() const;
+};
+
+#endif /* TRANSPOSITIONTABLE_HPP */
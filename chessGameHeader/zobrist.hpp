@@ -0,0 +1,16 @@
+#ifndef ZOBRIST_HPP
+#define ZOBRIST_HPP
+
+#include <cstdint>
+
+//Random keys for Zobrist hashing. A position's key is the xor of the keys of
+//everything on it, so a move only has to xor out what left and xor in what arrived.
+extern uint64_t zobristPieces[2][6][64];
+extern uint64_t zobristCastling[16];
+extern uint64_t zobristEnPassant[8];
+extern uint64_t zobristBlackToMove;
+
+//Fills the keys from a fixed seed, runs before main so keys are the same on every run
+void initZobrist();
+
+#endif /* ZOBRIST_HPP */
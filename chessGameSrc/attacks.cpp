@@ -0,0 +1,179 @@
+#include "../chessGameHeader/attacks.hpp"
+
+Magic rookMagics[64];
+Magic bishopMagics[64];
+Bitboard knightAttackTable[64];
+Bitboard kingAttackTable[64];
+Bitboard pawnAttackTable[2][64];
+Bitboard betweenTable[64][64];
+Bitboard lineTable[64][64];
+bool sliderUsesPext = false;
+
+//Sized for the fixed shift scheme: sum over squares of 2^(relevant bits)
+static Bitboard rookTable[0x19000];
+static Bitboard bishopTable[0x1480];
+
+static const int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+static const int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+#if defined(ATTACKS_RUNTIME_PEXT)
+__attribute__((target("bmi2")))
+unsigned pextIndex(Bitboard occupancy, Bitboard mask){
+    return static_cast<unsigned>(_pext_u64(occupancy, mask));
+}
+#endif
+
+static bool cpuHasBmi2(){
+#if defined(__BMI2__)
+    return true;
+#elif defined(__GNUC__) && defined(ATTACKS_RUNTIME_PEXT)
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+//Walks each ray from sq until it leaves the board or hits a blocker (the blocker is included)
+static Bitboard slidingAttacks(const int directions[4][2], int sq, Bitboard occupancy){
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; ++d){
+        int rank = sq >> 3;
+        int file = sq & 7;
+        while (true){
+            rank += directions[d][0];
+            file += directions[d][1];
+            if (rank < 0 || rank > 7 || file < 0 || file > 7){
+                break;
+            }
+            Bitboard bit = squareBit(rank * 8 + file);
+            attacks |= bit;
+            if (occupancy & bit){
+                break;
+            }
+        }
+    }
+    return attacks;
+}
+
+//xorshift64star, seeded per rank so the magic search is the same on every run
+static uint64_t nextRandom(uint64_t& state){
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+static void initSliders(Magic magics[64], Bitboard* table, const int directions[4][2]){
+    static const uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+    Bitboard occupancies[4096];
+    Bitboard reference[4096];
+    int epoch[4096] = {0};
+    int attempt = 0;
+    Bitboard* next = table;
+
+    for (int sq = 0; sq < 64; ++sq){
+        //Board edges are never blockers unless the piece sits on that edge
+        Bitboard rankEdges = (0xFFULL | 0xFF00000000000000ULL) & ~(0xFFULL << ((sq >> 3) * 8));
+        Bitboard fileEdges = (0x0101010101010101ULL | 0x8080808080808080ULL) & ~(0x0101010101010101ULL << (sq & 7));
+
+        Magic& m = magics[sq];
+        m.mask = slidingAttacks(directions, sq, 0) & ~(rankEdges | fileEdges);
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = next;
+
+        //Carry-rippler enumeration of every subset of the mask
+        int size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            reference[size] = slidingAttacks(directions, sq, subset);
+#if defined(ATTACKS_RUNTIME_PEXT)
+            if (sliderUsesPext){
+                m.attacks[pextIndex(subset, m.mask)] = reference[size];
+            }
+#endif
+            ++size;
+            subset = (subset - m.mask) & m.mask;
+        } while (subset);
+        next += size;
+
+        if (sliderUsesPext){
+            continue;
+        }
+
+        //Search for a multiplier that maps every subset without destructive collisions
+        uint64_t state = seeds[sq >> 3];
+        for (int i = 0; i < size; ){
+            m.magic = 0;
+            while (popCount((m.magic * m.mask) >> 56) < 6){
+                m.magic = nextRandom(state) & nextRandom(state) & nextRandom(state);
+            }
+            ++attempt;
+            for (i = 0; i < size; ++i){
+                unsigned idx = static_cast<unsigned>(((occupancies[i] & m.mask) * m.magic) >> m.shift);
+                if (epoch[idx] < attempt){
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                }
+                else if (m.attacks[idx] != reference[i]){
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static Bitboard stepAttacks(int sq, const int steps[][2], int count){
+    Bitboard attacks = 0;
+    for (int i = 0; i < count; ++i){
+        int rank = (sq >> 3) + steps[i][0];
+        int file = (sq & 7) + steps[i][1];
+        if (rank >= 0 && rank <= 7 && file >= 0 && file <= 7){
+            attacks |= squareBit(rank * 8 + file);
+        }
+    }
+    return attacks;
+}
+
+void initAttacks(bool allowPext){
+    static const int knightSteps[8][2] = {{2, 1}, {2, -1}, {-2, 1}, {-2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}};
+    static const int kingSteps[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    static const int whitePawnSteps[2][2] = {{1, 1}, {1, -1}};
+    static const int blackPawnSteps[2][2] = {{-1, 1}, {-1, -1}};
+
+    for (int sq = 0; sq < 64; ++sq){
+        knightAttackTable[sq] = stepAttacks(sq, knightSteps, 8);
+        kingAttackTable[sq] = stepAttacks(sq, kingSteps, 8);
+        pawnAttackTable[static_cast<int>(Color::White)][sq] = stepAttacks(sq, whitePawnSteps, 2);
+        pawnAttackTable[static_cast<int>(Color::Black)][sq] = stepAttacks(sq, blackPawnSteps, 2);
+    }
+
+#if defined(__BMI2__)
+    //magicIndex always uses PEXT in this build so the tables must match it
+    allowPext = true;
+#endif
+    sliderUsesPext = allowPext && cpuHasBmi2();
+    initSliders(rookMagics, rookTable, rookDirections);
+    initSliders(bishopMagics, bishopTable, bishopDirections);
+
+    for (int a = 0; a < 64; ++a){
+        for (int b = 0; b < 64; ++b){
+            betweenTable[a][b] = 0;
+            lineTable[a][b] = 0;
+            if (a == b){
+                continue;
+            }
+            if (rookAttacks(a, 0) & squareBit(b)){
+                lineTable[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | squareBit(a) | squareBit(b);
+                betweenTable[a][b] = rookAttacks(a, squareBit(b)) & rookAttacks(b, squareBit(a));
+            }
+            else if (bishopAttacks(a, 0) & squareBit(b)){
+                lineTable[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | squareBit(a) | squareBit(b);
+                betweenTable[a][b] = bishopAttacks(a, squareBit(b)) & bishopAttacks(b, squareBit(a));
+            }
+        }
+    }
+}
+
+//Tables are filled during static initialisation so callers never see them empty
+static const bool attacksReady = (initAttacks(), true);
@@ -0,0 +1,194 @@
+#include "../chessGameHeader/bookBuilder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <thread>
+
+BookStatistics::BookStatistics(int plies, int shardCount) : maxPlies(plies), games(0), rejected(0) {
+    for (int i = 0; i < (shardCount > 0 ? shardCount : 1); ++i){
+        shards.emplace_back(new Shard());
+    }
+}
+
+void BookStatistics::addGames(const std::vector<PgnGame>& batch){
+    struct Sample {
+        StatsKey key;
+        int score;
+    };
+    //Gathered first and sorted by shard, so each shard is locked once per batch
+    std::vector<Sample> samples;
+    std::vector<Move> moves;
+    Position position;
+    for (const PgnGame& game : batch){
+        if (game.result == GameResult::Unknown){
+            ++rejected;
+            continue;
+        }
+        //A game with a move that cannot be played is left out whole, its record is suspect
+        if (!playMovetext(game, position, moves, maxPlies)){
+            ++rejected;
+            continue;
+        }
+        ++games;
+        //Replay from the start to get the key before each move
+        std::string fen = game.tag("FEN");
+        position.loadFEN(fen.empty() ? START_FEN : fen.c_str());
+        for (Move m : moves){
+            int whiteScore = game.result == GameResult::WhiteWin ? 1 : (game.result == GameResult::BlackWin ? -1 : 0);
+            int score = position.getSideToMove() == Color::White ? whiteScore : -whiteScore;
+            samples.push_back({{polyglotKey(position), toPolyglotMove(m)}, score});
+            UndoState undo;
+            position.makeMove(m, undo);
+        }
+    }
+    std::sort(samples.begin(), samples.end(), [this](const Sample& a, const Sample& b){
+        return shardOf(a.key.key) < shardOf(b.key.key);
+    });
+
+    size_t i = 0;
+    while (i < samples.size()){
+        Shard& shard = *shards[shardOf(samples[i].key.key)];
+        std::lock_guard<std::mutex> guard(shard.lock);
+        size_t shardIndex = shardOf(samples[i].key.key);
+        for (; i < samples.size() && shardOf(samples[i].key.key) == shardIndex; ++i){
+            MoveStats& stats = shard.moves.emplace(samples[i].key, MoveStats{0, 0, 0}).first->second;
+            if (samples[i].score > 0){
+                ++stats.wins;
+            }
+            else if (samples[i].score < 0){
+                ++stats.losses;
+            }
+            else {
+                ++stats.draws;
+            }
+        }
+    }
+}
+
+uint64_t BookStatistics::getGames() const {
+    return games;
+}
+
+uint64_t BookStatistics::getRejected() const {
+    return rejected;
+}
+
+MoveStats BookStatistics::lookup(uint64_t key, uint16_t move) const {
+    Shard& shard = *shards[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto found = shard.moves.find(StatsKey{key, move});
+    return found == shard.moves.end() ? MoveStats{0, 0, 0} : found->second;
+}
+
+std::vector<BookEntry> BookStatistics::toEntries(int minGames) const {
+    std::vector<BookEntry> entries;
+    uint64_t heaviest = 0;
+    std::vector<uint64_t> weights;
+    for (const auto& shard : shards){
+        std::lock_guard<std::mutex> guard(shard->lock);
+        for (const auto& item : shard->moves){
+            const MoveStats& stats = item.second;
+            uint64_t played = static_cast<uint64_t>(stats.wins) + stats.draws + stats.losses;
+            uint64_t weight = 2 * static_cast<uint64_t>(stats.wins) + stats.draws;
+            if (played < static_cast<uint64_t>(minGames) || weight == 0){
+                continue;
+            }
+            entries.push_back({item.first.key, item.first.move, 0, 0});
+            weights.push_back(weight);
+            heaviest = std::max(heaviest, weight);
+        }
+    }
+    for (size_t i = 0; i < entries.size(); ++i){
+        uint64_t weight = heaviest > 0xFFFF ? weights[i] * 0xFFFF / heaviest : weights[i];
+        entries[i].weight = static_cast<uint16_t>(weight ? weight : 1);
+    }
+    return entries;
+}
+
+bool buildBook(const std::vector<std::string>& pgnFiles, const std::string& bookPath, const BookBuildOptions& options, std::ostream* log){
+    auto start = std::chrono::steady_clock::now();
+    BookStatistics statistics(options.maxPlies);
+    int threads = options.threads > 0 ? options.threads : 1;
+    size_t batchSize = options.batchSize > 0 ? options.batchSize : 1;
+
+    //Bounded hand off from the reader to the workers, the reader waits when it is full
+    std::mutex queueLock;
+    std::condition_variable queueChanged;
+    std::deque<std::vector<PgnGame>> queue;
+    size_t capacity = 2 * threads;
+    bool finished = false;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t){
+        workers.emplace_back([&](){
+            for (;;){
+                std::vector<PgnGame> batch;
+                {
+                    std::unique_lock<std::mutex> guard(queueLock);
+                    queueChanged.wait(guard, [&](){ return !queue.empty() || finished; });
+                    if (queue.empty()){
+                        return;
+                    }
+                    batch.swap(queue.front());
+                    queue.pop_front();
+                }
+                queueChanged.notify_all();
+                statistics.addGames(batch);
+            }
+        });
+    }
+
+    int filesRead = 0;
+    auto push = [&](std::vector<PgnGame>& batch){
+        std::unique_lock<std::mutex> guard(queueLock);
+        queueChanged.wait(guard, [&](){ return queue.size() < capacity; });
+        queue.emplace_back();
+        queue.back().swap(batch);
+        guard.unlock();
+        queueChanged.notify_all();
+    };
+    for (const std::string& path : pgnFiles){
+        std::ifstream file(path);
+        if (!file){
+            if (log){
+                *log << "Could not open " << path << std::endl;
+            }
+            continue;
+        }
+        ++filesRead;
+        PgnReader reader(file);
+        std::vector<PgnGame> batch(batchSize);
+        size_t filled = 0;
+        while (reader.next(batch[filled])){
+            if (++filled == batchSize){
+                push(batch);
+                batch.resize(batchSize);
+                filled = 0;
+            }
+        }
+        if (filled){
+            batch.resize(filled);
+            push(batch);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> guard(queueLock);
+        finished = true;
+    }
+    queueChanged.notify_all();
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+
+    std::vector<BookEntry> entries = statistics.toEntries(options.minGames);
+    bool written = filesRead > 0 && writeBook(bookPath.c_str(), entries);
+    if (log){
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        *log << statistics.getGames() << " games (" << statistics.getRejected() << " rejected), "
+             << entries.size() << " book moves, " << seconds << " s" << std::endl;
+    }
+    return written;
+}
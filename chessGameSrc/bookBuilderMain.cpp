@@ -0,0 +1,45 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include "../chessGameHeader/bookBuilder.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./bookBuilder [-plies N] [-min N] [-threads N] <book.bin> <games.pgn> [more.pgn ...]
+//Counts every move of the first N plies (20 by default) of each game with a result and
+//writes a Polyglot book weighted 2 * wins + draws. Files are streamed, never loaded whole.
+
+int main(int argc, char* argv[]){
+    BookBuildOptions options;
+    int cores = static_cast<int>(thread::hardware_concurrency());
+    options.threads = cores > 0 ? cores : 1;
+    vector<string> files;
+    for (int i = 1; i < argc; ++i){
+        if (i + 1 < argc && strcmp(argv[i], "-plies") == 0){
+            options.maxPlies = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-min") == 0){
+            options.minGames = atoi(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "-threads") == 0){
+            options.threads = atoi(argv[++i]);
+        }
+        else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() < 2){
+        cout << "Usage: ./bookBuilder [-plies N] [-min N] [-threads N] <book.bin> <games.pgn> [more.pgn ...]" << endl;
+        return 1;
+    }
+    string book = files[0];
+    files.erase(files.begin());
+    if (!buildBook(files, book, options, &cout)){
+        cout << "Could not build " << book << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -10,9 +10,24 @@
 using namespace std;
 
 chessBoard::chessBoard() {
+   bindSquares();
+}
+
+//Copying only copies the position, the squares of the copy look at the copy
+chessBoard::chessBoard(const chessBoard& other) : position(other.position), undoStack(other.undoStack) {
+   bindSquares();
+}
+
+chessBoard& chessBoard::operator=(const chessBoard& other) {
+   position = other.position;
+   undoStack = other.undoStack;
+   return *this;
+}
+
+void chessBoard::bindSquares(){
    for (int i = 0; i < 8; ++i){
        for (int j = 0; j < 8; ++j){
-           board[i][j] = make_unique<Square>();
+           board[i][j] = Square(i, j, this);
        }
    }
 }
@@ -23,37 +38,115 @@ chessBoard::chessBoard() {
 // }
 
 Square& chessBoard::getSquare(int row, int col) const {
-     return *(board[row][col]);
+     return board[row][col];
 }
 
-void chessBoard::setupBoard(){
-    //setup black side
-    
-    board[0][0]->setPiece(make_unique<Rook>(Color::Black));
-    board[0][1]->setPiece(make_unique<Knight>(Color::Black));
-    board[0][2]->setPiece(make_unique<Bishop>(Color::Black));
-    board[0][3]->setPiece(make_unique<Queen>(Color::Black));
-    board[0][4]->setPiece(make_unique<King>(Color::Black));
-    board[0][5]->setPiece(make_unique<Bishop>(Color::Black));
-    board[0][6]->setPiece(make_unique<Knight>(Color::Black));
-    board[0][7]->setPiece(make_unique<Rook>(Color::Black));
+const Position& chessBoard::getPosition() const {
+    return position;
+}
 
-    for (int i = 0; i < 8; ++i){
-        board[1][i]->setPiece(make_unique<Pawn>(Color::Black));
+bool chessBoard::isOccupied(int row, int col) const {
+    return position.isOccupied(squareIndex(row, col));
+}
+
+PieceCode chessBoard::getPieceCode(int row, int col) const {
+    return position.pieceCodeAt(squareIndex(row, col));
+}
+
+//Square views write through here
+void chessBoard::setPieceCode(int row, int col, PieceCode code){
+    int sq = squareIndex(row, col);
+    position.clearSquare(sq);
+    if (code != NO_PIECE){
+        position.addPiece(code, sq);
     }
+}
+
+void chessBoard::generateLegalMoves(Color side, MoveList& moves, GenStage stage) const {
+    position.generateLegalMoves(side, moves, stage);
+}
+
+bool chessBoard::isLegalMove(int sourceX, int sourceY, int targetX, int targetY) const {
+    return !findLegalMove(sourceX, sourceY, targetX, targetY).isNull();
+}
+
+//The legal move between the two squares with its flags filled in, or a null Move if there is none.
+//Promotions come out of the generator queen first so that is the one returned.
+Move chessBoard::findLegalMove(int sourceX, int sourceY, int targetX, int targetY) const {
+    int from = squareIndex(sourceX, sourceY);
+    int to = squareIndex(targetX, targetY);
+    Color side = position.colorAt(from);
+    if (side == Color::none){
+        return Move();
+    }
+
+    MoveList moves;
+    position.generateLegalMoves(side, moves);
+    for (const Move& m : moves){
+        if (m.getFrom() == from && m.getTo() == to){
+            return m;
+        }
+    }
+    return Move();
+}
+
+bool chessBoard::isInCheck(Color side) const {
+    return position.isInCheck(side);
+}
+
+//Castling rights and the en passant square depend on the move that was just played
+void chessBoard::updateMoveState(int sourceX, int sourceY, int targetX, int targetY){
+    int from = squareIndex(sourceX, sourceY);
+    int to = squareIndex(targetX, targetY);
+    if (position.pieceTypeAt(from) == PieceType::Pawn && abs(targetX - sourceX) == 2){
+        position.setEnPassantSquare((from + to) / 2);
+    }
+    else {
+        position.setEnPassantSquare(-1);
+    }
+    position.updateCastlingRights(from, to);
+    if (position.colorAt(from) != Color::none){
+        position.setSideToMove(opposite(position.colorAt(from)));
+    }
+}
 
-    //setup white side
-    board[7][0]->setPiece(make_unique<Rook>(Color::White));
-    board[7][1]->setPiece(make_unique<Knight>(Color::White));
-    board[7][2]->setPiece(make_unique<Bishop>(Color::White));
-    board[7][3]->setPiece(make_unique<Queen>(Color::White));
-    board[7][4]->setPiece(make_unique<King>(Color::White));
-    board[7][5]->setPiece(make_unique<Bishop>(Color::White));
-    board[7][6]->setPiece(make_unique<Knight>(Color::White));
-    board[7][7]->setPiece(make_unique<Rook>(Color::White));
+//Built once, every setupBoard after that is a plain copy of it
+static Position makeStartPosition(){
+    static const PieceType backRank[8] = {PieceType::Rook, PieceType::Knight, PieceType::Bishop, PieceType::Queen,
+                                          PieceType::King, PieceType::Bishop, PieceType::Knight, PieceType::Rook};
+    Position start;
     for (int j = 0; j < 8; ++j){
-        board[6][j]->setPiece(make_unique<Pawn>(Color::White));
+        //setup black side
+        start.addPiece(Color::Black, backRank[j], squareIndex(0, j));
+        start.addPiece(Color::Black, PieceType::Pawn, squareIndex(1, j));
+        //setup white side
+        start.addPiece(Color::White, backRank[j], squareIndex(7, j));
+        start.addPiece(Color::White, PieceType::Pawn, squareIndex(6, j));
     }
+    start.setCastlingRights(ALL_CASTLING);
+    start.setEnPassantSquare(-1);
+    start.setSideToMove(Color::White);
+    return start;
+}
+
+void chessBoard::setupBoard(){
+    static const Position startPosition = makeStartPosition();
+    position = startPosition;
+    undoStack.clear();
+}
+
+bool chessBoard::loadFEN(const char* fen){
+    Position loaded;
+    if (!loaded.loadFEN(fen)){
+        return false;
+    }
+    position = loaded;
+    undoStack.clear();
+    return true;
+}
+
+std::string chessBoard::toFEN() const {
+    return position.toFEN();
 }
 
 
@@ -62,64 +155,17 @@ void chessBoard::displayBoard(){
     cout << endl;
     cout << "   a b c d e f g h" << endl;
     cout << endl;
-    Square* currSquare;
-    Piece* currPiece;
     for (int i = 0; i < 8; ++i){
         cout << 8 - i << "  ";
-       for (int j = 0; j < 8; ++j){
-           currSquare = &this->getSquare(i, j);
-           Piece* currPiece;
-            if(currSquare->isEmpty() == true){
-                currPiece = nullptr;
-            }
-            else {
-                currPiece = &currSquare->getPiece();
-            }
-
-           if (currPiece == nullptr){
-                cout << ". ";
-               
-           }
-           else{
-                if (currPiece->getSymbol() == "K") {
-                cout << "\u2654 "; // WHITE CHESS KING
-            } else if (currPiece->getSymbol() == "Q") {
-                cout << "\u2655 "; // WHITE CHESS QUEEN
-            } else if (currPiece->getSymbol() == "R") {
-                cout << "\u2656 "; // WHITE CHESS ROOK
-            } else if (currPiece->getSymbol() == "B") {
-                cout << "\u2657 "; // WHITE CHESS BISHOP
-            } else if (currPiece->getSymbol() == "N") {
-                cout << "\u2658 "; // WHITE CHESS KNIGHT
-            } else if (currPiece->getSymbol() == "P") {
-                cout << "\u2659 "; // WHITE CHESS PAWN
-            } else if (currPiece->getSymbol() == "k") {
-                cout << "\u265A "; // BLACK CHESS KING
-            } else if (currPiece->getSymbol() == "q") {
-                cout << "\u265B "; // BLACK CHESS QUEEN
-            } else if (currPiece->getSymbol() == "r") {
-                cout << "\u265C "; // BLACK CHESS ROOK
-            } else if (currPiece->getSymbol() == "b") {
-                cout << "\u265D "; // BLACK CHESS BISHOP
-            } else if (currPiece->getSymbol() == "n") {
-                cout << "\u265E "; // BLACK CHESS KNIGHT
-            } else if (currPiece->getSymbol() == "p") {
-                cout << "\u265F "; // BLACK CHESS PAWN
-            }
-           }
-       }
-       cout << " " << 8 - i;
-       cout << endl;
-   }
-   cout << endl;
-   cout << "   a b c d e f g h" << endl;
-   cout << endl;
-//    if(currSquare != nullptr){
-//         delete currSquare;
-//    }
-//    if(currPiece != nullptr){
-//         delete currPiece;
-//    }
+        for (int j = 0; j < 8; ++j){
+            cout << pieceGlyphTable[getPieceCode(i, j)] << " ";
+        }
+        cout << " " << 8 - i;
+        cout << endl;
+    }
+    cout << endl;
+    cout << "   a b c d e f g h" << endl;
+    cout << endl;
 }
 
 void chessBoard::displayBoardFromBlackSide() {
@@ -127,42 +173,10 @@ void chessBoard::displayBoardFromBlackSide() {
     cout << endl;
     cout << "   h g f e d c b a" << endl;  // Flipped column labels
     cout << endl;
-    Square* currSquare;
-    Piece* currPiece;
     for (int i = 7; i >= 0; --i) {  // Start from 7 (row 8) and go down to 0 (row 1)
         cout << 8 - i << "  ";  // Print the reversed row number (8 to 1)
         for (int j = 7; j >= 0; --j) {  // Start from 7 (column h) and go to 0 (column a)
-            currSquare = &this->getSquare(i, j);
-            if (currSquare->isEmpty()) {
-                cout << ". ";
-            } else {
-                currPiece = &currSquare->getPiece();
-                if (currPiece->getSymbol() == "K") {
-                cout << "\u2654 "; // WHITE CHESS KING
-            } else if (currPiece->getSymbol() == "Q") {
-                cout << "\u2655 "; // WHITE CHESS QUEEN
-            } else if (currPiece->getSymbol() == "R") {
-                cout << "\u2656 "; // WHITE CHESS ROOK
-            } else if (currPiece->getSymbol() == "B") {
-                cout << "\u2657 "; // WHITE CHESS BISHOP
-            } else if (currPiece->getSymbol() == "N") {
-                cout << "\u2658 "; // WHITE CHESS KNIGHT
-            } else if (currPiece->getSymbol() == "P") {
-                cout << "\u2659 "; // WHITE CHESS PAWN
-            } else if (currPiece->getSymbol() == "k") {
-                cout << "\u265A "; // BLACK CHESS KING
-            } else if (currPiece->getSymbol() == "q") {
-                cout << "\u265B "; // BLACK CHESS QUEEN
-            } else if (currPiece->getSymbol() == "r") {
-                cout << "\u265C "; // BLACK CHESS ROOK
-            } else if (currPiece->getSymbol() == "b") {
-                cout << "\u265D "; // BLACK CHESS BISHOP
-            } else if (currPiece->getSymbol() == "n") {
-                cout << "\u265E "; // BLACK CHESS KNIGHT
-            } else if (currPiece->getSymbol() == "p") {
-                cout << "\u265F "; // BLACK CHESS PAWN
-            }
-            }
+            cout << pieceGlyphTable[getPieceCode(i, j)] << " ";
         }
         cout << " " << 8 - i << endl;  // Print the reversed row number again (8 to 1)
     }
@@ -171,46 +185,71 @@ void chessBoard::displayBoardFromBlackSide() {
     cout << endl;
 }
 
-void chessBoard::movePiece(int sourceX, int sourceY, int targetX, int targetY){
-    unique_ptr<Piece> toMovePiece = this->getSquare(sourceX, sourceY).releasePiece();
-    this->getSquare(targetX, targetY).setPiece(move(toMovePiece));
-  
+void chessBoard::makeMove(Move m){
+    undoStack.emplace_back();
+    position.makeMove(m, undoStack.back());
 }
 
-void chessBoard::capture(int sourceX, int sourceY, int targetX, int targetY){
-    unique_ptr<Piece> toMovePiece = this->getSquare(sourceX, sourceY).releasePiece();
-    this->getSquare(targetX, targetY).setPiece(move(toMovePiece));
+bool chessBoard::unmakeMove(){
+    if (undoStack.empty()){
+        return false;
+    }
+    UndoState undo = undoStack.back();
+    undoStack.pop_back();
+    position.unmakeMove(undo);
+    return true;
 }
 
+int chessBoard::getPlyCount() const {
+    return static_cast<int>(undoStack.size());
+}
 
-bool chessBoard::EnPassantPossible(int sourceX, int sourceY, int targetX, int targetY){
-    //To implement
-    return false;
+const std::vector<UndoState>& chessBoard::getUndoHistory() const {
+    return undoStack;
 }
 
-void chessBoard::perfomEnPassant(int sourceX, int sourceY, int targetX, int targetY) {
-    //To implement
+uint64_t chessBoard::getHashKey() const {
+    return position.getHashKey();
 }
 
-bool chessBoard::pawnPromotionPossible(int sourceX, int sourceY, int targetX, int targetY){
-    //To implement
-    return false;
+//The undo records keep the key from before each move, so record i is the position after i plies.
+//A FEN load clears the records, then the clock can reach back further than they do.
+int chessBoard::repetitionCount() const {
+    int current = static_cast<int>(undoStack.size());
+    int oldest = current - position.getHalfmoveClock();
+    int count = 1;
+    for (int i = current - 2; i >= 0 && i >= oldest; i -= 2){
+        if (undoStack[i].hashKey == position.getHashKey()){
+            ++count;
+        }
+    }
+    return count;
 }
 
-void chessBoard::performPawnPromotion(int sourceX, int sourceY, int targetX, int targetY){
-    //To implement
+void chessBoard::movePiece(int sourceX, int sourceY, int targetX, int targetY){
+    updateMoveState(sourceX, sourceY, targetX, targetY);
+    PieceCode moving = getPieceCode(sourceX, sourceY);
+    setPieceCode(sourceX, sourceY, NO_PIECE);
+    setPieceCode(targetX, targetY, moving);
 }
 
-bool chessBoard::willRemoveCheck(int sourceX, int sourceY, int targetX, int targetY, int kingX, int kingY) const{
-    //To implement
-    return true;
+void chessBoard::capture(int sourceX, int sourceY, int targetX, int targetY){
+    //Writing the piece over the target removes whatever was captured there
+    movePiece(sourceX, sourceY, targetX, targetY);
 }
-bool chessBoard::willKingGetChecked(int sourceX, int sourceY, int targetX, int targetY, int kingX, int kingY) const{
-    //To implement
-    return false;
+
+
+bool chessBoard::willRemoveCheck(int sourceX, int sourceY, int targetX, int targetY) const{
+    //Every generated move already gets the king out of check
+    return isLegalMove(sourceX, sourceY, targetX, targetY);
 }
-bool chessBoard::isKingChecked(int sourceX, int sourceY, int targetX, int targetY, int kingX, int kingY) const {
-    //To implement
-    return false;
+bool chessBoard::willKingGetChecked(int sourceX, int sourceY, int targetX, int targetY) const{
+    return !isLegalMove(sourceX, sourceY, targetX, targetY);
 }
-
+bool chessBoard::isKingChecked(int kingX, int kingY) const {
+    int kingSq = squareIndex(kingX, kingY);
+    if (position.pieceTypeAt(kingSq) != PieceType::King){
+        return false;
+    }
+    return position.isSquareAttacked(kingSq, opposite(position.colorAt(kingSq)));
+}
\ No newline at end of file
@@ -7,7 +7,7 @@
     #include <stdio.h>
 
 
-    chessGame::chessGame(): board(std::make_unique < chessBoard > ()) {
+    chessGame::chessGame(): board(std::make_unique < chessBoard > ()), lastMove(false), gameStatusNow(gameStatus::IN_PROGRESS), drawReasonNow(drawReason::NONE) {
 
       whiteKingPosition.first = 7;
       whiteKingPosition.second = 4;
@@ -92,20 +92,26 @@
 
        
 
-      bool validMove = sourcePiece->canMoveTo(sourceX,sourceY, targetX, targetY, *board);
-
-      if(!validMove){
+      //Packed form of the move for the history, taken before the board changes. Anything
+      //the generator does not list is illegal, a pinned piece moving off its line included.
+      //It also lists en passant, which the piece's own canMoveTo does not know about.
+      Move playedMove = buildMove(sourceX, sourceY, targetX, targetY);
+      if (playedMove.isNull()) {
         cout << "Your piece " << sourcePiece->getSymbol() << " cannot move there. ";
         lastMove = false;
         return;
       }
+      //En passant takes a pawn from a square the target check above never saw
+      if (playedMove.isEnPassant()) {
+        capturePiece = true;
+      }
 
       //Check if king is currently on check 
       //If it is does it remove the check
 
       if(white){
-        if(board.get()->isKingChecked(sourceX,sourceY, targetX, targetY, whiteKingPosition.first, whiteKingPosition.second)){
-          if(!board.get()->willRemoveCheck(sourceX,sourceY, targetX, targetY, whiteKingPosition.first, whiteKingPosition.second)){
+        if(board.get()->isKingChecked(whiteKingPosition.first, whiteKingPosition.second)){
+          if(!board.get()->willRemoveCheck(sourceX,sourceY, targetX, targetY)){
             cout << "Your piece " << sourcePiece->getSymbol() << " cannot move there because your king is in Check. ";
             lastMove = false; 
             return;
@@ -113,8 +119,8 @@
         }
       }
       else {
-        if(board.get()->isKingChecked(sourceX,sourceY, targetX, targetY, blackKingPosition.first, blackKingPosition.second)){
-          if(!board.get()->willRemoveCheck(sourceX,sourceY, targetX, targetY, blackKingPosition.first, blackKingPosition.second)){
+        if(board.get()->isKingChecked(blackKingPosition.first, blackKingPosition.second)){
+          if(!board.get()->willRemoveCheck(sourceX,sourceY, targetX, targetY)){
             cout << "Your piece " << sourcePiece->getSymbol() << " cannot move there because your king is in Check. ";
             lastMove = false; 
               return;
@@ -129,19 +135,19 @@
       if(white){
         if(whiteKingPosition.first == sourceX && whiteKingPosition.second == sourceY){
           //King cannot move to a place where other players attack directly afterwards
-          if(board.get()->willKingGetChecked(sourceX,sourceY, targetX, targetY, whiteKingPosition.first, whiteKingPosition.second)){
+          if(board.get()->willKingGetChecked(sourceX,sourceY, targetX, targetY)){
             cout << "Your piece " << sourcePiece->getSymbol() << " cannot move there because your king will get in Check. ";
             lastMove = false; 
             return; 
           }
           //Save the move
-          addMoves(targetX, targetY);
+          addMoves(playedMove);
           lastMove = true; 
 
           //If capture then invoke capture logic 
           if(capturePiece){
               player1Captured.push_back(getStringOfMove(targetX, targetY));
-              board.get()->capture(sourceX, sourceY,  targetX,  targetY);
+              applyMove(playedMove);
 
               // printCapturedPieces(white);
               updateKingPosition(Color::White, targetX, targetY);
@@ -149,7 +155,7 @@
               return;
           }
           //Move the piece and return 
-            board.get()->movePiece(sourceX, sourceY,  targetX,  targetY);
+            applyMove(playedMove);
             // printCapturedPieces(white);
             printMoveHistory();
             this->board.get()->displayBoardFromBlackSide();
@@ -161,19 +167,19 @@
         else{
             if(blackKingPosition.first == sourceX && blackKingPosition.second == sourceY){
           //King cannot move to a place where other players attack directly afterwards
-          if(board.get()->willKingGetChecked(sourceX,sourceY, targetX, targetY, blackKingPosition.first, blackKingPosition.second)){
+          if(board.get()->willKingGetChecked(sourceX,sourceY, targetX, targetY)){
             cout << "Your piece " << sourcePiece->getSymbol() << " cannot move there because your king will get in Check. ";
             lastMove = false; 
             return; 
           }
           //Save the move
-          addMoves(targetX, targetY);
+          addMoves(playedMove);
           lastMove = true; 
 
           //If capture then invoke capture logic 
           if(capturePiece){
               player2Captured.push_back(getStringOfMove(targetX, targetY));
-              board.get()->capture(sourceX, sourceY,  targetX,  targetY);
+              applyMove(playedMove);
 
               // printCapturedPieces(white);
               printMoveHistory();
@@ -182,7 +188,7 @@
               return;
           }
           //Move the piece and return 
-            board.get()->movePiece(sourceX, sourceY,  targetX,  targetY);
+            applyMove(playedMove);
             // printCapturedPieces(white);
             printMoveHistory();
             updateKingPosition(Color::Black, targetX, targetY);
@@ -192,47 +198,6 @@
         }
       
 
-      if (sourcePiece -> getSymbol() == "P" || sourcePiece -> getSymbol() == "p") {
-        if (board.get() -> EnPassantPossible(sourceX, sourceY, targetX, targetY)) {
-          board.get() -> perfomEnPassant(sourceX, sourceY, targetX, targetY);
-          addMoves(targetX, targetY);
-          if(white){
-            player1Captured.push_back(getStringOfMove(targetX, targetY));
-          }
-          else{
-            player2Captured.push_back(getStringOfMove(targetX, targetY));
-          }
-          lastMove = true;
-          addMoves(targetX, targetY);
-          printMoveHistory();
-
-          if(white){
-            this->board.get()->displayBoardFromBlackSide();
-            
-            }
-          else {
-            this->board.get()->displayBoard();
-          }
-          return;
-        }
-
-        if (board.get() -> pawnPromotionPossible(sourceX, sourceY, targetX, targetY)) {
-          board.get() -> performPawnPromotion(sourceX, sourceY, targetX, targetY);
-          lastMove = true;
-          addMoves(targetX, targetY);
-          printMoveHistory();
-
-          if(white){
-            this->board.get()->displayBoardFromBlackSide();
-            
-            }
-          else {
-            this->board.get()->displayBoard();
-          }
-          return;
-        }
-      }
-
       if(capturePiece){
         // board.get()->capture(sourceX, sourceY, targetX, targetY;
         if(white){
@@ -242,8 +207,8 @@
           player2Captured.push_back(getStringOfMove(targetX, targetY));
         }
         lastMove = true;
-        addMoves(targetX, targetY);
-        board.get()->capture(sourceX, sourceY,  targetX,  targetY);
+        addMoves(playedMove);
+        applyMove(playedMove);
         printMoveHistory();
         if(white){
           this->board.get()->displayBoardFromBlackSide();
@@ -258,8 +223,8 @@
 
 
       lastMove = true;
-      addMoves(targetX, targetY);
-      board.get()->movePiece(sourceX, sourceY,  targetX,  targetY);
+      addMoves(playedMove);
+      applyMove(playedMove);
       printMoveHistory();
       // printCapturedPieces(white);
         if(white){
@@ -280,6 +245,53 @@
       return gameStatusNow;
     }
 
+    drawReason chessGame::getDrawReason() const {
+      return drawReasonNow;
+    }
+
+    //Works the status out again from the board after every move, taken back ones included.
+    //Mate and stalemate come first, so a mate on the hundredth quiet ply still wins.
+    void chessGame::updateStatusAfterMove() {
+      const Position& position = board.get()->getPosition();
+      drawReasonNow = drawReason::NONE;
+      MoveList legal;
+      position.generateLegalMoves(position.getSideToMove(), legal);
+      if (legal.size() == 0) {
+        updateGameStatus(position.isInCheck(position.getSideToMove()) ? gameStatus::CHECKMATE : gameStatus::STALEMATE);
+        return;
+      }
+      if (board.get()->repetitionCount() >= 3) {
+        drawReasonNow = drawReason::REPETITION;
+      }
+      else if (position.getHalfmoveClock() >= 100) {
+        drawReasonNow = drawReason::FIFTY_MOVES;
+      }
+      else if (position.hasInsufficientMaterial()) {
+        drawReasonNow = drawReason::INSUFFICIENT_MATERIAL;
+      }
+      updateGameStatus(drawReasonNow == drawReason::NONE ? gameStatus::IN_PROGRESS : gameStatus::DRAW);
+    }
+
+    void chessGame::printGameResult() const {
+      Color toMove = board.get()->getPosition().getSideToMove();
+      switch (gameStatusNow) {
+        case gameStatus::CHECKMATE:
+          cout << "Checkmate! " << (toMove == Color::White ? "Black" : "White") << " wins." << endl;
+          break;
+        case gameStatus::STALEMATE:
+          cout << "Stalemate, the game is a draw." << endl;
+          break;
+        case gameStatus::DRAW:
+          cout << (drawReasonNow == drawReason::REPETITION ? "Draw by threefold repetition."
+                   : drawReasonNow == drawReason::FIFTY_MOVES ? "Draw by the 50-move rule."
+                   : drawReasonNow == drawReason::INSUFFICIENT_MATERIAL ? "Draw, neither side has enough material to mate."
+                   : "Draw.") << endl;
+          break;
+        default:
+          break;
+      }
+    }
+
     string chessGame::getStringOfMove(int targetX, int targetY) const {
       // Convert the y-coordinate to a file character ('a' through 'h')
       char charX = 'a' + targetY;
@@ -292,16 +304,29 @@
       return moveString;
     }
 
-    //     void addMoves(int col, int row);
-    void chessGame::addMoves(int row, int col) {
-      string moveName = getStringOfMove(row, col);
-      moves.push_back(moveName);
+    void chessGame::makeMove(Move move, bool white) {
+      makeMove(rowOf(move.getFrom()), colOf(move.getFrom()), rowOf(move.getTo()), colOf(move.getTo()), white);
+    }
+
+    //The generator knows the exact flags (castle, en passant, promotion). A null Move
+    //when it does not list the move.
+    Move chessGame::buildMove(int sourceX, int sourceY, int targetX, int targetY) const {
+      return board.get()->findLegalMove(sourceX, sourceY, targetX, targetY);
+    }
+
+    void chessGame::addMoves(Move move) {
+      moves.push_back(move);
+    }
+
+    const vector<Move>& chessGame::getMoveHistory() const {
+      return moves;
     }
 
     //     void printMoveHistory();
+    //The strings are only built here, the history itself keeps the 16 bit moves
     void chessGame::printMoveHistory() {
-      for (int i = 0; i < moves.size(); ++i) {
-        cout << moves[i];
+      for (size_t i = 0; i < moves.size(); ++i) {
+        cout << getStringOfMove(rowOf(moves[i].getTo()), colOf(moves[i].getTo()));
         // Print a space if it's the first move in a pair, or a newline if it's the second
         if (i % 2 == 0) {
           std::cout << " ";
@@ -317,6 +342,138 @@
 
     }
 
+    //Every move the game accepts goes through here so it can be taken back
+    void chessGame::applyMove(Move move) {
+      board.get()->makeMove(move);
+      redoMoves.clear();
+      updateStatusAfterMove();
+    }
+
+    //Takes back the last move, the player who made it is to move again
+    bool chessGame::undoMove() {
+      if (moves.empty() || board.get()->getPlyCount() == 0) {
+        return false;
+      }
+      Move last = moves.back();
+      Color mover = board.get()->getPosition().colorAt(last.getTo());
+      if (last.isCapture()) {
+        vector<string>& captured = mover == Color::White ? player1Captured : player2Captured;
+        if (!captured.empty()) {
+          captured.pop_back();
+        }
+      }
+      board.get()->unmakeMove();
+      moves.pop_back();
+      redoMoves.push_back(last);
+      syncKingPositions();
+      updateStatusAfterMove();
+
+      if (mover == Color::White) {
+        this->board.get()->displayBoard();
+      }
+      else {
+        this->board.get()->displayBoardFromBlackSide();
+      }
+      return true;
+    }
+
+    //Plays the last undone move again
+    bool chessGame::redoMove() {
+      if (redoMoves.empty()) {
+        return false;
+      }
+      Move next = redoMoves.back();
+      redoMoves.pop_back();
+      Color mover = board.get()->getPosition().colorAt(next.getFrom());
+      if (next.isCapture()) {
+        vector<string>& captured = mover == Color::White ? player1Captured : player2Captured;
+        captured.push_back(getStringOfMove(rowOf(next.getTo()), colOf(next.getTo())));
+      }
+      board.get()->makeMove(next);
+      moves.push_back(next);
+      syncKingPositions();
+      updateStatusAfterMove();
+
+      if (mover == Color::White) {
+        this->board.get()->displayBoardFromBlackSide();
+      }
+      else {
+        this->board.get()->displayBoard();
+      }
+      return true;
+    }
+
+    const chessBoard& chessGame::getBoard() const {
+      return *board;
+    }
+
+    int chessGame::getMaterialBalance() const {
+      return board.get()->getPosition().getMaterialBalance();
+    }
+
+    //Shown in pawns, e.g. "Material: White +3.2"
+    void chessGame::printMaterialBalance() const {
+      int balance = getMaterialBalance();
+      if (balance == 0) {
+        cout << "Material: even" << endl;
+        return;
+      }
+      int ahead = balance > 0 ? balance : -balance;
+      cout << "Material: " << (balance > 0 ? "White" : "Black") << " +" << ahead / 100;
+      if (ahead % 100 >= 10) {
+        cout << "." << (ahead % 100) / 10;
+      }
+      cout << endl;
+    }
+
+    //The engine only ever returns legal moves, so none of the checks in makeMove are needed
+    bool chessGame::playComputerMove(Engine& engine, const SearchLimits& limits, bool white) {
+      engine.setPosition(board.get()->getPosition(), board.get()->getUndoHistory());
+      SearchResult result = engine.search(limits);
+      if (result.bestMove.isNull()) {
+        updateGameStatus(result.score == 0 ? gameStatus::STALEMATE : gameStatus::CHECKMATE);
+        lastMove = false;
+        return false;
+      }
+
+      Move best = result.bestMove;
+      if (best.isCapture()) {
+        vector<string>& captured = white ? player1Captured : player2Captured;
+        captured.push_back(getStringOfMove(rowOf(best.getTo()), colOf(best.getTo())));
+      }
+      cout << "Computer plays " << moveToString(best) << " (depth " << result.depth << ", "
+           << result.nodes << " nodes, " << result.nodesPerSecond << " nps)" << endl;
+
+      addMoves(best);
+      applyMove(best);
+      syncKingPositions();
+      lastMove = true;
+      printMoveHistory();
+      if (white) {
+        this->board.get()->displayBoardFromBlackSide();
+      }
+      else {
+        this->board.get()->displayBoard();
+      }
+      printMaterialBalance();
+      return true;
+    }
+
+    //Reads the kings back off the bitboards after the board was moved without makeMove
+    void chessGame::syncKingPositions() {
+      const Position& position = board.get()->getPosition();
+      Bitboard whiteKing = position.getPieces(Color::White, PieceType::King);
+      Bitboard blackKing = position.getPieces(Color::Black, PieceType::King);
+      if (whiteKing) {
+        whiteKingPosition.first = rowOf(lsb(whiteKing));
+        whiteKingPosition.second = colOf(lsb(whiteKing));
+      }
+      if (blackKing) {
+        blackKingPosition.first = rowOf(lsb(blackKing));
+        blackKingPosition.second = colOf(lsb(blackKing));
+      }
+    }
+
     bool chessGame::moveSucess() {
       return this -> lastMove;
     }
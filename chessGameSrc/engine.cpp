@@ -0,0 +1,579 @@
+#include "../chessGameHeader/engine.hpp"
+
+#include <cstring>
+#include <functional>
+#include <thread>
+
+//Move ordering bands, a higher score is tried first
+static const int PV_MOVE_SCORE = 1000000;
+static const int CAPTURE_SCORE = 100000;
+static const int FIRST_KILLER_SCORE = 90000;
+static const int SECOND_KILLER_SCORE = 80000;
+
+//How often the clock is looked at, checking it every node would cost more than it saves
+static const uint64_t LIMIT_CHECK_INTERVAL = 1024;
+
+Engine::Engine(size_t hashMegabytes) : network(nullptr), tablebases(nullptr), syzygy(nullptr), book(nullptr), bookSelection(BookSelection::Best), bookRandom(1), ownTable(new TranspositionTable(hashMegabytes)), previousPvLength(0), nodes(0), stopped(false), threadCount(1), threadId(0) {
+    table = ownTable.get();
+    memset(history, 0, sizeof(history));
+    memset(pvLength, 0, sizeof(pvLength));
+    keyHistory.push_back(position.getHashKey());
+}
+
+Engine::Engine(TranspositionTable& sharedTable) : network(nullptr), tablebases(nullptr), syzygy(nullptr), book(nullptr), bookSelection(BookSelection::Best), bookRandom(1), table(&sharedTable), previousPvLength(0), nodes(0), stopped(false), threadCount(1), threadId(0) {
+    memset(history, 0, sizeof(history));
+    memset(pvLength, 0, sizeof(pvLength));
+    keyHistory.push_back(position.getHashKey());
+}
+
+TranspositionTable& Engine::getTranspositionTable(){
+    return *table;
+}
+
+//Mate scores are stored as distance from the stored node, not from the root,
+//so they stay right when the same position is reached at another ply
+static int scoreToTable(int score, int ply){
+    if (score > MATE_SCORE - MAX_PLY){
+        return score + ply;
+    }
+    if (score < -MATE_SCORE + MAX_PLY){
+        return score - ply;
+    }
+    return score;
+}
+
+static int scoreFromTable(int score, int ply){
+    if (score > MATE_SCORE - MAX_PLY){
+        return score - ply;
+    }
+    if (score < -MATE_SCORE + MAX_PLY){
+        return score + ply;
+    }
+    return score;
+}
+
+void Engine::setPosition(const Position& pos){
+    position = pos;
+    position.setNetwork(network);
+    keyHistory.clear();
+    keyHistory.push_back(position.getHashKey());
+}
+
+void Engine::setPosition(const Position& pos, const std::vector<UndoState>& played){
+    position = pos;
+    position.setNetwork(network);
+    keyHistory.clear();
+    for (const UndoState& undo : played){
+        keyHistory.push_back(undo.hashKey);
+    }
+    keyHistory.push_back(position.getHashKey());
+}
+
+const Position& Engine::getPosition() const {
+    return position;
+}
+
+void Engine::setNetwork(const Network* net){
+    network = net && net->isLoaded() ? net : nullptr;
+    position.setNetwork(network);
+}
+
+void Engine::setTablebases(const Tablebases* tables){
+    tablebases = tables && tables->size() ? tables : nullptr;
+}
+
+void Engine::setSyzygy(const SyzygyTablebases* tables){
+    syzygy = tables && tables->size() ? tables : nullptr;
+}
+
+void Engine::setBook(const OpeningBook* openingBook, BookSelection selection, uint64_t seed){
+    book = openingBook && openingBook->isLoaded() ? openingBook : nullptr;
+    bookSelection = selection;
+    bookRandom = seed;
+}
+
+//Table results as search scores, mate distances counted from the root like any other mate
+static int tablebaseScore(const TBResult& result, int ply){
+    if (result.outcome == TBOutcome::Win){
+        return MATE_SCORE - ply - result.plies;
+    }
+    if (result.outcome == TBOutcome::Loss){
+        return -MATE_SCORE + ply + result.plies;
+    }
+    return 0;
+}
+
+//Cursed wins and blessed losses are draws under the fifty move rule, kept a point off 0
+//so a real draw is not preferred to them
+static int syzygyScore(WDLScore result){
+    switch (result){
+        case WDLScore::Win: return SYZYGY_WIN_SCORE;
+        case WDLScore::CursedWin: return 1;
+        case WDLScore::BlessedLoss: return -1;
+        case WDLScore::Loss: return -SYZYGY_WIN_SCORE;
+        default: return 0;
+    }
+}
+
+//Writes "cp <score>" or "mate <moves>", negative moves when the side to move is mated
+static void writeScore(std::ostream& out, int score){
+    if (score > MATE_SCORE - MAX_PLY || score < -MATE_SCORE + MAX_PLY){
+        int matePly = MATE_SCORE - (score > 0 ? score : -score);
+        out << "mate " << (score > 0 ? (matePly + 1) / 2 : -(matePly / 2));
+    }
+    else {
+        out << "cp " << score;
+    }
+}
+
+int Engine::evaluate() const {
+    if (network){
+        return network->evaluate(position.getAccumulator(), position.getSideToMove());
+    }
+    int score = position.getEvaluation();
+    const PawnEntry& pawns = pawnTable.probe(position);
+    score += taperedScore(pawns.midgame, pawns.endgame, position.getGamePhase());
+    return position.getSideToMove() == Color::White ? score : -score;
+}
+
+//Same position earlier in the game or on the search path. Only positions since the
+//last capture or pawn move can match, and only with the same side to move.
+bool Engine::isRepetition() const {
+    int last = static_cast<int>(keyHistory.size()) - 1;
+    int oldest = last - position.getHalfmoveClock();
+    for (int i = last - 2; i >= 0 && i >= oldest; i -= 2){
+        if (keyHistory[i] == keyHistory[last]){
+            return true;
+        }
+    }
+    return false;
+}
+
+void Engine::checkLimits(){
+    if (stopSignal && stopSignal->load(std::memory_order_relaxed)){
+        stopped = true;
+    }
+    if (limits.maxNodes && nodes >= limits.maxNodes){
+        stopped = true;
+    }
+    if (limits.maxTimeMs && (nodes & (LIMIT_CHECK_INTERVAL - 1)) == 0){
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+        if (elapsed.count() >= limits.maxTimeMs){
+            stopped = true;
+        }
+    }
+}
+
+void Engine::scoreMoves(const MoveList& moves, int* scores, Move pvMove, int ply) const {
+    int side = static_cast<int>(position.getSideToMove());
+    for (int i = 0; i < moves.size(); ++i){
+        Move m = moves[i];
+        if (m == pvMove){
+            scores[i] = PV_MOVE_SCORE;
+        }
+        else if (m.isCapture() || m.isPromotion()){
+            //Most valuable victim first, cheapest attacker breaks ties
+            PieceType victim = m.isEnPassant() ? PieceType::Pawn : position.pieceTypeAt(m.getTo());
+            int victimValue = victim == PieceType::none ? 0 : pieceValueTable[static_cast<int>(victim)];
+            int promotionValue = m.isPromotion() ? pieceValueTable[static_cast<int>(m.getPromotion())] : 0;
+            scores[i] = CAPTURE_SCORE + (victimValue + promotionValue) * 8 - static_cast<int>(position.pieceTypeAt(m.getFrom()));
+        }
+        else if (m == killers[ply][0]){
+            scores[i] = FIRST_KILLER_SCORE;
+        }
+        else if (m == killers[ply][1]){
+            scores[i] = SECOND_KILLER_SCORE;
+        }
+        else {
+            scores[i] = history[side][m.getFrom()][m.getTo()];
+        }
+    }
+}
+
+//Brings the best scored move left of i to position i, cheaper than sorting
+//the whole list when a cutoff comes after the first few moves
+static void pickMove(MoveList& moves, int* scores, int i){
+    int best = i;
+    for (int j = i + 1; j < moves.size(); ++j){
+        if (scores[j] > scores[best]){
+            best = j;
+        }
+    }
+    if (best != i){
+        Move m = moves[i];
+        moves[i] = moves[best];
+        moves[best] = m;
+        int s = scores[i];
+        scores[i] = scores[best];
+        scores[best] = s;
+    }
+}
+
+void Engine::storeKiller(Move m, int ply){
+    if (killers[ply][0] != m){
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = m;
+    }
+}
+
+int Engine::quiescence(int ply, int alpha, int beta){
+    ++nodes;
+    checkLimits();
+    pvLength[ply] = ply;
+    if (stopped || ply >= MAX_PLY - 1){
+        return evaluate();
+    }
+
+    //In check every evasion has to be looked at, standing pat is not an option
+    bool inCheck = position.isInCheck(position.getSideToMove());
+    if (!inCheck){
+        int standPat = evaluate();
+        if (standPat >= beta){
+            return standPat;
+        }
+        if (standPat > alpha){
+            alpha = standPat;
+        }
+    }
+
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves, inCheck ? GenStage::ALL : GenStage::CAPTURES);
+    if (inCheck && moves.size() == 0){
+        return -MATE_SCORE + ply;
+    }
+
+    int scores[256];
+    scoreMoves(moves, scores, Move(), ply);
+    int bestScore = inCheck ? -INFINITE_SCORE : alpha;
+    for (int i = 0; i < moves.size(); ++i){
+        pickMove(moves, scores, i);
+        UndoState undo;
+        position.makeMove(moves[i], undo);
+        int score = -quiescence(ply + 1, -beta, -alpha);
+        position.unmakeMove(undo);
+
+        if (stopped){
+            return 0;
+        }
+        if (score > bestScore){
+            bestScore = score;
+        }
+        if (score > alpha){
+            alpha = score;
+            if (alpha >= beta){
+                break;
+            }
+        }
+    }
+    return bestScore;
+}
+
+int Engine::negamax(int depth, int ply, int alpha, int beta){
+    pvLength[ply] = ply;
+    if (ply > 0 && (isRepetition() || position.getHalfmoveClock() >= 100)){
+        return 0;
+    }
+    if (depth <= 0){
+        return quiescence(ply, alpha, beta);
+    }
+    ++nodes;
+    checkLimits();
+    if (stopped){
+        return 0;
+    }
+    if (ply >= MAX_PLY - 1){
+        return evaluate();
+    }
+    TBResult tbResult;
+    if (tablebases && ply > 0 && popCount(position.getOccupancy()) <= tablebases->getMaxPieces()
+        && tablebases->probe(position, tbResult)){
+        return tablebaseScore(tbResult, ply);
+    }
+    //Right after a capture or pawn move the WDL result is exact, the fifty move count
+    //starts from there
+    WDLScore wdl;
+    if (syzygy && ply > 0 && position.getHalfmoveClock() == 0 && popCount(position.getOccupancy()) <= syzygy->getMaxPieces()
+        && syzygy->probeWDL(position, wdl)){
+        return syzygyScore(wdl);
+    }
+
+    uint64_t key = position.getHashKey();
+    TTData entry;
+    bool hit = table->probe(key, entry);
+    if (hit && ply > 0 && entry.depth >= depth){
+        int stored = scoreFromTable(entry.score, ply);
+        if (entry.bound == BOUND_EXACT
+            || (entry.bound == BOUND_LOWER && stored >= beta)
+            || (entry.bound == BOUND_UPPER && stored <= alpha)){
+            return stored;
+        }
+    }
+
+    Color side = position.getSideToMove();
+    MoveList moves;
+    position.generateLegalMoves(side, moves);
+    if (moves.size() == 0){
+        return position.isInCheck(side) ? -MATE_SCORE + ply : 0;
+    }
+
+    //The table's best move first, otherwise the last iteration's principal variation
+    Move pvMove = hit && !entry.move.isNull() ? entry.move : (previousPvLength > ply ? previousPv[ply] : Move());
+    int scores[256];
+    scoreMoves(moves, scores, pvMove, ply);
+    int originalAlpha = alpha;
+    Move bestMove;
+
+    int bestScore = -INFINITE_SCORE;
+    for (int i = 0; i < moves.size(); ++i){
+        pickMove(moves, scores, i);
+        Move m = moves[i];
+
+        table->prefetch(position.keyAfter(m));
+        UndoState undo;
+        position.makeMove(m, undo);
+        keyHistory.push_back(position.getHashKey());
+        int score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+        keyHistory.pop_back();
+        position.unmakeMove(undo);
+
+        if (stopped){
+            return 0;
+        }
+        if (score > bestScore){
+            bestScore = score;
+            bestMove = m;
+        }
+        if (score > alpha){
+            alpha = score;
+            pvTable[ply][ply] = m;
+            for (int next = ply + 1; next < pvLength[ply + 1]; ++next){
+                pvTable[ply][next] = pvTable[ply + 1][next];
+            }
+            pvLength[ply] = pvLength[ply + 1];
+
+            if (alpha >= beta){
+                if (!m.isCapture() && !m.isPromotion()){
+                    storeKiller(m, ply);
+                    history[static_cast<int>(side)][m.getFrom()][m.getTo()] += depth * depth;
+                }
+                break;
+            }
+        }
+    }
+
+    TTBound bound = bestScore >= beta ? BOUND_LOWER : (bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER);
+    table->store(key, bound == BOUND_UPPER ? Move() : bestMove, scoreToTable(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+//Table cutoffs cut the principal variation short, the rest of it is read back
+//out of the table as long as the stored moves are legal
+void Engine::extendFromTable(std::vector<Move>& line, int depth){
+    UndoState undo[MAX_PLY];
+    int played = 0;
+    for (Move m : line){
+        position.makeMove(m, undo[played++]);
+    }
+    while (static_cast<int>(line.size()) < depth){
+        TTData entry;
+        MoveList moves;
+        position.generateLegalMoves(position.getSideToMove(), moves);
+        if (!table->probe(position.getHashKey(), entry) || !moves.contains(entry.move)){
+            break;
+        }
+        line.push_back(entry.move);
+        position.makeMove(entry.move, undo[played++]);
+    }
+    while (played > 0){
+        position.unmakeMove(undo[--played]);
+    }
+}
+
+//Lazy SMP depth schedule from the helper threads' point of view: helper i only
+//searches the depths where ((depth + phase) / size) is even, so at any moment the
+//helpers are spread over a few neighbouring depths instead of all racing on one
+static const int SKIP_SIZE[20] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+static const int SKIP_PHASE[20] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+void Engine::resetSearchState(){
+    startTime = std::chrono::steady_clock::now();
+    nodes = 0;
+    stopped = false;
+    for (int ply = 0; ply < MAX_PLY; ++ply){
+        killers[ply][0] = Move();
+        killers[ply][1] = Move();
+    }
+    memset(history, 0, sizeof(history));
+    memset(pvLength, 0, sizeof(pvLength));
+    previousPvLength = 0;
+}
+
+void Engine::iterate(SearchResult& result, std::ostream* info){
+    int maxDepth = limits.maxDepth < MAX_PLY - 1 ? limits.maxDepth : MAX_PLY - 1;
+    for (int depth = 1; depth <= maxDepth; ++depth){
+        if (threadId > 0){
+            int i = (threadId - 1) % 20;
+            if (((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2){
+                continue;
+            }
+        }
+
+        int score = negamax(depth, 0, -INFINITE_SCORE, INFINITE_SCORE);
+        if (stopped){
+            break;
+        }
+
+        result.depth = depth;
+        result.score = score;
+        result.principalVariation.assign(pvTable[0], pvTable[0] + pvLength[0]);
+        extendFromTable(result.principalVariation, depth);
+        previousPvLength = pvLength[0];
+        for (int ply = 0; ply < previousPvLength; ++ply){
+            previousPv[ply] = pvTable[0][ply];
+        }
+        if (!result.principalVariation.empty()){
+            result.bestMove = result.principalVariation[0];
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (info){
+            *info << "info depth " << depth << " score ";
+            writeScore(*info, score);
+            *info << " nodes " << nodes << " hashfull " << table->hashfull() << " nps " << static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9))
+                  << " time " << static_cast<int64_t>(seconds * 1000) << " pv";
+            for (Move m : result.principalVariation){
+                *info << " " << moveToString(m);
+            }
+            *info << "\n";
+        }
+
+        //A forced mate will not get any shorter by looking deeper
+        if (score > MATE_SCORE - MAX_PLY || score < -MATE_SCORE + MAX_PLY){
+            break;
+        }
+    }
+}
+
+//With the root in the tables every move is looked up and the best one played without
+//searching: the quickest win, else a draw, else the slowest loss
+bool Engine::probeRoot(const MoveList& rootMoves, SearchResult& result){
+    TBResult rootResult;
+    if (!tablebases || popCount(position.getOccupancy()) > tablebases->getMaxPieces()
+        || !tablebases->probe(position, rootResult)){
+        return probeSyzygyRoot(result);
+    }
+    int bestScore = -INFINITE_SCORE;
+    for (int i = 0; i < rootMoves.size(); ++i){
+        UndoState undo;
+        TBResult childResult;
+        position.makeMove(rootMoves[i], undo);
+        bool found = tablebases->probe(position, childResult);
+        position.unmakeMove(undo);
+        if (!found){
+            return probeSyzygyRoot(result);
+        }
+        int score = -tablebaseScore(childResult, 1);
+        if (score > bestScore){
+            bestScore = score;
+            result.bestMove = rootMoves[i];
+        }
+    }
+    result.score = bestScore;
+    result.principalVariation.assign(1, result.bestMove);
+    return true;
+}
+
+//Roots the own tables do not cover: the Syzygy DTZ files rank the moves, the score
+//only says won, drawn or lost
+bool Engine::probeSyzygyRoot(SearchResult& result){
+    WDLScore wdl;
+    Move best;
+    if (!syzygy || popCount(position.getOccupancy()) > syzygy->getMaxPieces() || !syzygy->probeRoot(position, best, wdl)){
+        return false;
+    }
+    result.bestMove = best;
+    result.score = syzygyScore(wdl);
+    result.principalVariation.assign(1, best);
+    return true;
+}
+
+SearchResult Engine::search(const SearchLimits& searchLimits, std::ostream* info){
+    limits = searchLimits;
+    resetSearchState();
+    table->newSearch();
+
+    SearchResult result;
+    MoveList rootMoves;
+    position.generateLegalMoves(position.getSideToMove(), rootMoves);
+    if (rootMoves.size() == 0){
+        result.score = position.isInCheck(position.getSideToMove()) ? -MATE_SCORE : 0;
+        return result;
+    }
+    //Something to play even if the first iteration does not finish
+    result.bestMove = rootMoves[0];
+    Move bookMove = book ? book->pickMove(position, bookSelection, bookRandom) : Move();
+    if (!bookMove.isNull()){
+        result.bestMove = bookMove;
+        result.principalVariation.assign(1, bookMove);
+        if (info){
+            *info << "info depth 0 book pv " << moveToString(bookMove) << "\n";
+        }
+        return result;
+    }
+    if (probeRoot(rootMoves, result)){
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (info){
+            *info << "info depth 0 score ";
+            writeScore(*info, result.score);
+            *info << " tablebase pv " << moveToString(result.bestMove) << "\n";
+        }
+        return result;
+    }
+
+    //Helpers search the same root with their own move ordering state and only
+    //talk to this thread through the shared table. They stop when this one does.
+    stopSignal = std::make_shared<std::atomic<bool>>(false);
+    std::vector<std::unique_ptr<Engine>> helpers;
+    std::vector<SearchResult> helperResults(threadCount > 1 ? threadCount - 1 : 0);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; ++i){
+        helpers.emplace_back(new Engine(*table));
+        Engine& helper = *helpers.back();
+        helper.position = position;
+        helper.network = network;
+        helper.tablebases = tablebases;
+        helper.syzygy = syzygy;
+        helper.keyHistory = keyHistory;
+        helper.limits = SearchLimits();
+        helper.limits.maxDepth = limits.maxDepth;
+        helper.threadId = i;
+        helper.stopSignal = stopSignal;
+        helper.resetSearchState();
+    }
+    for (int i = 0; i < static_cast<int>(helpers.size()); ++i){
+        threads.emplace_back(&Engine::iterate, helpers[i].get(), std::ref(helperResults[i]), nullptr);
+    }
+
+    iterate(result, info);
+
+    stopSignal->store(true, std::memory_order_relaxed);
+    uint64_t totalNodes = nodes;
+    for (int i = 0; i < static_cast<int>(threads.size()); ++i){
+        threads[i].join();
+        totalNodes += helpers[i]->nodes;
+    }
+    stopSignal.reset();
+
+    result.nodes = totalNodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    result.nodesPerSecond = static_cast<uint64_t>(totalNodes / (result.seconds > 0 ? result.seconds : 1e-9));
+    return result;
+}
+
+void Engine::setThreads(int threads){
+    threadCount = threads < 1 ? 1 : threads;
+}
+
+int Engine::getThreads() const {
+    return threadCount;
+}
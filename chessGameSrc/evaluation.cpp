@@ -0,0 +1,121 @@
+#include "../chessGameHeader/evaluation.hpp"
+
+int midgameTable[12][64];
+int endgameTable[12][64];
+
+//Material in centipawns for each phase, pawn to king
+static const int midgameMaterial[6] = {82, 337, 365, 477, 1025, 0};
+static const int endgameMaterial[6] = {94, 281, 297, 512, 936, 0};
+
+//Piece-square bonuses from White's side, written the way the board is printed:
+//the first row is rank 8 and the last row is rank 1
+static const int pawnMidgame[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    10,  10,  20,  30,  30,  20,  10,  10,
+     5,   5,  10,  25,  25,  10,   5,   5,
+     0,   0,   0,  20,  20,   0,   0,   0,
+     5,  -5, -10,   0,   0, -10,  -5,   5,
+     5,  10,  10, -20, -20,  10,  10,   5,
+     0,   0,   0,   0,   0,   0,   0,   0
+};
+
+//In the endgame a pawn is worth more the closer it is to promoting
+static const int pawnEndgame[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+    80,  80,  80,  80,  80,  80,  80,  80,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    30,  30,  30,  30,  30,  30,  30,  30,
+    15,  15,  15,  15,  15,  15,  15,  15,
+     5,   5,   5,   5,   5,   5,   5,   5,
+     0,   0,   0,   0,   0,   0,   0,   0,
+     0,   0,   0,   0,   0,   0,   0,   0
+};
+
+static const int knightSquares[64] = {
+   -50, -40, -30, -30, -30, -30, -40, -50,
+   -40, -20,   0,   0,   0,   0, -20, -40,
+   -30,   0,  10,  15,  15,  10,   0, -30,
+   -30,   5,  15,  20,  20,  15,   5, -30,
+   -30,   0,  15,  20,  20,  15,   0, -30,
+   -30,   5,  10,  15,  15,  10,   5, -30,
+   -40, -20,   0,   5,   5,   0, -20, -40,
+   -50, -40, -30, -30, -30, -30, -40, -50
+};
+
+static const int bishopSquares[64] = {
+   -20, -10, -10, -10, -10, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,  10,  10,   5,   0, -10,
+   -10,   5,   5,  10,  10,   5,   5, -10,
+   -10,   0,  10,  10,  10,  10,   0, -10,
+   -10,  10,  10,  10,  10,  10,  10, -10,
+   -10,   5,   0,   0,   0,   0,   5, -10,
+   -20, -10, -10, -10, -10, -10, -10, -20
+};
+
+static const int rookSquares[64] = {
+     0,   0,   0,   0,   0,   0,   0,   0,
+     5,  10,  10,  10,  10,  10,  10,   5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+     0,   0,   0,   5,   5,   0,   0,   0
+};
+
+static const int queenSquares[64] = {
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,   5,   5,   5,   0, -10,
+    -5,   0,   5,   5,   5,   5,   0,  -5,
+     0,   0,   5,   5,   5,   5,   0,  -5,
+   -10,   5,   5,   5,   5,   5,   0, -10,
+   -10,   0,   5,   0,   0,   0,   0, -10,
+   -20, -10, -10,  -5,  -5, -10, -10, -20
+};
+
+//The king hides behind its pawns while there are queens about...
+static const int kingMidgame[64] = {
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -20, -30, -30, -40, -40, -30, -30, -20,
+   -10, -20, -20, -20, -20, -20, -20, -10,
+    20,  20,   0,   0,   0,   0,  20,  20,
+    20,  30,  10,   0,   0,  10,  30,  20
+};
+
+//...and walks to the centre once they are gone
+static const int kingEndgame[64] = {
+   -50, -40, -30, -20, -20, -30, -40, -50,
+   -30, -20, -10,   0,   0, -10, -20, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  30,  40,  40,  30, -10, -30,
+   -30, -10,  20,  30,  30,  20, -10, -30,
+   -30, -30,   0,   0,   0,   0, -30, -30,
+   -50, -30, -30, -30, -30, -30, -30, -50
+};
+
+static const int* const midgameSquares[6] = {pawnMidgame, knightSquares, bishopSquares, rookSquares, queenSquares, kingMidgame};
+static const int* const endgameSquares[6] = {pawnEndgame, knightSquares, bishopSquares, rookSquares, queenSquares, kingEndgame};
+
+void initEvaluation(){
+    for (int type = 0; type < 6; ++type){
+        PieceCode white = makePieceCode(Color::White, static_cast<PieceType>(type));
+        PieceCode black = makePieceCode(Color::Black, static_cast<PieceType>(type));
+        for (int sq = 0; sq < 64; ++sq){
+            //The tables start at rank 8, so flipping the rank gives White's entry
+            //and a black piece on sq mirrors a white piece on the same row of the table
+            midgameTable[white][sq] = midgameMaterial[type] + midgameSquares[type][sq ^ 56];
+            endgameTable[white][sq] = endgameMaterial[type] + endgameSquares[type][sq ^ 56];
+            midgameTable[black][sq] = -(midgameMaterial[type] + midgameSquares[type][sq]);
+            endgameTable[black][sq] = -(endgameMaterial[type] + endgameSquares[type][sq]);
+        }
+    }
+}
+
+static const bool evaluationReady = (initEvaluation(), true);
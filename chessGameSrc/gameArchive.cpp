@@ -0,0 +1,558 @@
+#include "../chessGameHeader/gameArchive.hpp"
+#include "../chessGameHeader/evaluation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char ARCHIVE_MAGIC[4] = {'C', 'G', 'G', 'A'};
+static const char ARCHIVE_INDEX_MAGIC[4] = {'C', 'G', 'G', 'X'};
+static const uint32_t ARCHIVE_VERSION = 1;
+static const int RECORD_FIXED_BYTES = 8;
+
+//Captures first, most valuable victim then least valuable attacker, then promotions,
+//then quiet moves by their middlegame piece-square gain
+static int rankScore(const Position& pos, Move m){
+    int from = m.getFrom();
+    int to = m.getTo();
+    PieceCode moving = pos.pieceCodeAt(from);
+    int score = 0;
+    if (m.isCapture()){
+        int victim = m.isEnPassant() ? 100 : pieceValueTable[pos.pieceCodeAt(to)];
+        score += 1000000 + victim * 100 - pieceValueTable[moving];
+    }
+    if (m.isPromotion()){
+        score += 500000 + pieceValueTable[makePieceCode(Color::White, m.getPromotion())];
+    }
+    int gain = midgameTable[moving][to] - midgameTable[moving][from];
+    return score + (pieceColorOf(moving) == Color::White ? gain : -gain);
+}
+
+void rankMoves(const Position& pos, MoveList& moves){
+    moves.clear();
+    pos.generateLegalMoves(pos.getSideToMove(), moves);
+    int scores[256];
+    for (int i = 0; i < moves.size(); ++i){
+        scores[i] = rankScore(pos, moves[i]);
+    }
+    //Insertion sort keeps ties in generator order and is quick on a few dozen moves
+    for (int i = 1; i < moves.size(); ++i){
+        Move m = moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        for (; j >= 0 && scores[j] < score; --j){
+            moves[j + 1] = moves[j];
+            scores[j + 1] = scores[j];
+        }
+        moves[j + 1] = m;
+        scores[j + 1] = score;
+    }
+}
+
+//Huffman code lengths for the counts, which all have to be at least 1
+static void huffmanLengths(const uint64_t counts[ARCHIVE_SYMBOLS], uint8_t lengths[ARCHIVE_SYMBOLS]){
+    typedef std::pair<uint64_t, int> Node;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+    //Leaves are 0..255, inner nodes follow, parent of every node but the root
+    std::vector<int> parent(2 * ARCHIVE_SYMBOLS, -1);
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        queue.push(Node(counts[s], s));
+    }
+    int next = ARCHIVE_SYMBOLS;
+    while (queue.size() > 1){
+        Node a = queue.top();
+        queue.pop();
+        Node b = queue.top();
+        queue.pop();
+        parent[a.second] = next;
+        parent[b.second] = next;
+        queue.push(Node(a.first + b.first, next++));
+    }
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        int depth = 0;
+        for (int node = s; parent[node] >= 0; node = parent[node]){
+            ++depth;
+        }
+        lengths[s] = static_cast<uint8_t>(depth);
+    }
+}
+
+//Flattening the counts until the longest code fits costs little, the rare ranks are rare
+static void limitedLengths(const uint64_t counts[ARCHIVE_SYMBOLS], uint8_t lengths[ARCHIVE_SYMBOLS]){
+    uint64_t scaled[ARCHIVE_SYMBOLS];
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        scaled[s] = counts[s] + 1;
+    }
+    for (;;){
+        huffmanLengths(scaled, lengths);
+        if (*std::max_element(lengths, lengths + ARCHIVE_SYMBOLS) <= ARCHIVE_MAX_CODE_BITS){
+            return;
+        }
+        for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+            scaled[s] = (scaled[s] >> 1) | 1;
+        }
+    }
+}
+
+//Ranks of real games fall off roughly like a power law, the first few take most moves
+MoveCode::MoveCode(){
+    uint64_t counts[ARCHIVE_SYMBOLS];
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        counts[s] = static_cast<uint64_t>(1000000.0 / std::pow(s + 2.0, 1.5));
+    }
+    limitedLengths(counts, lengths);
+    buildCodes();
+}
+
+MoveCode MoveCode::fromCounts(const uint64_t counts[ARCHIVE_SYMBOLS]){
+    MoveCode code;
+    limitedLengths(counts, code.lengths);
+    code.buildCodes();
+    return code;
+}
+
+bool MoveCode::setLengths(const uint8_t newLengths[ARCHIVE_SYMBOLS]){
+    uint32_t kraft = 0;
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        if (newLengths[s] > ARCHIVE_MAX_CODE_BITS){
+            return false;
+        }
+        if (newLengths[s] > 0){
+            kraft += 1u << (ARCHIVE_MAX_CODE_BITS - newLengths[s]);
+        }
+    }
+    if (kraft != 1u << ARCHIVE_MAX_CODE_BITS){
+        return false;
+    }
+    memcpy(lengths, newLengths, sizeof(lengths));
+    buildCodes();
+    return true;
+}
+
+//Canonical codes: shorter codes first, symbols in order within a length
+void MoveCode::buildCodes(){
+    decodeTable.assign(1u << ARCHIVE_MAX_CODE_BITS, 0);
+    unsigned next = 0;
+    for (int length = 1; length <= ARCHIVE_MAX_CODE_BITS; ++length){
+        for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+            if (lengths[s] != length){
+                continue;
+            }
+            codes[s] = static_cast<uint16_t>(next);
+            unsigned first = next << (ARCHIVE_MAX_CODE_BITS - length);
+            unsigned last = (next + 1) << (ARCHIVE_MAX_CODE_BITS - length);
+            for (unsigned i = first; i < last; ++i){
+                decodeTable[i] = static_cast<uint16_t>((length << 8) | s);
+            }
+            ++next;
+        }
+        next <<= 1;
+    }
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        if (lengths[s] == 0){
+            codes[s] = 0;
+        }
+    }
+}
+
+std::string ArchiveGame::tag(const std::string& name) const {
+    for (const auto& tag : tags){
+        if (tag.first == name){
+            return tag.second;
+        }
+    }
+    return "";
+}
+
+//Most significant bit first
+class BitWriter {
+ private:
+   std::vector<uint8_t>& out;
+   uint64_t bits;
+   int count;
+
+ public:
+   explicit BitWriter(std::vector<uint8_t>& target) : out(target), bits(0), count(0) {}
+   void put(unsigned code, int length){
+       bits = (bits << length) | code;
+       count += length;
+       while (count >= 8){
+           count -= 8;
+           out.push_back(static_cast<uint8_t>(bits >> count));
+       }
+   }
+   void flush(){
+       if (count > 0){
+           out.push_back(static_cast<uint8_t>(bits << (8 - count)));
+           count = 0;
+       }
+   }
+};
+
+class BitReader {
+ private:
+   const unsigned char* data;
+   size_t bytes;
+   size_t position;
+
+ public:
+   BitReader(const unsigned char* start, size_t size) : data(start), bytes(size), position(0) {}
+   //The next ARCHIVE_MAX_CODE_BITS bits, zeros past the end
+   unsigned peek() const {
+       size_t byte = position >> 3;
+       uint32_t window = 0;
+       for (int i = 0; i < 3; ++i){
+           window = (window << 8) | (byte + i < bytes ? data[byte + i] : 0);
+       }
+       return (window >> (24 - ARCHIVE_MAX_CODE_BITS - (position & 7))) & ((1u << ARCHIVE_MAX_CODE_BITS) - 1);
+   }
+   //False once more bits were taken than there are
+   bool skip(int length){
+       position += length;
+       return position <= bytes * 8;
+   }
+};
+
+static void putLittle(std::vector<uint8_t>& out, uint64_t value, int bytes){
+    for (int i = 0; i < bytes; ++i){
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static uint64_t getLittle(const unsigned char* in, int bytes){
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i){
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+static bool loadStart(const ArchiveGame& game, Position& pos){
+    std::string fen = game.tag("FEN");
+    return pos.loadFEN(fen.empty() ? START_FEN : fen.c_str());
+}
+
+GameArchiveWriter::GameArchiveWriter() : file(nullptr), position(0), failed(false) {}
+
+GameArchiveWriter::~GameArchiveWriter(){
+    if (file){
+        close();
+    }
+}
+
+bool GameArchiveWriter::open(const char* path, const MoveCode& code){
+    if (file){
+        close();
+    }
+    file = fopen(path, "wb");
+    if (!file){
+        return false;
+    }
+    moveCode = code;
+    offsets.clear();
+    failed = false;
+    unsigned char header[ARCHIVE_HEADER_BYTES];
+    memcpy(header, ARCHIVE_MAGIC, 4);
+    memcpy(header + 4, &ARCHIVE_VERSION, 4);
+    memcpy(header + 8, code.getLengths(), ARCHIVE_SYMBOLS);
+    failed = fwrite(header, 1, sizeof(header), file) != sizeof(header);
+    position = sizeof(header);
+    return !failed;
+}
+
+bool GameArchiveWriter::add(const ArchiveGame& game){
+    if (!file || game.tags.size() > 255 || game.moves.size() > 0xFFFF){
+        return false;
+    }
+    record.assign(RECORD_FIXED_BYTES, 0);
+    for (const auto& tag : game.tags){
+        if (tag.first.size() > 255 || tag.second.size() > 0xFFFF){
+            return false;
+        }
+        putLittle(record, tag.first.size(), 1);
+        record.insert(record.end(), tag.first.begin(), tag.first.end());
+        putLittle(record, tag.second.size(), 2);
+        record.insert(record.end(), tag.second.begin(), tag.second.end());
+    }
+    size_t movesStart = record.size();
+
+    Position pos;
+    if (!loadStart(game, pos)){
+        return false;
+    }
+    BitWriter bits(record);
+    MoveList ranked;
+    for (const Move& m : game.moves){
+        rankMoves(pos, ranked);
+        int rank = 0;
+        while (rank < ranked.size() && ranked[rank] != m){
+            ++rank;
+        }
+        if (rank == ranked.size()){
+            return false;
+        }
+        bits.put(moveCode.code(rank), moveCode.length(rank));
+        UndoState undo;
+        pos.makeMove(m, undo);
+    }
+    bits.flush();
+
+    uint32_t moveBytes = static_cast<uint32_t>(record.size() - movesStart);
+    uint16_t plies = static_cast<uint16_t>(game.moves.size());
+    memcpy(record.data(), &moveBytes, 4);
+    memcpy(record.data() + 4, &plies, 2);
+    record[6] = static_cast<uint8_t>(game.result);
+    record[7] = static_cast<uint8_t>(game.tags.size());
+    if (fwrite(record.data(), 1, record.size(), file) != record.size()){
+        failed = true;
+        return false;
+    }
+    offsets.push_back(position);
+    position += record.size();
+    return true;
+}
+
+bool GameArchiveWriter::close(){
+    if (!file){
+        return false;
+    }
+    uint64_t count = offsets.size();
+    bool written = !failed
+        && fwrite(offsets.data(), sizeof(uint64_t), offsets.size(), file) == offsets.size()
+        && fwrite(&count, sizeof(count), 1, file) == 1
+        && fwrite(ARCHIVE_INDEX_MAGIC, 1, 4, file) == 4;
+    written = fclose(file) == 0 && written;
+    file = nullptr;
+    return written;
+}
+
+size_t GameArchiveWriter::size() const {
+    return offsets.size();
+}
+
+GameArchive::GameArchive() : mapping(nullptr), mappedBytes(0), index(nullptr), gameCount(0) {}
+
+GameArchive::~GameArchive(){
+    unload();
+}
+
+void GameArchive::unload(){
+    if (mapping){
+        munmap(mapping, mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+    index = nullptr;
+    gameCount = 0;
+}
+
+bool GameArchive::load(const char* path){
+    unload();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < ARCHIVE_HEADER_BYTES + ARCHIVE_TRAILER_BYTES){
+        close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED){
+        return false;
+    }
+
+    const unsigned char* file = static_cast<const unsigned char*>(data);
+    const unsigned char* trailer = file + bytes - ARCHIVE_TRAILER_BYTES;
+    uint64_t count = getLittle(trailer, 8);
+    uint64_t room = (bytes - ARCHIVE_HEADER_BYTES - ARCHIVE_TRAILER_BYTES) / 8;
+    if (memcmp(file, ARCHIVE_MAGIC, 4) != 0 || getLittle(file + 4, 4) != ARCHIVE_VERSION
+        || memcmp(trailer + 8, ARCHIVE_INDEX_MAGIC, 4) != 0 || count > room
+        || !moveCode.setLengths(file + 8)){
+        munmap(data, bytes);
+        return false;
+    }
+    mapping = data;
+    mappedBytes = bytes;
+    gameCount = count;
+    index = trailer - 8 * count;
+    return true;
+}
+
+size_t GameArchive::size() const {
+    return gameCount;
+}
+
+size_t GameArchive::fileBytes() const {
+    return mappedBytes;
+}
+
+bool GameArchive::recordAt(uint64_t n, const unsigned char*& record, size_t& recordBytes) const {
+    if (n >= gameCount){
+        return false;
+    }
+    const unsigned char* file = static_cast<const unsigned char*>(mapping);
+    uint64_t start = getLittle(index + 8 * n, 8);
+    uint64_t end = n + 1 < gameCount ? getLittle(index + 8 * (n + 1), 8) : static_cast<uint64_t>(index - file);
+    if (start < ARCHIVE_HEADER_BYTES || end < start + RECORD_FIXED_BYTES || end > static_cast<uint64_t>(index - file)){
+        return false;
+    }
+    record = file + start;
+    recordBytes = end - start;
+    return true;
+}
+
+bool GameArchive::readHeader(uint64_t n, ArchiveGame& game) const {
+    const unsigned char* record;
+    size_t recordBytes;
+    if (!recordAt(n, record, recordBytes) || record[6] > static_cast<int>(GameResult::Unknown)){
+        return false;
+    }
+    game.result = static_cast<GameResult>(record[6]);
+    game.tags.resize(record[7]);
+    game.moves.clear();
+    size_t at = RECORD_FIXED_BYTES;
+    for (auto& tag : game.tags){
+        if (at + 1 > recordBytes){
+            return false;
+        }
+        size_t nameLength = record[at++];
+        if (at + nameLength + 2 > recordBytes){
+            return false;
+        }
+        tag.first.assign(reinterpret_cast<const char*>(record + at), nameLength);
+        at += nameLength;
+        size_t valueLength = getLittle(record + at, 2);
+        at += 2;
+        if (at + valueLength > recordBytes){
+            return false;
+        }
+        tag.second.assign(reinterpret_cast<const char*>(record + at), valueLength);
+        at += valueLength;
+    }
+    return at + getLittle(record, 4) == recordBytes;
+}
+
+bool GameArchive::readGame(uint64_t n, ArchiveGame& game) const {
+    if (!readHeader(n, game)){
+        return false;
+    }
+    const unsigned char* record;
+    size_t recordBytes;
+    recordAt(n, record, recordBytes);
+    size_t moveBytes = getLittle(record, 4);
+    int plies = static_cast<int>(getLittle(record + 4, 2));
+
+    Position pos;
+    if (!loadStart(game, pos)){
+        return false;
+    }
+    BitReader bits(record + recordBytes - moveBytes, moveBytes);
+    MoveList ranked;
+    game.moves.reserve(plies);
+    for (int ply = 0; ply < plies; ++ply){
+        int length;
+        int rank = moveCode.decode(bits.peek(), length);
+        rankMoves(pos, ranked);
+        if (length == 0 || rank >= ranked.size() || !bits.skip(length)){
+            return false;
+        }
+        Move m = ranked[rank];
+        game.moves.push_back(m);
+        UndoState undo;
+        pos.makeMove(m, undo);
+    }
+    return true;
+}
+
+//Tag values in PGN keep their escapes in the view
+static std::string unescape(std::string_view value){
+    std::string text;
+    text.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i){
+        if (value[i] == '\\' && i + 1 < value.size()){
+            ++i;
+        }
+        text += value[i];
+    }
+    return text;
+}
+
+bool archiveFromPgn(const PgnGameView& pgn, ArchiveGame& game){
+    game.tags.clear();
+    for (const auto& tag : pgn.tags){
+        game.tags.emplace_back(std::string(tag.first), unescape(tag.second));
+    }
+    game.result = pgn.result;
+    Position pos;
+    return playMovetext(pgn, pos, game.moves);
+}
+
+bool convertPgnToArchive(const char* pgnPath, const char* archivePath, bool twoPasses,
+                         uint64_t& written, uint64_t& skipped, std::ostream* log){
+    written = 0;
+    skipped = 0;
+    PgnFile pgn;
+    if (!pgn.load(pgnPath)){
+        return false;
+    }
+    PgnGameView view;
+    ArchiveGame game;
+    MoveCode code;
+    if (twoPasses){
+        uint64_t counts[ARCHIVE_SYMBOLS] = {};
+        PgnScanner scanner(pgn.text());
+        Position pos;
+        MoveList ranked;
+        while (scanner.next(view)){
+            if (!archiveFromPgn(view, game) || !loadStart(game, pos)){
+                continue;
+            }
+            for (const Move& m : game.moves){
+                rankMoves(pos, ranked);
+                int rank = 0;
+                while (ranked[rank] != m){
+                    ++rank;
+                }
+                counts[rank]++;
+                UndoState undo;
+                pos.makeMove(m, undo);
+            }
+        }
+        code = MoveCode::fromCounts(counts);
+    }
+
+    GameArchiveWriter writer;
+    if (!writer.open(archivePath, code)){
+        return false;
+    }
+    uint64_t plies = 0;
+    PgnScanner scanner(pgn.text());
+    while (scanner.next(view)){
+        if (archiveFromPgn(view, game) && writer.add(game)){
+            ++written;
+            plies += game.moves.size();
+        }
+        else {
+            ++skipped;
+        }
+    }
+    if (!writer.close()){
+        return false;
+    }
+    if (log){
+        GameArchive archive;
+        size_t bytes = archive.load(archivePath) ? archive.fileBytes() : 0;
+        *log << written << " games, " << plies << " plies, " << skipped << " skipped, "
+             << pgn.text().size() << " bytes of PGN in " << bytes << " bytes" << std::endl;
+    }
+    return true;
+}
@@ -3,9 +3,12 @@
 #include <set>
 #include <string>
 #include <limits>
+#include <cstdlib>
+#include <ctime>
 
 
 #include "../chessGameHeader/chessGame.hpp"
+#include "../chessGameHeader/openingExplorer.hpp"
 
 using namespace std;
 
@@ -37,8 +40,63 @@ if (coordY < 0 || coordY >= 8) {
 
 }
 
-void playGame() {
+// Lists some of the stored games that reached the position on the board
+void showGamesLikeThis(const chessGame& game, const GameArchive* archive, const PositionIndex* positions) {
+  if (!archive || !positions || !positions->isLoaded()) {
+    cout << "No game collection loaded." << endl;
+    return;
+  }
+  vector<PositionHit> hits;
+  uint64_t total = positions->find(game.getBoard().getPosition(), hits, 10);
+  cout << total << " stored games reached this position." << endl;
+  ArchiveGame stored;
+  for (const PositionHit& hit : hits) {
+    if (archive->readHeader(hit.game, stored)) {
+      string result = stored.result == GameResult::WhiteWin ? "1-0"
+                      : stored.result == GameResult::BlackWin ? "0-1"
+                      : stored.result == GameResult::Draw ? "1/2-1/2" : "*";
+      cout << "  game " << hit.game + 1 << ": " << stored.tag("White") << " - " << stored.tag("Black")
+           << " " << result << ", move " << hit.ply / 2 + 1 << endl;
+    }
+  }
+}
+
+// The moves most often played from the position on the board in the stored games
+void showTopMoves(const chessGame& game, const OpeningExplorer* explorer) {
+  if (!explorer || !explorer->isLoaded()) {
+    cout << "No opening explorer loaded." << endl;
+    return;
+  }
+  const Position& pos = game.getBoard().getPosition();
+  ExplorerMove moves[5];
+  int count = explorer->findMoves(pos, moves, 5);
+  if (count == 0) {
+    cout << "No stored game reached this position." << endl;
+  }
+  for (int i = 0; i < count; ++i) {
+    cout << "  " << moveToSan(moves[i].move, pos) << ": " << moves[i].games << " games, "
+         << static_cast<int>(moves[i].score + 0.5) << "% for the mover";
+    if (moves[i].averageRating > 0) {
+      cout << ", average rating " << moves[i].averageRating;
+    }
+    cout << endl;
+  }
+}
+
+// With vsComputer set the engine plays black in place of player 2
+void playGame(bool vsComputer = false, size_t hashMegabytes = DEFAULT_HASH_MB, const Network* network = nullptr,
+              const Tablebases* tablebases = nullptr, const SyzygyTablebases* syzygy = nullptr, const OpeningBook* book = nullptr,
+              const GameArchive* archive = nullptr, const PositionIndex* positions = nullptr,
+              const OpeningExplorer* explorer = nullptr) {
   chessGame game1;
+  Engine engine(vsComputer ? hashMegabytes : 1);
+  engine.setNetwork(network);
+  engine.setTablebases(tablebases);
+  engine.setSyzygy(syzygy);
+  // A different line from the book each game, the seed is only fixed within one
+  engine.setBook(book, BookSelection::WeightedRandom, static_cast<uint64_t>(time(nullptr)));
+  SearchLimits computerLimits;
+  computerLimits.maxTimeMs = 2000;
   int userMoveCounter;
   std::string sourcePiece1;
   string targetPiece1;
@@ -56,11 +114,32 @@ void playGame() {
       if (userMoveCounter % 2 == 1) {
           bool isValidInput = false;
 
+        bool turnChanged = false;
+
         while (!isValidInput) {
-          cout << "Player 1, enter the coordinate of white piece you want to move: ";
+          cout << "Player 1, enter the coordinate of white piece you want to move (or undo/redo/games/moves): ";
           // Check if the input length is exactly 2 characters
           cin >> sourcePiece1; 
-          if (sourcePiece1.length() != 2) {
+          if (sourcePiece1 == "games") {
+            showGamesLikeThis(game1, archive, positions);
+          } else if (sourcePiece1 == "moves") {
+            showTopMoves(game1, explorer);
+          } else if (sourcePiece1 == "undo" || sourcePiece1 == "redo") {
+            // Taking back or replaying a move hands the turn to the other player
+            turnChanged = sourcePiece1 == "undo" ? game1.undoMove() : game1.redoMove();
+            if (turnChanged && vsComputer) {
+              // Against the computer the reply goes too, so it is player 1's turn again
+              if (sourcePiece1 == "undo" ? game1.undoMove() : game1.redoMove()) {
+                turnChanged = false;
+                continue;
+              }
+            }
+            if (turnChanged) {
+              userMoveCounter++;
+              break;
+            }
+            cout << "Nothing to " << sourcePiece1 << "!" << endl;
+          } else if (sourcePiece1.length() != 2) {
               cout << "Not Valid! The coordinate should be 2 characters long." << endl;
           } else {
               // Convert the input and check its validity
@@ -74,6 +153,10 @@ void playGame() {
           }
         }
 
+        if (turnChanged) {
+          continue;
+        }
+
         // cout << sourcePiece1;
         // cout << "Source piece is " << sourcePiece1 << endl;
         
@@ -116,6 +199,7 @@ void playGame() {
         // every move. Otherwise, player can make a move after a "checkmate" has
         // already happened
         if (game1.moveSucess()) {
+          game1.printMaterialBalance();
           cout << "Wonderful! Now player 2. " << endl;
           userMoveCounter++;
         }
@@ -126,15 +210,45 @@ void playGame() {
         }
       }
 
+      // The move just made may have ended the game
+      if (gameStatus::IN_PROGRESS != game1.getGameStatus()) {
+        break;
+      }
+
+      if (userMoveCounter % 2 == 0 && vsComputer) {
+        if (game1.playComputerMove(engine, computerLimits, false)) {
+          cout << "Your move, player 1. " << endl;
+          userMoveCounter++;
+        }
+        else {
+          cout << "The computer has no legal move left. " << endl;
+        }
+        continue;
+      }
+
       if (userMoveCounter % 2 == 0) {
         bool isValidInput = false;
+        bool turnChanged = false;
         do {
           cout << "Player 2, enter the coordinate of black piece you want to "
-                  "move: ";
+                  "move (or undo/redo/games/moves): ";
           cin >> sourcePiece1;
 
+          if (sourcePiece1 == "games") {
+            showGamesLikeThis(game1, archive, positions);
+          } else if (sourcePiece1 == "moves") {
+            showTopMoves(game1, explorer);
+          } else if (sourcePiece1 == "undo" || sourcePiece1 == "redo") {
+            // Taking back or replaying a move hands the turn to the other player
+            turnChanged = sourcePiece1 == "undo" ? game1.undoMove() : game1.redoMove();
+            if (turnChanged) {
+              userMoveCounter++;
+              break;
+            }
+            cout << "Nothing to " << sourcePiece1 << "!" << endl;
+          }
           // Check if the input length is exactly 2 characters
-          if (sourcePiece1.length() != 2) {
+          else if (sourcePiece1.length() != 2) {
             cout << "Not Valid! The coordinate should be 2 characters long."
                  << endl;
           } else {
@@ -148,6 +262,10 @@ void playGame() {
             }
           }
         } while (!isValidInput);
+
+        if (turnChanged) {
+          continue;
+        }
         // cout << sourcePiece1;
 
         userPiece1 = int(sourcePiece1[0]) - '0';
@@ -183,6 +301,7 @@ void playGame() {
         // every move. Otherwise, player can make a move after a "checkmate" has
         // already happened
         if (game1.moveSucess()) {
+          game1.printMaterialBalance();
           cout << "Awesome! Now player 1. " << endl;
           userMoveCounter++;
         }
@@ -193,12 +312,46 @@ void playGame() {
     }
   }
   game1.printMoveHistory();
+  game1.printGameResult();
 }
 // signals the game has not ended
 // Print match history after match is over
 // Reset for future games in the same terminal
 
-int main() {
+// Usage: ./playChess [hash size in MB for the computer player] [network file or -] [tablebase directory or -] [opening book or -]
+//                    [game archive or -] [position index or -] [opening explorer]
+int main(int argc, char* argv[]) {
+  size_t hashMegabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : DEFAULT_HASH_MB;
+  // Without a network the computer uses its piece-square evaluation
+  Network network;
+  if (argc > 2 && string(argv[2]) != "-" && !network.load(argv[2])) {
+    cout << "Could not load the network " << argv[2] << ", using the built in evaluation." << endl;
+  }
+  // Tables made by ./tablebaseGen or Syzygy .rtbw/.rtbz files, the computer plays those
+  // endgames perfectly. Several Syzygy directories can be given separated by ':'.
+  Tablebases tablebases;
+  SyzygyTablebases syzygy;
+  if (argc > 3 && string(argv[3]) != "-" && tablebases.load(argv[3]) + syzygy.load(argv[3]) == 0) {
+    cout << "No endgame tables found in " << argv[3] << "." << endl;
+  }
+  // Polyglot .bin book, the computer plays from it as long as the game stays in it
+  OpeningBook book;
+  if (argc > 4 && string(argv[4]) != "-" && !book.load(argv[4])) {
+    cout << "Could not load the opening book " << argv[4] << "." << endl;
+  }
+  // Games from ./pgnToArchive and their index from ./positionIndex, typing games lists
+  // the ones that reached the position on the board
+  GameArchive archive;
+  PositionIndex positions;
+  if (argc > 6 && string(argv[5]) != "-" && (!archive.load(argv[5]) || !positions.load(argv[6]))) {
+    cout << "Could not load the games " << argv[5] << " with the index " << argv[6] << "." << endl;
+    positions.unload();
+  }
+  // Move statistics from ./openingExplorer, typing moves lists the most played ones
+  OpeningExplorer explorer;
+  if (argc > 7 && !explorer.load(argv[7])) {
+    cout << "Could not load the opening explorer " << argv[7] << "." << endl;
+  }
   string chessRules =
       "Pawn The pawn can move only in a forward direction. From its starting "
       "position the pawn may be moved one or two squares. However, after that "
@@ -263,13 +416,13 @@ int main() {
          false)  // while user input is invalid, keep asking for valid input
   {
     cout << "1. Rules of Chess. \n2. Create profile. \n3. Play a two player "
-            "match. \n4. Play as guest. \n5. Exit program."
+            "match. \n4. Play as guest. \n5. Exit program. \n6. Play against the computer."
          << endl;
     cout << "Select an option:";
     cin >> userOption;  // Get user input
     cin.ignore(256, '\n');
     if (userOption != '1' && userOption != '2' && userOption != '3' &&
-        userOption != '4' && userOption != '5')  // Validate user input
+        userOption != '4' && userOption != '5' && userOption != '6')  // Validate user input
     {
       cout << "Please enter a valid input" << endl;
     } else  // If invalid, repeat while loop, if valid continue
@@ -361,18 +514,23 @@ int main() {
             }
           
         }
-        playGame();
+        playGame(false, hashMegabytes, &network, &tablebases, &syzygy, &book, &archive, &positions, &explorer);
         user1Valid = false;
         user2Valid = false;
       }
 
       if (userOption == '4') {
         cout << "You've enter to play as guest." << endl;
-        playGame();
+        playGame(false, hashMegabytes, &network, &tablebases, &syzygy, &book, &archive, &positions, &explorer);
         user1Valid = false;
         user2Valid = false;
       }
 
+      if (userOption == '6') {
+        cout << "You are playing white against the computer." << endl;
+        playGame(true, hashMegabytes, &network, &tablebases, &syzygy, &book, &archive, &positions, &explorer);
+      }
+
       if (userOption == '5') {
         cout << "You entered option 5." << endl;
         return 0;
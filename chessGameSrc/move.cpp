@@ -0,0 +1,17 @@
+#include "../chessGameHeader/move.hpp"
+
+std::string squareToString(int sq){
+    std::string name;
+    name += static_cast<char>('a' + (sq & 7));
+    name += static_cast<char>('1' + (sq >> 3));
+    return name;
+}
+
+std::string moveToString(Move m){
+    static const char promotionLetters[] = "nbrq";
+    std::string text = squareToString(m.getFrom()) + squareToString(m.getTo());
+    if (m.isPromotion()){
+        text += promotionLetters[m.getFlag() & 3];
+    }
+    return text;
+}
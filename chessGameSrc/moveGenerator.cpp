@@ -0,0 +1,225 @@
+#include "../chessGameHeader/position.hpp"
+#include "../chessGameHeader/attacks.hpp"
+
+//Legal move generation straight from the bitboards. Pins and checks are worked out
+//up front so every move added is legal and nothing has to be made and taken back.
+
+static const Bitboard RANK_1 = 0xFFULL;
+static const Bitboard RANK_8 = 0xFF00000000000000ULL;
+
+Bitboard Position::attackersTo(int sq, Bitboard occupied) const{
+    const int black = static_cast<int>(Color::Black);
+    const int white = static_cast<int>(Color::White);
+    Bitboard rooksQueens = pieces[black][3] | pieces[white][3] | pieces[black][4] | pieces[white][4];
+    Bitboard bishopsQueens = pieces[black][2] | pieces[white][2] | pieces[black][4] | pieces[white][4];
+
+    return (pawnAttacks(Color::White, sq) & pieces[black][0])
+         | (pawnAttacks(Color::Black, sq) & pieces[white][0])
+         | (knightAttacks(sq) & (pieces[black][1] | pieces[white][1]))
+         | (kingAttacks(sq) & (pieces[black][5] | pieces[white][5]))
+         | (rookAttacks(sq, occupied) & rooksQueens)
+         | (bishopAttacks(sq, occupied) & bishopsQueens);
+}
+
+bool Position::isSquareAttacked(int sq, Color by) const{
+    return (attackersTo(sq, occupancy) & getPieces(by)) != 0;
+}
+
+bool Position::isInCheck(Color side) const{
+    Bitboard king = getPieces(side, PieceType::King);
+    return king != 0 && isSquareAttacked(lsb(king), opposite(side));
+}
+
+//Own pieces that are the only thing between the king and an enemy slider
+Bitboard Position::pinnedPieces(Color side, int kingSq) const{
+    Color enemy = opposite(side);
+    Bitboard queens = getPieces(enemy, PieceType::Queen);
+    Bitboard snipers = (rookAttacks(kingSq, 0) & (getPieces(enemy, PieceType::Rook) | queens))
+                     | (bishopAttacks(kingSq, 0) & (getPieces(enemy, PieceType::Bishop) | queens));
+    Bitboard pinned = 0;
+
+    while (snipers){
+        int sniper = popLsb(snipers);
+        Bitboard blockers = between(kingSq, sniper) & occupancy;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & getPieces(side))){
+            pinned |= blockers;
+        }
+    }
+    return pinned;
+}
+
+//En passant removes two pieces from the same rank, so it is simplest to just
+//look at the king with both pawns gone and the capturing pawn on the target
+bool Position::enPassantIsLegal(Color side, int from, int kingSq) const{
+    if (kingSq < 0){
+        return true;
+    }
+    Color enemy = opposite(side);
+    int capturedSq = side == Color::White ? enPassantSquare - 8 : enPassantSquare + 8;
+    Bitboard occupied = (occupancy ^ squareBit(from) ^ squareBit(capturedSq)) | squareBit(enPassantSquare);
+    Bitboard queens = getPieces(enemy, PieceType::Queen);
+
+    Bitboard attackers = (rookAttacks(kingSq, occupied) & (getPieces(enemy, PieceType::Rook) | queens))
+                       | (bishopAttacks(kingSq, occupied) & (getPieces(enemy, PieceType::Bishop) | queens))
+                       | (knightAttacks(kingSq) & getPieces(enemy, PieceType::Knight))
+                       | (pawnAttacks(side, kingSq) & getPieces(enemy, PieceType::Pawn) & ~squareBit(capturedSq));
+    return attackers == 0;
+}
+
+static void addPromotions(MoveList& moves, int from, int to, bool capture){
+    int base = capture ? PROMOTION_CAPTURE : PROMOTION;
+    moves.add(Move(from, to, base + 3));
+    moves.add(Move(from, to, base));
+    moves.add(Move(from, to, base + 2));
+    moves.add(Move(from, to, base + 1));
+}
+
+void Position::generateLegalMoves(Color side, MoveList& moves, GenStage stage) const{
+    Color enemy = opposite(side);
+    Bitboard opponent = getPieces(enemy);
+    bool wantCaptures = stage != GenStage::QUIETS;
+    bool wantQuiets = stage != GenStage::CAPTURES;
+
+    Bitboard stageMask = 0;
+    if (wantCaptures){
+        stageMask |= opponent;
+    }
+    if (wantQuiets){
+        stageMask |= ~occupancy;
+    }
+
+    //Positions set up by hand may not have a king, then nothing is pinned or in check
+    Bitboard kingBoard = getPieces(side, PieceType::King);
+    int kingSq = kingBoard ? lsb(kingBoard) : -1;
+    Bitboard checkers = 0;
+
+    if (kingSq >= 0){
+        checkers = attackersTo(kingSq, occupancy) & opponent;
+
+        //The king is taken off the board so sliders see through the square it leaves
+        Bitboard withoutKing = occupancy ^ kingBoard;
+        Bitboard targets = kingAttacks(kingSq) & stageMask;
+        while (targets){
+            int to = popLsb(targets);
+            if (!(attackersTo(to, withoutKing) & opponent)){
+                moves.add(Move(kingSq, to, (opponent & squareBit(to)) ? CAPTURE : QUIET));
+            }
+        }
+
+        //In double check only the king can move
+        if (checkers & (checkers - 1)){
+            return;
+        }
+    }
+
+    //When in check the other pieces must capture the checker or block it
+    Bitboard evasionMask = ~0ULL;
+    if (checkers){
+        int checker = lsb(checkers);
+        evasionMask = between(kingSq, checker) | checkers;
+    }
+    Bitboard pinned = kingSq >= 0 ? pinnedPieces(side, kingSq) : 0;
+    Bitboard targetMask = stageMask & evasionMask;
+
+    //Knights, a pinned knight can never move
+    Bitboard knights = getPieces(side, PieceType::Knight) & ~pinned;
+    while (knights){
+        int from = popLsb(knights);
+        Bitboard targets = knightAttacks(from) & targetMask;
+        while (targets){
+            int to = popLsb(targets);
+            moves.add(Move(from, to, (opponent & squareBit(to)) ? CAPTURE : QUIET));
+        }
+    }
+
+    //Bishops, rooks and queens, a pinned slider may still move along the pin
+    Bitboard queens = getPieces(side, PieceType::Queen);
+    Bitboard sliders = getPieces(side, PieceType::Bishop) | getPieces(side, PieceType::Rook) | queens;
+    Bitboard diagonal = getPieces(side, PieceType::Bishop) | queens;
+    Bitboard straight = getPieces(side, PieceType::Rook) | queens;
+    while (sliders){
+        int from = popLsb(sliders);
+        Bitboard targets = 0;
+        if (diagonal & squareBit(from)){
+            targets |= bishopAttacks(from, occupancy);
+        }
+        if (straight & squareBit(from)){
+            targets |= rookAttacks(from, occupancy);
+        }
+        targets &= targetMask;
+        if (pinned & squareBit(from)){
+            targets &= lineThrough(kingSq, from);
+        }
+        while (targets){
+            int to = popLsb(targets);
+            moves.add(Move(from, to, (opponent & squareBit(to)) ? CAPTURE : QUIET));
+        }
+    }
+
+    //Pawns
+    int push = side == Color::White ? 8 : -8;
+    Bitboard startRank = side == Color::White ? 0xFF00ULL : 0x00FF000000000000ULL;
+    Bitboard promotionRank = side == Color::White ? RANK_8 : RANK_1;
+    //Only trust the en passant square when it sits behind an enemy pawn that just moved
+    Bitboard enPassantRank = side == Color::White ? 0x0000FF0000000000ULL : 0x0000000000FF0000ULL;
+    bool enPassantOpen = wantCaptures && enPassantSquare >= 0 && (squareBit(enPassantSquare) & enPassantRank);
+
+    Bitboard pawns = getPieces(side, PieceType::Pawn);
+    while (pawns){
+        int from = popLsb(pawns);
+        Bitboard pinMask = (pinned & squareBit(from)) ? lineThrough(kingSq, from) : ~0ULL;
+
+        if (wantCaptures){
+            Bitboard targets = pawnAttacks(side, from) & opponent & evasionMask & pinMask;
+            while (targets){
+                int to = popLsb(targets);
+                if (squareBit(to) & promotionRank){
+                    addPromotions(moves, from, to, true);
+                }
+                else {
+                    moves.add(Move(from, to, CAPTURE));
+                }
+            }
+            if (enPassantOpen && (pawnAttacks(side, from) & squareBit(enPassantSquare) & pinMask)
+                && enPassantIsLegal(side, from, kingSq)){
+                moves.add(Move(from, enPassantSquare, EN_PASSANT));
+            }
+        }
+
+        int single = from + push;
+        if (wantQuiets && !(occupancy & squareBit(single))){
+            if (squareBit(single) & evasionMask & pinMask){
+                if (squareBit(single) & promotionRank){
+                    addPromotions(moves, from, single, false);
+                }
+                else {
+                    moves.add(Move(from, single, QUIET));
+                }
+            }
+            int twice = single + push;
+            if ((squareBit(from) & startRank) && !(occupancy & squareBit(twice))
+                && (squareBit(twice) & evasionMask & pinMask)){
+                moves.add(Move(from, twice, DOUBLE_PAWN_PUSH));
+            }
+        }
+    }
+
+    //Castling, never out of check and never through or into an attacked square
+    if (wantQuiets && !checkers && kingSq >= 0){
+        int kingSide = side == Color::White ? WHITE_KING_SIDE : BLACK_KING_SIDE;
+        int queenSide = side == Color::White ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+        int home = side == Color::White ? 4 : 60;
+        Bitboard rooks = getPieces(side, PieceType::Rook);
+
+        if (kingSq == home && (castlingRights & kingSide) && (rooks & squareBit(home + 3))
+            && !(occupancy & (squareBit(home + 1) | squareBit(home + 2)))
+            && !isSquareAttacked(home + 1, enemy) && !isSquareAttacked(home + 2, enemy)){
+            moves.add(Move(home, home + 2, KING_CASTLE));
+        }
+        if (kingSq == home && (castlingRights & queenSide) && (rooks & squareBit(home - 4))
+            && !(occupancy & (squareBit(home - 1) | squareBit(home - 2) | squareBit(home - 3)))
+            && !isSquareAttacked(home - 1, enemy) && !isSquareAttacked(home - 2, enemy)){
+            moves.add(Move(home, home - 2, QUEEN_CASTLE));
+        }
+    }
+}
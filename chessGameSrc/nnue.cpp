@@ -0,0 +1,377 @@
+#include "../chessGameHeader/nnue.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+static const char NETWORK_MAGIC[4] = {'C', 'G', 'N', 'N'};
+static const uint32_t NETWORK_VERSION = 1;
+static const size_t HEADER_BYTES = 64;
+
+//Byte offsets of each array in the file, in the order the header comment lists them
+static const size_t FEATURE_WEIGHTS_OFFSET = HEADER_BYTES;
+static const size_t FEATURE_BIAS_OFFSET = FEATURE_WEIGHTS_OFFSET + sizeof(int16_t) * NNUE_FEATURES * NNUE_HIDDEN;
+static const size_t L1_WEIGHTS_OFFSET = FEATURE_BIAS_OFFSET + sizeof(int16_t) * NNUE_HIDDEN;
+static const size_t L1_BIAS_OFFSET = L1_WEIGHTS_OFFSET + sizeof(int8_t) * NNUE_L1 * 2 * NNUE_HIDDEN;
+static const size_t L2_WEIGHTS_OFFSET = L1_BIAS_OFFSET + sizeof(int32_t) * NNUE_L1;
+static const size_t L2_BIAS_OFFSET = L2_WEIGHTS_OFFSET + sizeof(int8_t) * NNUE_L2 * NNUE_L1;
+static const size_t OUTPUT_WEIGHTS_OFFSET = L2_BIAS_OFFSET + sizeof(int32_t) * NNUE_L2;
+static const size_t OUTPUT_BIAS_OFFSET = OUTPUT_WEIGHTS_OFFSET + sizeof(int8_t) * NNUE_L2;
+static const size_t NETWORK_FILE_BYTES = OUTPUT_BIAS_OFFSET + sizeof(int32_t);
+
+//Kernels. Every version does the same integer arithmetic, so all of them give the same score.
+
+//Scalar fallback, runs anywhere
+static void addScalar(int16_t* acc, const int16_t* weights){
+    for (int i = 0; i < NNUE_HIDDEN; ++i){
+        acc[i] += weights[i];
+    }
+}
+
+static void subScalar(int16_t* acc, const int16_t* weights){
+    for (int i = 0; i < NNUE_HIDDEN; ++i){
+        acc[i] -= weights[i];
+    }
+}
+
+static void moveScalar(int16_t* acc, const int16_t* removed, const int16_t* added){
+    for (int i = 0; i < NNUE_HIDDEN; ++i){
+        acc[i] += added[i] - removed[i];
+    }
+}
+
+static int32_t dotScalar(const uint8_t* input, const int8_t* weights, int length){
+    int32_t sum = 0;
+    for (int i = 0; i < length; ++i){
+        sum += input[i] * weights[i];
+    }
+    return sum;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+//SSE4.1, 8 accumulator lanes or 16 input bytes per instruction
+__attribute__((target("sse4.1")))
+static void addSse41(int16_t* acc, const int16_t* weights){
+    for (int i = 0; i < NNUE_HIDDEN; i += 8){
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, w));
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void subSse41(int16_t* acc, const int16_t* weights){
+    for (int i = 0; i < NNUE_HIDDEN; i += 8){
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, w));
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void moveSse41(int16_t* acc, const int16_t* removed, const int16_t* added){
+    for (int i = 0; i < NNUE_HIDDEN; i += 8){
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(removed + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(added + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(_mm_sub_epi16(a, r), w));
+    }
+}
+
+//maddubs multiplies unsigned inputs by signed weights and adds neighbouring pairs into
+//16 bits. Inputs are at most 127, so a pair never saturates. madd by one widens to 32 bits.
+__attribute__((target("sse4.1")))
+static int32_t dotSse41(const uint8_t* input, const int8_t* weights, int length){
+    __m128i sum = _mm_setzero_si128();
+    __m128i ones = _mm_set1_epi16(1);
+    for (int i = 0; i < length; i += 16){
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(in, w), ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+//AVX2, twice the width of SSE4.1
+__attribute__((target("avx2")))
+static void addAvx2(int16_t* acc, const int16_t* weights){
+    for (int i = 0; i < NNUE_HIDDEN; i += 16){
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, w));
+    }
+}
+
+__attribute__((target("avx2")))
+static void subAvx2(int16_t* acc, const int16_t* weights){
+    for (int i = 0; i < NNUE_HIDDEN; i += 16){
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, w));
+    }
+}
+
+__attribute__((target("avx2")))
+static void moveAvx2(int16_t* acc, const int16_t* removed, const int16_t* added){
+    for (int i = 0; i < NNUE_HIDDEN; i += 16){
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i r = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(_mm256_sub_epi16(a, r), w));
+    }
+}
+
+__attribute__((target("avx2")))
+static int32_t dotAvx2(const uint8_t* input, const int8_t* weights, int length){
+    __m256i sum = _mm256_setzero_si256();
+    __m256i ones = _mm256_set1_epi16(1);
+    for (int i = 0; i < length; i += 32){
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+static void (*addKernel)(int16_t*, const int16_t*) = addScalar;
+static void (*subKernel)(int16_t*, const int16_t*) = subScalar;
+static void (*moveKernel)(int16_t*, const int16_t*, const int16_t*) = moveScalar;
+static int32_t (*dotKernel)(const uint8_t*, const int8_t*, int) = dotScalar;
+static SimdLevel currentLevel = SimdLevel::Scalar;
+
+SimdLevel detectSimdLevel(){
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (__builtin_cpu_supports("avx2")){
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")){
+        return SimdLevel::SSE41;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+//Targets without the x86 kernels always end up on the scalar ones
+void selectSimdLevel(SimdLevel level){
+    switch (level){
+#if defined(__x86_64__) || defined(__i386__)
+        case SimdLevel::AVX2:
+            addKernel = addAvx2;
+            subKernel = subAvx2;
+            moveKernel = moveAvx2;
+            dotKernel = dotAvx2;
+            currentLevel = level;
+            break;
+        case SimdLevel::SSE41:
+            addKernel = addSse41;
+            subKernel = subSse41;
+            moveKernel = moveSse41;
+            dotKernel = dotSse41;
+            currentLevel = level;
+            break;
+#endif
+        default:
+            addKernel = addScalar;
+            subKernel = subScalar;
+            moveKernel = moveScalar;
+            dotKernel = dotScalar;
+            currentLevel = SimdLevel::Scalar;
+            break;
+    }
+}
+
+SimdLevel getSimdLevel(){
+    return currentLevel;
+}
+
+const char* simdLevelName(SimdLevel level){
+    switch (level){
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+//Picks the best kernels the CPU supports before main
+static const bool kernelsReady = (selectSimdLevel(detectSimdLevel()), true);
+
+//Feature of a piece as one side sees it: own pieces first, and Black sees the board flipped
+static int featureIndex(Color perspective, PieceCode code, int sq){
+    int relative = pieceColorOf(code) == perspective ? 0 : 6;
+    int square = perspective == Color::White ? sq : sq ^ 56;
+    return (relative + static_cast<int>(pieceTypeOf(code))) * 64 + square;
+}
+
+static uint8_t clipActivation(int32_t value){
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > NNUE_QA ? NNUE_QA : value));
+}
+
+Network::Network() : mapping(nullptr), mappedBytes(0), featureWeights(nullptr), featureBias(nullptr),
+                     l1Weights(nullptr), l1Bias(nullptr), l2Weights(nullptr), l2Bias(nullptr),
+                     outputWeights(nullptr), outputBias(nullptr) {}
+
+Network::~Network(){
+    unload();
+}
+
+void Network::unload(){
+    if (mapping){
+        munmap(mapping, mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+}
+
+bool Network::load(const char* path){
+    unload();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != NETWORK_FILE_BYTES){
+        close(fd);
+        return false;
+    }
+    //The pages are shared with every other process that maps the same file
+    void* data = mmap(nullptr, NETWORK_FILE_BYTES, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED){
+        return false;
+    }
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t version;
+    uint32_t hidden;
+    memcpy(&version, bytes + 4, sizeof(version));
+    memcpy(&hidden, bytes + 8, sizeof(hidden));
+    if (memcmp(bytes, NETWORK_MAGIC, 4) != 0 || version != NETWORK_VERSION || hidden != NNUE_HIDDEN){
+        munmap(data, NETWORK_FILE_BYTES);
+        return false;
+    }
+
+    mapping = data;
+    mappedBytes = NETWORK_FILE_BYTES;
+    featureWeights = reinterpret_cast<const int16_t*>(bytes + FEATURE_WEIGHTS_OFFSET);
+    featureBias = reinterpret_cast<const int16_t*>(bytes + FEATURE_BIAS_OFFSET);
+    l1Weights = reinterpret_cast<const int8_t*>(bytes + L1_WEIGHTS_OFFSET);
+    l1Bias = reinterpret_cast<const int32_t*>(bytes + L1_BIAS_OFFSET);
+    l2Weights = reinterpret_cast<const int8_t*>(bytes + L2_WEIGHTS_OFFSET);
+    l2Bias = reinterpret_cast<const int32_t*>(bytes + L2_BIAS_OFFSET);
+    outputWeights = reinterpret_cast<const int8_t*>(bytes + OUTPUT_WEIGHTS_OFFSET);
+    outputBias = reinterpret_cast<const int32_t*>(bytes + OUTPUT_BIAS_OFFSET);
+    return true;
+}
+
+bool Network::isLoaded() const {
+    return mapping != nullptr;
+}
+
+void Network::resetAccumulator(Accumulator& acc) const {
+    for (int side = 0; side < 2; ++side){
+        memcpy(acc.values[side], featureBias, sizeof(acc.values[side]));
+    }
+}
+
+void Network::addPiece(Accumulator& acc, PieceCode code, int sq) const {
+    addKernel(acc.values[0], featureWeights + featureIndex(Color::Black, code, sq) * NNUE_HIDDEN);
+    addKernel(acc.values[1], featureWeights + featureIndex(Color::White, code, sq) * NNUE_HIDDEN);
+}
+
+void Network::removePiece(Accumulator& acc, PieceCode code, int sq) const {
+    subKernel(acc.values[0], featureWeights + featureIndex(Color::Black, code, sq) * NNUE_HIDDEN);
+    subKernel(acc.values[1], featureWeights + featureIndex(Color::White, code, sq) * NNUE_HIDDEN);
+}
+
+void Network::movePiece(Accumulator& acc, PieceCode code, int from, int to) const {
+    moveKernel(acc.values[0], featureWeights + featureIndex(Color::Black, code, from) * NNUE_HIDDEN,
+               featureWeights + featureIndex(Color::Black, code, to) * NNUE_HIDDEN);
+    moveKernel(acc.values[1], featureWeights + featureIndex(Color::White, code, from) * NNUE_HIDDEN,
+               featureWeights + featureIndex(Color::White, code, to) * NNUE_HIDDEN);
+}
+
+int Network::evaluate(const Accumulator& acc, Color sideToMove) const {
+    //Side to move's half of the accumulator goes first
+    alignas(32) uint8_t input[2 * NNUE_HIDDEN];
+    const int16_t* us = acc.values[static_cast<int>(sideToMove)];
+    const int16_t* them = acc.values[static_cast<int>(sideToMove) ^ 1];
+    for (int i = 0; i < NNUE_HIDDEN; ++i){
+        input[i] = clipActivation(us[i]);
+        input[NNUE_HIDDEN + i] = clipActivation(them[i]);
+    }
+
+    alignas(32) uint8_t hidden1[NNUE_L1];
+    for (int j = 0; j < NNUE_L1; ++j){
+        int32_t sum = l1Bias[j] + dotKernel(input, l1Weights + j * 2 * NNUE_HIDDEN, 2 * NNUE_HIDDEN);
+        hidden1[j] = clipActivation(sum >> NNUE_WEIGHT_SHIFT);
+    }
+
+    alignas(32) uint8_t hidden2[NNUE_L2];
+    for (int j = 0; j < NNUE_L2; ++j){
+        int32_t sum = l2Bias[j] + dotKernel(hidden1, l2Weights + j * NNUE_L1, NNUE_L1);
+        hidden2[j] = clipActivation(sum >> NNUE_WEIGHT_SHIFT);
+    }
+
+    int32_t output = *outputBias + dotKernel(hidden2, outputWeights, NNUE_L2);
+    return output / NNUE_OUTPUT_SCALE;
+}
+
+size_t Network::fileSize(){
+    return NETWORK_FILE_BYTES;
+}
+
+bool writeRandomNetwork(const char* path, uint64_t seed){
+    std::vector<unsigned char> bytes(NETWORK_FILE_BYTES, 0);
+    memcpy(bytes.data(), NETWORK_MAGIC, 4);
+    memcpy(bytes.data() + 4, &NETWORK_VERSION, sizeof(NETWORK_VERSION));
+    uint32_t hidden = NNUE_HIDDEN;
+    memcpy(bytes.data() + 8, &hidden, sizeof(hidden));
+
+    //xorshift64, the values only need to be small and spread out
+    uint64_t state = seed ? seed : 1;
+    auto next = [&state](int range){
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<int>(state % (2 * range + 1)) - range;
+    };
+
+    int16_t* features = reinterpret_cast<int16_t*>(bytes.data() + FEATURE_WEIGHTS_OFFSET);
+    for (int i = 0; i < NNUE_FEATURES * NNUE_HIDDEN + NNUE_HIDDEN; ++i){
+        features[i] = static_cast<int16_t>(next(32));
+    }
+    int8_t* l1 = reinterpret_cast<int8_t*>(bytes.data() + L1_WEIGHTS_OFFSET);
+    for (int i = 0; i < NNUE_L1 * 2 * NNUE_HIDDEN; ++i){
+        l1[i] = static_cast<int8_t>(next(64));
+    }
+    int8_t* l2 = reinterpret_cast<int8_t*>(bytes.data() + L2_WEIGHTS_OFFSET);
+    for (int i = 0; i < NNUE_L2 * NNUE_L1; ++i){
+        l2[i] = static_cast<int8_t>(next(64));
+    }
+    int8_t* out = reinterpret_cast<int8_t*>(bytes.data() + OUTPUT_WEIGHTS_OFFSET);
+    for (int i = 0; i < NNUE_L2; ++i){
+        out[i] = static_cast<int8_t>(next(64));
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file){
+        return false;
+    }
+    bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return fclose(file) == 0 && written;
+}
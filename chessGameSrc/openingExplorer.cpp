@@ -0,0 +1,271 @@
+#include "../chessGameHeader/openingExplorer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char EXPLORER_MAGIC[4] = {'C', 'G', 'O', 'E'};
+static const uint32_t EXPLORER_VERSION = 1;
+
+struct MoveTally {
+    uint16_t move;
+    uint32_t games;
+    uint32_t whiteWins;
+    uint32_t draws;
+    uint32_t blackWins;
+    uint64_t ratingSum;
+    uint32_t rated;
+};
+
+struct ExplorerNode {
+    uint64_t key;
+    uint32_t firstMove;
+    uint32_t moveCount;
+};
+
+static void putLittle(std::vector<uint8_t>& out, uint64_t value, int bytes){
+    for (int i = 0; i < bytes; ++i){
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static uint64_t getLittle(const unsigned char* in, int bytes){
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i){
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+//Writes the sorted nodes into out in Eytzinger order by an in-order walk of the implicit
+//tree, returns the next sorted node to place
+static size_t placeNodes(const std::vector<ExplorerNode>& sorted, std::vector<ExplorerNode>& out, size_t next, size_t k){
+    if (k < sorted.size()){
+        next = placeNodes(sorted, out, next, 2 * k + 1);
+        out[k] = sorted[next++];
+        next = placeNodes(sorted, out, next, 2 * k + 2);
+    }
+    return next;
+}
+
+static int eloTag(const ArchiveGame& game, const char* name){
+    std::string value = game.tag(name);
+    int elo = atoi(value.c_str());
+    return elo > 0 && elo < 65536 ? elo : 0;
+}
+
+bool buildOpeningExplorer(const GameArchive& archive, const char* path,
+                          const OpeningExplorerOptions& options, std::ostream* log){
+    std::unordered_map<uint64_t, std::vector<MoveTally>> positions;
+    ArchiveGame game;
+    Position pos;
+    uint64_t games = 0;
+    for (uint64_t n = 0; n < archive.size(); ++n){
+        std::string fen;
+        if (!archive.readGame(n, game) || !pos.loadFEN((fen = game.tag("FEN")).empty() ? START_FEN : fen.c_str())){
+            continue;
+        }
+        int elo[2] = {eloTag(game, "WhiteElo"), eloTag(game, "BlackElo")};
+        size_t plies = std::min(game.moves.size(), static_cast<size_t>(std::max(options.maxPlies, 0)));
+        for (size_t ply = 0; ply < plies; ++ply){
+            Move m = game.moves[ply];
+            std::vector<MoveTally>& tallies = positions[pos.getHashKey()];
+            auto tally = std::find_if(tallies.begin(), tallies.end(),
+                                      [&](const MoveTally& t){ return t.move == m.getRaw(); });
+            if (tally == tallies.end()){
+                tallies.push_back({m.getRaw(), 0, 0, 0, 0, 0, 0});
+                tally = tallies.end() - 1;
+            }
+            tally->games++;
+            tally->whiteWins += game.result == GameResult::WhiteWin;
+            tally->draws += game.result == GameResult::Draw;
+            tally->blackWins += game.result == GameResult::BlackWin;
+            int rating = elo[pos.getSideToMove() == Color::White ? 0 : 1];
+            if (rating > 0){
+                tally->ratingSum += rating;
+                tally->rated++;
+            }
+            UndoState undo;
+            pos.makeMove(m, undo);
+        }
+        ++games;
+    }
+
+    std::vector<uint64_t> keys;
+    keys.reserve(positions.size());
+    for (const auto& position : positions){
+        keys.push_back(position.first);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    //Moves go out in key order, so walking the nodes in key order reads them front to back
+    std::vector<ExplorerNode> sorted;
+    std::vector<uint8_t> moveBytes;
+    uint32_t moveCount = 0;
+    for (uint64_t key : keys){
+        std::vector<MoveTally>& tallies = positions[key];
+        std::sort(tallies.begin(), tallies.end(), [](const MoveTally& a, const MoveTally& b){
+            return a.games != b.games ? a.games > b.games : a.move < b.move;
+        });
+        ExplorerNode node = {key, moveCount, 0};
+        for (const MoveTally& tally : tallies){
+            if (tally.games < static_cast<uint32_t>(std::max(options.minGames, 1))){
+                break;
+            }
+            putLittle(moveBytes, tally.move, 2);
+            putLittle(moveBytes, tally.rated ? tally.ratingSum / tally.rated : 0, 2);
+            putLittle(moveBytes, tally.games, 4);
+            putLittle(moveBytes, tally.whiteWins, 4);
+            putLittle(moveBytes, tally.draws, 4);
+            putLittle(moveBytes, tally.blackWins, 4);
+            node.moveCount++;
+        }
+        if (node.moveCount > 0){
+            moveCount += node.moveCount;
+            sorted.push_back(node);
+        }
+    }
+    positions.clear();
+
+    std::vector<ExplorerNode> ordered(sorted.size());
+    placeNodes(sorted, ordered, 0, 0);
+    std::vector<uint8_t> bytes(EXPLORER_MAGIC, EXPLORER_MAGIC + 4);
+    putLittle(bytes, EXPLORER_VERSION, 4);
+    putLittle(bytes, ordered.size(), 8);
+    for (const ExplorerNode& node : ordered){
+        putLittle(bytes, node.key, 8);
+        putLittle(bytes, node.firstMove, 4);
+        putLittle(bytes, node.moveCount, 4);
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file){
+        return false;
+    }
+    bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size()
+              && fwrite(moveBytes.data(), 1, moveBytes.size(), file) == moveBytes.size();
+    ok = fclose(file) == 0 && ok;
+    if (ok && log){
+        *log << games << " games, " << ordered.size() << " positions, " << moveCount << " moves" << std::endl;
+    }
+    return ok;
+}
+
+OpeningExplorer::OpeningExplorer() : mapping(nullptr), mappedBytes(0), nodes(nullptr), moves(nullptr), nodeCount(0), moveCount(0) {}
+
+OpeningExplorer::~OpeningExplorer(){
+    unload();
+}
+
+void OpeningExplorer::unload(){
+    if (mapping){
+        munmap(mapping, mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+    nodes = nullptr;
+    moves = nullptr;
+    nodeCount = 0;
+    moveCount = 0;
+}
+
+bool OpeningExplorer::load(const char* path){
+    unload();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < EXPLORER_HEADER_BYTES){
+        close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED){
+        return false;
+    }
+
+    const unsigned char* file = static_cast<const unsigned char*>(data);
+    uint64_t count = getLittle(file + 8, 8);
+    uint64_t room = (bytes - EXPLORER_HEADER_BYTES) / EXPLORER_NODE_BYTES;
+    uint64_t moveBytes = count <= room ? bytes - EXPLORER_HEADER_BYTES - count * EXPLORER_NODE_BYTES : 1;
+    if (memcmp(file, EXPLORER_MAGIC, 4) != 0 || getLittle(file + 4, 4) != EXPLORER_VERSION
+        || moveBytes % EXPLORER_MOVE_BYTES != 0){
+        munmap(data, bytes);
+        return false;
+    }
+    mapping = data;
+    mappedBytes = bytes;
+    nodeCount = count;
+    nodes = file + EXPLORER_HEADER_BYTES;
+    moves = nodes + count * EXPLORER_NODE_BYTES;
+    moveCount = moveBytes / EXPLORER_MOVE_BYTES;
+    return true;
+}
+
+bool OpeningExplorer::isLoaded() const {
+    return mapping != nullptr;
+}
+
+size_t OpeningExplorer::size() const {
+    return nodeCount;
+}
+
+int OpeningExplorer::findMoves(const Position& pos, ExplorerMove* out, int max) const {
+    uint64_t key = pos.getHashKey();
+    uint64_t k = 0;
+    while (k < nodeCount){
+        //The four grandchildren sit next to each other, and with the 16 byte header in
+        //front of the nodes they fill exactly one cache line of the page aligned mapping
+        __builtin_prefetch(nodes + (4 * k + 3) * EXPLORER_NODE_BYTES);
+        uint64_t found = getLittle(nodes + k * EXPLORER_NODE_BYTES, 8);
+        if (found == key){
+            break;
+        }
+        k = 2 * k + 1 + (found < key);
+    }
+    if (k >= nodeCount){
+        return 0;
+    }
+    const unsigned char* node = nodes + k * EXPLORER_NODE_BYTES;
+    uint64_t first = getLittle(node + 8, 4);
+    uint64_t count = getLittle(node + 12, 4);
+    if (first + count > moveCount){
+        return 0;
+    }
+
+    //A key shared with some other position could offer moves that are not legal here
+    MoveList legal;
+    pos.generateLegalMoves(pos.getSideToMove(), legal);
+    bool white = pos.getSideToMove() == Color::White;
+    int written = 0;
+    for (uint64_t i = first; i < first + count && written < max; ++i){
+        const unsigned char* record = moves + i * EXPLORER_MOVE_BYTES;
+        uint16_t raw = static_cast<uint16_t>(getLittle(record, 2));
+        Move m(raw & 63, (raw >> 6) & 63, raw >> 12);
+        if (!legal.contains(m)){
+            continue;
+        }
+        ExplorerMove& result = out[written++];
+        result.move = m;
+        result.averageRating = static_cast<int>(getLittle(record + 2, 2));
+        result.games = static_cast<uint32_t>(getLittle(record + 4, 4));
+        result.whiteWins = static_cast<uint32_t>(getLittle(record + 8, 4));
+        result.draws = static_cast<uint32_t>(getLittle(record + 12, 4));
+        result.blackWins = static_cast<uint32_t>(getLittle(record + 16, 4));
+        uint32_t decided = result.whiteWins + result.draws + result.blackWins;
+        uint32_t wins = white ? result.whiteWins : result.blackWins;
+        result.score = decided ? 100.0 * (wins + 0.5 * result.draws) / decided : 0.0;
+    }
+    return written;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "../chessGameHeader/openingExplorer.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./openingExplorer [-plies N] [-min N] <games.cga> <explorer.cge>
+//  ./openingExplorer -show <explorer.cge> "<FEN>"
+//The first form counts the moves of the first N plies of an archive made by
+//./pgnToArchive, leaving out moves played fewer than -min times. The second prints
+//the moves played from a position.
+
+static int showMoves(const char* path, const char* fen){
+    OpeningExplorer explorer;
+    if (!explorer.load(path)){
+        cerr << "Could not read " << path << endl;
+        return 1;
+    }
+    Position pos;
+    if (!pos.loadFEN(fen)){
+        cerr << "Not a valid FEN: " << fen << endl;
+        return 1;
+    }
+    ExplorerMove moves[256];
+    auto start = chrono::steady_clock::now();
+    int count = explorer.findMoves(pos, moves, 256);
+    double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    cout << count << " moves in " << explorer.size() << " positions, found in " << micros << " us" << endl;
+    for (int i = 0; i < count; ++i){
+        char line[96];
+        snprintf(line, sizeof(line), "%-8s %8u games %6.1f%% %5u/%u/%u  avg %d",
+                 moveToSan(moves[i].move, pos).c_str(), moves[i].games, moves[i].score, moves[i].whiteWins,
+                 moves[i].draws, moves[i].blackWins, moves[i].averageRating);
+        cout << line << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    if (argc == 4 && strcmp(argv[1], "-show") == 0){
+        return showMoves(argv[2], argv[3]);
+    }
+    OpeningExplorerOptions options;
+    int first = 1;
+    while (first + 1 < argc && argv[first][0] == '-'){
+        if (strcmp(argv[first], "-plies") == 0){
+            options.maxPlies = atoi(argv[first + 1]);
+        }
+        else if (strcmp(argv[first], "-min") == 0){
+            options.minGames = atoi(argv[first + 1]);
+        }
+        else {
+            break;
+        }
+        first += 2;
+    }
+    if (argc - first != 2){
+        cout << "Usage: ./openingExplorer [-plies N] [-min N] <games.cga> <explorer.cge>" << endl;
+        cout << "       ./openingExplorer -show <explorer.cge> \"<FEN>\"" << endl;
+        return 1;
+    }
+    GameArchive archive;
+    if (!archive.load(argv[first])){
+        cerr << "Could not read " << argv[first] << endl;
+        return 1;
+    }
+    if (!buildOpeningExplorer(archive, argv[first + 1], options, &cout)){
+        cerr << "Could not write " << argv[first + 1] << endl;
+        return 1;
+    }
+    return 0;
+}
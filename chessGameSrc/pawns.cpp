@@ -0,0 +1,127 @@
+#include "../chessGameHeader/pawns.hpp"
+#include "../chessGameHeader/attacks.hpp"
+
+static const Bitboard FILE_A = 0x0101010101010101ULL;
+
+//Bonus for a passed pawn by how far it has come, from its own side's first rank
+static const int passedMidgame[8] = {0, 5, 10, 15, 25, 40, 60, 0};
+static const int passedEndgame[8] = {0, 10, 20, 35, 60, 90, 130, 0};
+
+static const int ISOLATED_MIDGAME = -10;
+static const int ISOLATED_ENDGAME = -15;
+static const int DOUBLED_MIDGAME = -10;
+static const int DOUBLED_ENDGAME = -20;
+static const int BACKWARD_MIDGAME = -8;
+static const int BACKWARD_ENDGAME = -10;
+
+static Bitboard fileMask(int file){
+    return FILE_A << file;
+}
+
+static Bitboard adjacentFiles(int file){
+    return (file > 0 ? fileMask(file - 1) : 0) | (file < 7 ? fileMask(file + 1) : 0);
+}
+
+//Every square on ranks strictly in front of sq, from col's point of view
+static Bitboard ranksInFront(Color col, int sq){
+    int rank = sq >> 3;
+    if (col == Color::White){
+        return rank == 7 ? 0 : ~0ULL << ((rank + 1) * 8);
+    }
+    return rank == 0 ? 0 : ~0ULL >> ((8 - rank) * 8);
+}
+
+//Scores one side's pawns from its own point of view
+static void scoreSide(const Position& position, Color col, int& midgame, int& endgame, Bitboard& passed){
+    Color enemy = opposite(col);
+    Bitboard own = position.getPieces(col, PieceType::Pawn);
+    Bitboard theirs = position.getPieces(enemy, PieceType::Pawn);
+    passed = 0;
+
+    for (int file = 0; file < 8; ++file){
+        int count = popCount(own & fileMask(file));
+        if (count > 1){
+            midgame += DOUBLED_MIDGAME * (count - 1);
+            endgame += DOUBLED_ENDGAME * (count - 1);
+        }
+    }
+
+    Bitboard pawns = own;
+    while (pawns){
+        int sq = popLsb(pawns);
+        int file = sq & 7;
+        int relativeRank = col == Color::White ? sq >> 3 : 7 - (sq >> 3);
+        Bitboard front = ranksInFront(col, sq);
+
+        if (!(theirs & front & (fileMask(file) | adjacentFiles(file)))){
+            passed |= squareBit(sq);
+            midgame += passedMidgame[relativeRank];
+            endgame += passedEndgame[relativeRank];
+        }
+
+        if (!(own & adjacentFiles(file))){
+            midgame += ISOLATED_MIDGAME;
+            endgame += ISOLATED_ENDGAME;
+        }
+        //No neighbour level with it or behind it can ever support it, and an enemy
+        //pawn guards the square it would advance to
+        else if (!(own & adjacentFiles(file) & ~front)){
+            int stop = col == Color::White ? sq + 8 : sq - 8;
+            if (stop >= 0 && stop < 64 && (pawnAttacks(col, stop) & theirs)){
+                midgame += BACKWARD_MIDGAME;
+                endgame += BACKWARD_ENDGAME;
+            }
+        }
+    }
+}
+
+void evaluatePawns(const Position& position, PawnEntry& entry){
+    int whiteMidgame = 0, whiteEndgame = 0, blackMidgame = 0, blackEndgame = 0;
+    scoreSide(position, Color::White, whiteMidgame, whiteEndgame, entry.passedPawns[static_cast<int>(Color::White)]);
+    scoreSide(position, Color::Black, blackMidgame, blackEndgame, entry.passedPawns[static_cast<int>(Color::Black)]);
+    entry.key = position.getPawnKey();
+    entry.midgame = whiteMidgame - blackMidgame;
+    entry.endgame = whiteEndgame - blackEndgame;
+}
+
+PawnTable::PawnTable(size_t entryCount) : hits(0), probes(0) {
+    size_t size = 1;
+    while (size * 2 <= entryCount){
+        size *= 2;
+    }
+    entries.resize(size);
+    clear();
+}
+
+void PawnTable::clear(){
+    for (PawnEntry& entry : entries){
+        entry.key = 0;
+        entry.midgame = 0;
+        entry.endgame = 0;
+        entry.passedPawns[0] = 0;
+        entry.passedPawns[1] = 0;
+    }
+    hits = 0;
+    probes = 0;
+}
+
+const PawnEntry& PawnTable::probe(const Position& position){
+    uint64_t key = position.getPawnKey();
+    PawnEntry& entry = entries[key & (entries.size() - 1)];
+    ++probes;
+    //Key 0 means no pawns at all, which is also what an empty slot holds, so it is always worked out
+    if (entry.key == key && key != 0){
+        ++hits;
+        return entry;
+    }
+    evaluatePawns(position, entry);
+    return entry;
+}
+
+uint64_t PawnTable::getHits() const {
+    return hits;
+}
+
+uint64_t PawnTable::getProbes() const {
+    return probes;
+}
@@ -0,0 +1,47 @@
+#include "../chessGameHeader/perft.hpp"
+
+uint64_t perft(Position& position, int depth){
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves);
+    if (depth <= 1){
+        return depth == 1 ? moves.size() : 1;
+    }
+
+    uint64_t nodes = 0;
+    for (const Move& m : moves){
+        UndoState undo;
+        position.makeMove(m, undo);
+        nodes += perft(position, depth - 1);
+        position.unmakeMove(undo);
+    }
+    return nodes;
+}
+
+uint64_t perftDivide(Position& position, int depth, std::ostream& out){
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves);
+
+    uint64_t total = 0;
+    for (const Move& m : moves){
+        UndoState undo;
+        position.makeMove(m, undo);
+        uint64_t nodes = depth > 1 ? perft(position, depth - 1) : 1;
+        position.unmakeMove(undo);
+        total += nodes;
+
+        out << moveToString(m) << ": " << nodes << "\n";
+    }
+    out << "\nMoves: " << moves.size() << "\nNodes: " << total << "\n";
+    return total;
+}
+
+const PerftCase perftSuite[] = {
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL}
+};
+
+const int perftSuiteSize = sizeof(perftSuite) / sizeof(perftSuite[0]);
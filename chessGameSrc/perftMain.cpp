@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "../chessGameHeader/perft.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./perft                      runs the reference suite and checks every count
+//  ./perft <depth> [fen]        counts one position (start position by default)
+//  ./perft divide <depth> [fen] prints the count below every root move
+
+static double secondsSince(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static int runSuite(){
+    uint64_t totalNodes = 0;
+    double totalSeconds = 0;
+    int failures = 0;
+
+    for (int i = 0; i < perftSuiteSize; ++i){
+        const PerftCase& test = perftSuite[i];
+        Position position;
+        position.loadFEN(test.fen);
+
+        auto start = chrono::steady_clock::now();
+        uint64_t nodes = perft(position, test.depth);
+        double seconds = secondsSince(start);
+        totalNodes += nodes;
+        totalSeconds += seconds;
+
+        bool passed = nodes == test.nodes;
+        if (!passed){
+            ++failures;
+        }
+        cout << test.name << " depth " << test.depth << ": " << nodes
+             << (passed ? " ok" : " FAILED, expected ") ;
+        if (!passed){
+            cout << test.nodes;
+        }
+        cout << " (" << static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9)) << " nps)" << endl;
+    }
+
+    cout << endl << "Total nodes: " << totalNodes << endl;
+    cout << "Time: " << totalSeconds << " s" << endl;
+    cout << "Nodes per second: " << static_cast<uint64_t>(totalNodes / (totalSeconds > 0 ? totalSeconds : 1e-9)) << endl;
+    return failures == 0 ? 0 : 1;
+}
+
+int main(int argc, char* argv[]){
+    if (argc < 2){
+        return runSuite();
+    }
+
+    bool divide = strcmp(argv[1], "divide") == 0;
+    int argIndex = divide ? 2 : 1;
+    if (argIndex >= argc){
+        cout << "Please give a depth" << endl;
+        return 1;
+    }
+    int depth = atoi(argv[argIndex]);
+    const char* fen = argIndex + 1 < argc ? argv[argIndex + 1] : perftSuite[0].fen;
+
+    Position position;
+    if (!position.loadFEN(fen)){
+        cout << "Not a valid FEN: " << fen << endl;
+        return 1;
+    }
+
+    auto start = chrono::steady_clock::now();
+    uint64_t nodes = divide ? perftDivide(position, depth, cout) : perft(position, depth);
+    double seconds = secondsSince(start);
+
+    //Divide has already printed the total under its move list
+    if (!divide){
+        cout << "Nodes: " << nodes << endl;
+    }
+    cout << "Time: " << seconds << " s" << endl;
+    cout << "Nodes per second: " << static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9)) << endl;
+    return 0;
+}
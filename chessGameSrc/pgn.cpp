@@ -0,0 +1,663 @@
+#include "../chessGameHeader/pgn.hpp"
+
+#include <cctype>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../chessGameHeader/attacks.hpp"
+
+std::string PgnGame::tag(const std::string& name) const {
+    for (const auto& tag : tags){
+        if (tag.first == name){
+            return tag.second;
+        }
+    }
+    return "";
+}
+
+static GameResult resultFromText(std::string_view text){
+    if (text == "1-0"){
+        return GameResult::WhiteWin;
+    }
+    if (text == "0-1"){
+        return GameResult::BlackWin;
+    }
+    if (text == "1/2-1/2"){
+        return GameResult::Draw;
+    }
+    return GameResult::Unknown;
+}
+
+PgnReader::PgnReader(std::istream& input) : in(input), hasPending(false) {}
+
+//[Name "Value"], with \" and \\ inside the value
+static bool parseTag(const std::string& line, std::pair<std::string, std::string>& tag){
+    size_t open = line.find('[');
+    size_t quote = line.find('"', open);
+    if (quote == std::string::npos){
+        return false;
+    }
+    size_t nameEnd = line.find_first_of(" \t", open);
+    tag.first = line.substr(open + 1, (nameEnd < quote ? nameEnd : quote) - open - 1);
+    tag.second.clear();
+    for (size_t i = quote + 1; i < line.size() && line[i] != '"'; ++i){
+        if (line[i] == '\\' && i + 1 < line.size()){
+            ++i;
+        }
+        tag.second += line[i];
+    }
+    return true;
+}
+
+bool PgnReader::next(PgnGame& game){
+    game.tags.clear();
+    game.movetext.clear();
+    game.result = GameResult::Unknown;
+    bool inMoves = false;
+    bool any = false;
+    std::string line;
+    while (hasPending || std::getline(in, line)){
+        if (hasPending){
+            line.swap(pendingLine);
+            hasPending = false;
+        }
+        if (!line.empty() && line.back() == '\r'){
+            line.pop_back();
+        }
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos){
+            continue;
+        }
+        if (line[start] == '['){
+            //A tag after moves belongs to the next game
+            if (inMoves){
+                pendingLine.swap(line);
+                hasPending = true;
+                break;
+            }
+            std::pair<std::string, std::string> tag;
+            if (parseTag(line, tag)){
+                game.tags.push_back(tag);
+                any = true;
+            }
+            continue;
+        }
+        inMoves = true;
+        any = true;
+        game.movetext.append(line, start, std::string::npos);
+        game.movetext += ' ';
+    }
+    game.result = resultFromText(game.tag("Result"));
+    return any;
+}
+
+//Whether the side to move's king is safe after m, which has to be a pseudo legal move
+static bool keepsKingSafe(const Position& pos, Move m){
+    Color us = pos.getSideToMove();
+    Bitboard king = pos.getPieces(us, PieceType::King);
+    if (!king){
+        return true;
+    }
+    int from = m.getFrom();
+    int to = m.getTo();
+    Bitboard removed = squareBit(to);
+    Bitboard occupied = (pos.getOccupancy() ^ squareBit(from)) | squareBit(to);
+    if (m.isEnPassant()){
+        int captured = us == Color::White ? to - 8 : to + 8;
+        removed = squareBit(captured);
+        occupied ^= removed;
+    }
+    int kingSq = lsb(king) == from ? to : lsb(king);
+    return (pos.attackersTo(kingSq, occupied) & pos.getPieces(opposite(us)) & ~removed) == 0;
+}
+
+//The piece's attack tables give the few squares it can have come from, so only
+//those candidates are checked instead of generating every legal move
+Move parseSan(std::string_view san, const Position& pos){
+    char text[8];
+    int length = 0;
+    for (char c : san){
+        if (c == '+' || c == '#' || c == '!' || c == '?' || c == 'x' || c == '=' || c == '-'){
+            continue;
+        }
+        if (length == 7){
+            return Move();
+        }
+        text[length++] = c;
+    }
+    std::string_view stripped(text, length);
+
+    //Both zeros and letters are seen for castling
+    if (stripped == "OO" || stripped == "00" || stripped == "OOO" || stripped == "000"){
+        int flag = length == 2 ? KING_CASTLE : QUEEN_CASTLE;
+        MoveList moves;
+        pos.generateLegalMoves(pos.getSideToMove(), moves);
+        for (const Move& m : moves){
+            if (m.getFlag() == flag){
+                return m;
+            }
+        }
+        return Move();
+    }
+
+    PieceType piece = PieceType::Pawn;
+    int first = 0;
+    if (length > 0 && std::isupper(static_cast<unsigned char>(text[0]))){
+        piece = pieceTypeFromChar(text[0]);
+        first = 1;
+    }
+    PieceType promotion = PieceType::none;
+    if (length > first && std::isupper(static_cast<unsigned char>(text[length - 1]))){
+        promotion = pieceTypeFromChar(text[--length]);
+    }
+    else if (piece == PieceType::Pawn && length >= 3 && std::strchr("qrbn", text[length - 1]) && std::isdigit(static_cast<unsigned char>(text[length - 2]))){
+        promotion = pieceTypeFromChar(text[--length]);
+    }
+    if (piece == PieceType::none || length < first + 2){
+        return Move();
+    }
+    char toFile = text[length - 2];
+    char toRank = text[length - 1];
+    if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8'){
+        return Move();
+    }
+    int to = (toRank - '1') * 8 + (toFile - 'a');
+    //Whatever is left between the piece and the target square narrows down the source
+    int fromFile = -1, fromRank = -1;
+    for (int i = first; i + 2 < length; ++i){
+        if (text[i] >= 'a' && text[i] <= 'h'){
+            fromFile = text[i] - 'a';
+        }
+        else if (text[i] >= '1' && text[i] <= '8'){
+            fromRank = text[i] - '1';
+        }
+    }
+
+    Color us = pos.getSideToMove();
+    Color them = opposite(us);
+    Bitboard target = squareBit(to);
+    if (pos.getPieces(us) & target){
+        return Move();
+    }
+    bool capture = (pos.getPieces(them) & target) != 0;
+    bool promotes = piece == PieceType::Pawn && (to >> 3) == (us == Color::White ? 7 : 0);
+    if (promotes != (promotion != PieceType::none) || promotion == PieceType::Pawn || promotion == PieceType::King){
+        return Move();
+    }
+
+    int flag = capture ? CAPTURE : QUIET;
+    if (promotes){
+        flag = (capture ? PROMOTION_CAPTURE : PROMOTION) + static_cast<int>(promotion) - static_cast<int>(PieceType::Knight);
+    }
+    Bitboard occupied = pos.getOccupancy();
+    Bitboard candidates = 0;
+    switch (piece){
+        case PieceType::Pawn:
+            if (fromFile >= 0 && fromFile != (to & 7)){
+                candidates = pawnAttacks(them, to) & pos.getPieces(us, PieceType::Pawn);
+                if (!capture){
+                    if (to != pos.getEnPassantSquare()){
+                        return Move();
+                    }
+                    flag = EN_PASSANT;
+                }
+            }
+            else {
+                int back = us == Color::White ? to - 8 : to + 8;
+                if (capture || back < 0 || back > 63){
+                    return Move();
+                }
+                if (pos.getPieces(us, PieceType::Pawn) & squareBit(back)){
+                    candidates = squareBit(back);
+                }
+                else if (!(occupied & squareBit(back)) && (to >> 3) == (us == Color::White ? 3 : 4)){
+                    int start = us == Color::White ? back - 8 : back + 8;
+                    candidates = pos.getPieces(us, PieceType::Pawn) & squareBit(start);
+                    flag = DOUBLE_PAWN_PUSH;
+                }
+            }
+            break;
+        case PieceType::Knight:
+            candidates = knightAttacks(to) & pos.getPieces(us, PieceType::Knight);
+            break;
+        case PieceType::Bishop:
+            candidates = bishopAttacks(to, occupied) & pos.getPieces(us, PieceType::Bishop);
+            break;
+        case PieceType::Rook:
+            candidates = rookAttacks(to, occupied) & pos.getPieces(us, PieceType::Rook);
+            break;
+        case PieceType::Queen:
+            candidates = queenAttacks(to, occupied) & pos.getPieces(us, PieceType::Queen);
+            break;
+        default:
+            candidates = kingAttacks(to) & pos.getPieces(us, PieceType::King);
+            break;
+    }
+
+    Move found;
+    int matches = 0;
+    while (candidates){
+        int from = popLsb(candidates);
+        if ((fromFile >= 0 && (from & 7) != fromFile) || (fromRank >= 0 && (from >> 3) != fromRank)){
+            continue;
+        }
+        Move m(from, to, flag);
+        if (keepsKingSafe(pos, m)){
+            found = m;
+            ++matches;
+        }
+    }
+    return matches == 1 ? found : Move();
+}
+
+std::string moveToSan(Move m, const Position& pos){
+    std::string san;
+    int from = m.getFrom();
+    int to = m.getTo();
+    if (m.isCastle()){
+        san = m.getFlag() == KING_CASTLE ? "O-O" : "O-O-O";
+    }
+    else {
+        PieceType piece = pos.pieceTypeAt(from);
+        if (piece == PieceType::Pawn){
+            if (m.isCapture()){
+                san += static_cast<char>('a' + (from & 7));
+            }
+        }
+        else {
+            san += pieceSymbolTable[makePieceCode(Color::White, piece)];
+            //Another piece of the same kind that can reach the square decides what to add
+            MoveList moves;
+            pos.generateLegalMoves(pos.getSideToMove(), moves);
+            bool ambiguous = false, sameFile = false, sameRank = false;
+            for (const Move& other : moves){
+                if (other.getTo() == to && other.getFrom() != from && pos.pieceTypeAt(other.getFrom()) == piece){
+                    ambiguous = true;
+                    sameFile |= (other.getFrom() & 7) == (from & 7);
+                    sameRank |= (other.getFrom() >> 3) == (from >> 3);
+                }
+            }
+            if (ambiguous && (!sameFile || sameRank)){
+                san += static_cast<char>('a' + (from & 7));
+            }
+            if (ambiguous && sameFile){
+                san += static_cast<char>('1' + (from >> 3));
+            }
+        }
+        if (m.isCapture()){
+            san += 'x';
+        }
+        san += squareToString(to);
+        if (m.isPromotion()){
+            san += '=';
+            san += pieceSymbolTable[makePieceCode(Color::White, m.getPromotion())];
+        }
+    }
+
+    Position after = pos;
+    UndoState undo;
+    after.makeMove(m, undo);
+    if (after.isInCheck(after.getSideToMove())){
+        MoveList replies;
+        after.generateLegalMoves(after.getSideToMove(), replies);
+        san += replies.size() == 0 ? '#' : '+';
+    }
+    return san;
+}
+
+static bool isTokenEnd(char c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '{' || c == '}' || c == '(' || c == ')' || c == ';';
+}
+
+//Shared by both game types, works on views so no token is ever copied
+static bool playGame(std::string_view text, std::string_view fen, Position& pos, std::vector<Move>& moves, int maxPlies){
+    moves.clear();
+    if (fen.empty()){
+        pos.loadFEN(START_FEN);
+    }
+    else {
+        char buffer[FEN_MAX_LENGTH];
+        if (fen.size() >= sizeof(buffer)){
+            return false;
+        }
+        memcpy(buffer, fen.data(), fen.size());
+        buffer[fen.size()] = '\0';
+        if (!pos.loadFEN(buffer)){
+            return false;
+        }
+    }
+    int variationDepth = 0;
+    size_t i = 0;
+    while (i < text.size() && (maxPlies < 0 || static_cast<int>(moves.size()) < maxPlies)){
+        char c = text[i];
+        if (c == '{'){
+            size_t close = text.find('}', i);
+            i = close == std::string_view::npos ? text.size() : close + 1;
+            continue;
+        }
+        if (c == ';'){
+            size_t close = text.find('\n', i);
+            i = close == std::string_view::npos ? text.size() : close + 1;
+            continue;
+        }
+        if (c == '(' || c == ')'){
+            variationDepth += c == '(' ? 1 : -1;
+            ++i;
+            continue;
+        }
+        if (isTokenEnd(c)){
+            ++i;
+            continue;
+        }
+        size_t end = i + 1;
+        while (end < text.size() && !isTokenEnd(text[end])){
+            ++end;
+        }
+        std::string_view token = text.substr(i, end - i);
+        i = end;
+        if (variationDepth > 0 || token[0] == '$' || token == "*" || resultFromText(token) != GameResult::Unknown){
+            continue;
+        }
+        //Move numbers, possibly run into the move as in "12.Nf3" or "12...Nf3"
+        size_t digits = 0;
+        while (digits < token.size() && (std::isdigit(static_cast<unsigned char>(token[digits])) || token[digits] == '.')){
+            ++digits;
+        }
+        if (digits > 0 && (digits == token.size() || token.find('.') != std::string_view::npos)){
+            token.remove_prefix(digits);
+            if (token.empty()){
+                continue;
+            }
+        }
+        Move m = parseSan(token, pos);
+        if (m.isNull()){
+            return false;
+        }
+        UndoState undo;
+        pos.makeMove(m, undo);
+        moves.push_back(m);
+    }
+    return true;
+}
+
+bool playMovetext(const PgnGame& game, Position& pos, std::vector<Move>& moves, int maxPlies){
+    return playGame(game.movetext, game.tag("FEN"), pos, moves, maxPlies);
+}
+
+bool playMovetext(const PgnGameView& game, Position& pos, std::vector<Move>& moves, int maxPlies){
+    return playGame(game.movetext, game.tag("FEN"), pos, moves, maxPlies);
+}
+
+std::string_view PgnGameView::tag(std::string_view name) const {
+    for (const auto& tag : tags){
+        if (tag.first == name){
+            return tag.second;
+        }
+    }
+    return std::string_view();
+}
+
+PgnScanner::PgnScanner(std::string_view text) : textStart(text.data()), cursor(text.data()), textEnd(text.data() + text.size()) {}
+
+static const char* lineEndOf(const char* p, const char* end){
+    const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+    return newline ? newline : end;
+}
+
+static const char* skipBlanks(const char* p, const char* end){
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')){
+        ++p;
+    }
+    return p;
+}
+
+//[Name "Value"] as views, the value keeps its escapes
+static bool parseTagView(const char* p, const char* end, std::pair<std::string_view, std::string_view>& tag){
+    const char* name = ++p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '"'){
+        ++p;
+    }
+    tag.first = std::string_view(name, p - name);
+    const char* quote = static_cast<const char*>(memchr(p, '"', end - p));
+    if (!quote){
+        return false;
+    }
+    const char* value = quote + 1;
+    const char* q = value;
+    while (q < end && *q != '"'){
+        if (*q == '\\' && q + 1 < end){
+            ++q;
+        }
+        ++q;
+    }
+    tag.second = std::string_view(value, q - value);
+    return true;
+}
+
+bool PgnScanner::next(PgnGameView& game){
+    game.tags.clear();
+    game.movetext = std::string_view();
+    game.result = GameResult::Unknown;
+    const char* movesBegin = nullptr;
+    const char* movesEnd = nullptr;
+    bool any = false;
+    //A brace comment can run over lines, and a '[' starting one of them is not a tag
+    bool inComment = false;
+    while (cursor < textEnd){
+        const char* lineEnd = lineEndOf(cursor, textEnd);
+        const char* next = lineEnd < textEnd ? lineEnd + 1 : textEnd;
+        const char* p = skipBlanks(cursor, lineEnd);
+        if (!inComment && (p == lineEnd || *p == '%')){
+            cursor = next;
+            continue;
+        }
+        if (!inComment && *p == '['){
+            //A tag after moves belongs to the next game
+            if (movesBegin){
+                break;
+            }
+            if (!any){
+                game.offset = cursor - textStart;
+                any = true;
+            }
+            std::pair<std::string_view, std::string_view> tag;
+            if (parseTagView(p, lineEnd, tag)){
+                game.tags.push_back(tag);
+            }
+            cursor = next;
+            continue;
+        }
+        if (!any){
+            game.offset = cursor - textStart;
+            any = true;
+        }
+        if (!movesBegin){
+            movesBegin = p;
+        }
+        for (const char* q = p; q < lineEnd; ++q){
+            if (inComment){
+                inComment = *q != '}';
+            }
+            else if (*q == '{'){
+                inComment = true;
+            }
+            else if (*q == ';'){
+                break;
+            }
+        }
+        movesEnd = lineEnd;
+        cursor = next;
+        //The termination marker ends the game even when the next one has no tags
+        if (!inComment){
+            const char* e = lineEnd;
+            while (e > p && std::isspace(static_cast<unsigned char>(e[-1]))){
+                --e;
+            }
+            const char* t = e;
+            while (t > p && !std::isspace(static_cast<unsigned char>(t[-1]))){
+                --t;
+            }
+            std::string_view last(t, e - t);
+            if (last == "*" || resultFromText(last) != GameResult::Unknown){
+                break;
+            }
+        }
+    }
+    if (!any){
+        return false;
+    }
+    if (movesBegin){
+        while (movesEnd > movesBegin && std::isspace(static_cast<unsigned char>(movesEnd[-1]))){
+            --movesEnd;
+        }
+        game.movetext = std::string_view(movesBegin, movesEnd - movesBegin);
+    }
+    game.result = resultFromText(game.tag("Result"));
+    //Without a Result tag the termination marker at the end of the moves says it
+    if (game.result == GameResult::Unknown){
+        size_t last = game.movetext.find_last_of(" \t\n");
+        game.result = resultFromText(last == std::string_view::npos ? game.movetext : game.movetext.substr(last + 1));
+    }
+    return true;
+}
+
+PgnScanner::iterator::iterator(PgnScanner* source) : scanner(source) {
+    ++*this;
+}
+
+PgnScanner::iterator& PgnScanner::iterator::operator++(){
+    if (scanner && !scanner->next(game)){
+        scanner = nullptr;
+    }
+    return *this;
+}
+
+PgnFile::PgnFile() : mapping(nullptr), mappedBytes(0) {}
+
+PgnFile::~PgnFile(){
+    unload();
+}
+
+void PgnFile::unload(){
+    if (mapping){
+        munmap(mapping, mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+}
+
+bool PgnFile::load(const char* path){
+    unload();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0){
+        close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    if (bytes == 0){
+        close(fd);
+        return true;
+    }
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED){
+        return false;
+    }
+    //Games are read front to back, so read ahead as far as the kernel likes
+    madvise(data, bytes, MADV_SEQUENTIAL);
+    mapping = data;
+    mappedBytes = bytes;
+    return true;
+}
+
+std::string_view PgnFile::text() const {
+    return std::string_view(static_cast<const char*>(mapping), mappedBytes);
+}
+
+enum class LineKind {Blank, Tag, Other};
+
+static LineKind lineKind(std::string_view text, size_t lineStart){
+    size_t p = lineStart;
+    while (p < text.size() && (text[p] == ' ' || text[p] == '\t' || text[p] == '\r')){
+        ++p;
+    }
+    if (p == text.size() || text[p] == '\n'){
+        return LineKind::Blank;
+    }
+    if (text[p] != '['){
+        return LineKind::Other;
+    }
+    //Only a whole [Name "Value"] line counts, not a comment line starting with '['
+    size_t last = text.find('\n', p);
+    last = text.find_last_not_of(" \t\r", last == std::string_view::npos ? text.size() - 1 : last - 1);
+    return text[last] == ']' ? LineKind::Tag : LineKind::Other;
+}
+
+//First line at or after from that starts a game: a tag line right after a blank line,
+//where the last line with text on it is not a tag line. Stricter than the scanner, so a
+//comment line starting with '[' is not taken for a game unless it looks exactly like a tag.
+static size_t nextGameStart(std::string_view text, size_t from){
+    size_t line = from;
+    if (line > 0 && text[line - 1] != '\n'){
+        line = text.find('\n', line);
+        if (line == std::string_view::npos){
+            return text.size();
+        }
+        ++line;
+    }
+    LineKind previous = LineKind::Other;
+    bool afterBlank = false;
+    for (size_t back = line; back > 0;){
+        //The line before ends with the newline at back - 1
+        size_t lineStart = back >= 2 ? text.rfind('\n', back - 2) : std::string_view::npos;
+        lineStart = lineStart == std::string_view::npos ? 0 : lineStart + 1;
+        LineKind kind = lineKind(text, lineStart);
+        if (back == line){
+            afterBlank = kind == LineKind::Blank;
+        }
+        if (kind != LineKind::Blank){
+            previous = kind;
+            break;
+        }
+        back = lineStart;
+    }
+    while (line < text.size()){
+        LineKind kind = lineKind(text, line);
+        if (kind == LineKind::Tag && afterBlank && previous != LineKind::Tag){
+            return line;
+        }
+        if (kind != LineKind::Blank){
+            previous = kind;
+        }
+        afterBlank = kind == LineKind::Blank;
+        size_t newline = text.find('\n', line);
+        line = newline == std::string_view::npos ? text.size() : newline + 1;
+    }
+    return text.size();
+}
+
+std::vector<std::string_view> splitAtGames(std::string_view text, int count){
+    std::vector<std::string_view> pieces;
+    size_t pieceStart = 0;
+    for (int i = 1; i < count; ++i){
+        size_t target = text.size() / count * i;
+        size_t boundary = nextGameStart(text, target > pieceStart ? target : pieceStart + 1);
+        if (boundary >= text.size()){
+            break;
+        }
+        pieces.push_back(text.substr(pieceStart, boundary - pieceStart));
+        pieceStart = boundary;
+    }
+    if (pieceStart < text.size() || pieces.empty()){
+        pieces.push_back(text.substr(pieceStart));
+    }
+    return pieces;
+}
@@ -0,0 +1,210 @@
+#include "../chessGameHeader/pgnCheck.hpp"
+#include "../chessGameHeader/boundedQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <thread>
+
+GameVerdict GameChecker::check(const PgnGameView& game, uint64_t index){
+    GameVerdict verdict;
+    verdict.index = index;
+    verdict.offset = game.offset;
+    verdict.status = GameStatus::Ok;
+    verdict.plies = 0;
+
+    std::string_view fen = game.tag("FEN");
+    char start[FEN_MAX_LENGTH];
+    if (fen.empty()){
+        fen = START_FEN;
+    }
+    if (fen.size() >= sizeof(start)){
+        verdict.status = GameStatus::BadStart;
+        return verdict;
+    }
+    memcpy(start, fen.data(), fen.size());
+    start[fen.size()] = '\0';
+    if (!board.loadFEN(start)){
+        verdict.status = GameStatus::BadStart;
+        return verdict;
+    }
+
+    bool complete = playMovetext(game, position, moves);
+    for (const Move& m : moves){
+        MoveList legal;
+        board.generateLegalMoves(board.getPosition().getSideToMove(), legal);
+        if (!legal.contains(m)){
+            verdict.status = GameStatus::IllegalMove;
+            return verdict;
+        }
+        board.makeMove(m);
+        ++verdict.plies;
+    }
+    if (!complete){
+        verdict.status = GameStatus::IllegalMove;
+    }
+    return verdict;
+}
+
+//Whole games for one worker, offsets in the text count from offset
+struct CheckBatch {
+    uint64_t number;
+    uint64_t firstGame;
+    size_t offset;
+    std::string_view text;
+};
+
+struct VerdictBatch {
+    uint64_t number;
+    std::vector<GameVerdict> verdicts;
+};
+
+//Yields while the other stages catch up and sleeps once that has gone on for a while,
+//so an idle stage does not keep a core busy
+static void backOff(int& idle){
+    if (++idle < 64){
+        std::this_thread::yield();
+    }
+    else {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+PgnCheckSummary checkPgn(std::string_view text, const PgnCheckOptions& options,
+                         const std::function<void(const GameVerdict&)>& emit, std::ostream* progress){
+    int threads = options.threads > 0 ? options.threads : 1;
+    size_t batchSize = options.batchSize > 0 ? options.batchSize : 1;
+    BoundedQueue<CheckBatch> work(options.queueSize > 0 ? options.queueSize : 1);
+    BoundedQueue<VerdictBatch> results(options.queueSize > 0 ? options.queueSize : 1);
+    //How far the reader may run ahead of the writer, which bounds the batches the
+    //writer has to hold back while it waits for an earlier one
+    uint64_t window = work.capacity() + results.capacity() + threads;
+    std::atomic<bool> readerDone(false);
+    std::atomic<int> workersLeft(threads);
+    std::atomic<uint64_t> written(0);
+
+    std::thread reader([&](){
+        PgnScanner scanner(text);
+        PgnGameView game;
+        CheckBatch batch = {0, 0, 0, std::string_view()};
+        uint64_t games = 0;
+        size_t inBatch = 0;
+        auto push = [&](size_t end){
+            batch.text = text.substr(batch.offset, end - batch.offset);
+            int idle = 0;
+            while (batch.number >= written.load(std::memory_order_acquire) + window){
+                backOff(idle);
+            }
+            while (!work.tryPush(batch)){
+                backOff(idle);
+            }
+        };
+        while (scanner.next(game)){
+            if (inBatch == batchSize){
+                push(game.offset);
+                batch.number++;
+                batch.firstGame = games;
+                batch.offset = game.offset;
+                inBatch = 0;
+            }
+            ++inBatch;
+            ++games;
+        }
+        if (inBatch > 0){
+            push(text.size());
+        }
+        readerDone.store(true, std::memory_order_release);
+    });
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t){
+        workers.emplace_back([&](){
+            GameChecker checker;
+            PgnGameView game;
+            CheckBatch batch;
+            int idle = 0;
+            for (;;){
+                bool finished = readerDone.load(std::memory_order_acquire);
+                if (!work.tryPop(batch)){
+                    if (finished){
+                        break;
+                    }
+                    backOff(idle);
+                    continue;
+                }
+                idle = 0;
+                VerdictBatch out;
+                out.number = batch.number;
+                out.verdicts.reserve(batchSize);
+                //Offsets in the batch count from its start
+                PgnScanner scanner(batch.text);
+                uint64_t index = batch.firstGame;
+                while (scanner.next(game)){
+                    GameVerdict verdict = checker.check(game, index++);
+                    verdict.offset += batch.offset;
+                    out.verdicts.push_back(verdict);
+                }
+                while (!results.tryPush(out)){
+                    backOff(idle);
+                }
+            }
+            workersLeft.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    //The writer runs here, batches that finish early wait until every one before them is out
+    PgnCheckSummary summary;
+    std::map<uint64_t, std::vector<GameVerdict>> pending;
+    uint64_t nextBatch = 0;
+    size_t bytesDone = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    auto lastReport = startTime;
+    int idle = 0;
+    for (;;){
+        bool finished = workersLeft.load(std::memory_order_acquire) == 0;
+        VerdictBatch batch;
+        if (!results.tryPop(batch)){
+            if (finished){
+                break;
+            }
+            backOff(idle);
+            continue;
+        }
+        idle = 0;
+        pending.emplace(batch.number, std::move(batch.verdicts));
+        while (!pending.empty() && pending.begin()->first == nextBatch){
+            for (const GameVerdict& verdict : pending.begin()->second){
+                emit(verdict);
+                summary.games++;
+                summary.plies += verdict.plies;
+                if (verdict.status != GameStatus::Ok){
+                    summary.failed++;
+                }
+                bytesDone = verdict.offset;
+            }
+            pending.erase(pending.begin());
+            written.store(++nextBatch, std::memory_order_release);
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (progress && now - lastReport >= std::chrono::seconds(1)){
+            double seconds = std::chrono::duration<double>(now - startTime).count();
+            *progress << summary.games << " games, " << bytesDone / 1000000 << " of " << text.size() / 1000000
+                      << " MB, " << static_cast<uint64_t>(summary.games / seconds) << " games/s, "
+                      << summary.failed << " bad" << std::endl;
+            lastReport = now;
+        }
+    }
+
+    reader.join();
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+    if (progress){
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        *progress << summary.games << " games, " << summary.plies << " plies, " << summary.failed << " bad in "
+                  << seconds << " s, " << static_cast<uint64_t>(summary.games / (seconds > 0 ? seconds : 1)) << " games/s" << std::endl;
+    }
+    return summary;
+}
@@ -0,0 +1,76 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "../chessGameHeader/pgnCheck.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./pgnCheck [-threads N] [-errors] <games.pgn>
+//Replays every game and prints a verdict line per game in file order:
+//  <game number> <ok|illegal|badfen> <plies played> <byte offset>
+//For an illegal game the plies column is where it went wrong, -errors leaves out the
+//games that are fine. Progress goes to stderr. Exits with 2 when any game is bad.
+
+static const char* statusName(GameStatus status){
+    switch (status){
+        case GameStatus::Ok: return "ok";
+        case GameStatus::BadStart: return "badfen";
+        default: return "illegal";
+    }
+}
+
+int main(int argc, char* argv[]){
+    PgnCheckOptions options;
+    int cores = static_cast<int>(thread::hardware_concurrency());
+    //The reader and the writer each keep a thread busy part of the time
+    options.threads = cores > 2 ? cores - 1 : 1;
+    bool errorsOnly = false;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i){
+        if (i + 1 < argc && strcmp(argv[i], "-threads") == 0){
+            options.threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-errors") == 0){
+            errorsOnly = true;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (!path){
+        cout << "Usage: ./pgnCheck [-threads N] [-errors] <games.pgn>" << endl;
+        return 1;
+    }
+    PgnFile file;
+    if (!file.load(path)){
+        cerr << "Could not open " << path << endl;
+        return 1;
+    }
+
+    //Lines are gathered and written in large pieces, millions of games make a lot of output
+    string out;
+    PgnCheckSummary summary = checkPgn(file.text(), options, [&](const GameVerdict& verdict){
+        if (errorsOnly && verdict.status == GameStatus::Ok){
+            return;
+        }
+        out += to_string(verdict.index + 1);
+        out += ' ';
+        out += statusName(verdict.status);
+        out += ' ';
+        out += to_string(verdict.plies);
+        out += ' ';
+        out += to_string(verdict.offset);
+        out += '\n';
+        if (out.size() > (1 << 20)){
+            cout.write(out.data(), out.size());
+            out.clear();
+        }
+    }, &cerr);
+    cout.write(out.data(), out.size());
+    cout.flush();
+    return summary.failed > 0 ? 2 : 0;
+}
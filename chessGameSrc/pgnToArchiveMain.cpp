@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "../chessGameHeader/gameArchive.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./pgnToArchive [-onepass] <games.pgn> <games.cga>
+//  ./pgnToArchive -show <games.cga> <game number>
+//The first form converts a PGN file, reading it twice so the move code fits its games
+//unless -onepass is given. The second prints one game of an archive back as PGN.
+
+static const char* resultText(GameResult result){
+    switch (result){
+        case GameResult::WhiteWin: return "1-0";
+        case GameResult::BlackWin: return "0-1";
+        case GameResult::Draw: return "1/2-1/2";
+        default: return "*";
+    }
+}
+
+static int showGame(const char* path, uint64_t n){
+    GameArchive archive;
+    if (!archive.load(path)){
+        cerr << "Could not read " << path << endl;
+        return 1;
+    }
+    ArchiveGame game;
+    if (n < 1 || !archive.readGame(n - 1, game)){
+        cerr << "No game " << n << " in " << path << " (" << archive.size() << " games)" << endl;
+        return 1;
+    }
+    for (const auto& tag : game.tags){
+        cout << "[" << tag.first << " \"";
+        for (char c : tag.second){
+            if (c == '"' || c == '\\'){
+                cout << '\\';
+            }
+            cout << c;
+        }
+        cout << "\"]" << endl;
+    }
+    cout << endl;
+
+    Position pos;
+    string fen = game.tag("FEN");
+    pos.loadFEN(fen.empty() ? START_FEN : fen.c_str());
+    string line;
+    for (const Move& m : game.moves){
+        string token;
+        if (pos.getSideToMove() == Color::White){
+            token = to_string(pos.getFullmoveNumber()) + ". ";
+        }
+        else if (&m == &game.moves.front()){
+            token = to_string(pos.getFullmoveNumber()) + "... ";
+        }
+        token += moveToSan(m, pos);
+        if (line.size() + token.size() > 79){
+            cout << line << endl;
+            line.clear();
+        }
+        line += line.empty() ? token : " " + token;
+        UndoState undo;
+        pos.makeMove(m, undo);
+    }
+    line += line.empty() ? resultText(game.result) : string(" ") + resultText(game.result);
+    cout << line << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    if (argc == 4 && strcmp(argv[1], "-show") == 0){
+        return showGame(argv[2], strtoull(argv[3], nullptr, 10));
+    }
+    bool twoPasses = true;
+    int first = 1;
+    if (argc > 1 && strcmp(argv[1], "-onepass") == 0){
+        twoPasses = false;
+        first = 2;
+    }
+    if (argc - first != 2){
+        cout << "Usage: ./pgnToArchive [-onepass] <games.pgn> <games.cga>" << endl;
+        cout << "       ./pgnToArchive -show <games.cga> <game number>" << endl;
+        return 1;
+    }
+    uint64_t written, skipped;
+    if (!convertPgnToArchive(argv[first], argv[first + 1], twoPasses, written, skipped, &cout)){
+        cerr << "Could not convert " << argv[first] << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,578 @@
+#include "../chessGameHeader/position.hpp"
+#include "../chessGameHeader/attacks.hpp"
+
+//Rights kept after a move touches the square, clears rights when a king or rook moves or a rook is captured
+static const int castlingMask[64] = {
+    ~WHITE_QUEEN_SIDE & ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ~(WHITE_KING_SIDE | WHITE_QUEEN_SIDE) & ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ~WHITE_KING_SIDE & ALL_CASTLING,
+    ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ~BLACK_QUEEN_SIDE & ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ALL_CASTLING,
+    ~(BLACK_KING_SIDE | BLACK_QUEEN_SIDE) & ALL_CASTLING, ALL_CASTLING, ALL_CASTLING, ~BLACK_KING_SIDE & ALL_CASTLING
+};
+
+Position::Position() : network(nullptr) {
+    clear();
+}
+
+void Position::clear(){
+    for (int c = 0; c < 2; ++c){
+        for (int t = 0; t < 6; ++t){
+            pieces[c][t] = 0;
+        }
+        colorOccupancy[c] = 0;
+    }
+    occupancy = 0;
+    for (int sq = 0; sq < 64; ++sq){
+        mailbox[sq] = NO_PIECE;
+    }
+    castlingRights = 0;
+    enPassantSquare = -1;
+    sideToMove = Color::White;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    hashKey = 0;
+    pawnKey = 0;
+    midgameScore = 0;
+    endgameScore = 0;
+    gamePhase = 0;
+    material[0] = 0;
+    material[1] = 0;
+    if (network){
+        network->resetAccumulator(accumulator);
+    }
+}
+
+void Position::addPiece(Color col, PieceType type, int sq){
+    Bitboard bit = squareBit(sq);
+    pieces[static_cast<int>(col)][static_cast<int>(type)] |= bit;
+    colorOccupancy[static_cast<int>(col)] |= bit;
+    occupancy |= bit;
+    PieceCode code = makePieceCode(col, type);
+    mailbox[sq] = code;
+    hashKey ^= zobristPieces[static_cast<int>(col)][static_cast<int>(type)][sq];
+    if (type == PieceType::Pawn){
+        pawnKey ^= zobristPieces[static_cast<int>(col)][0][sq];
+    }
+    midgameScore += midgameTable[code][sq];
+    endgameScore += endgameTable[code][sq];
+    gamePhase += phaseWeight[static_cast<int>(type)];
+    material[static_cast<int>(col)] += pieceValueTable[code];
+    if (network){
+        network->addPiece(accumulator, code, sq);
+    }
+}
+
+void Position::removePiece(Color col, PieceType type, int sq){
+    Bitboard bit = squareBit(sq);
+    pieces[static_cast<int>(col)][static_cast<int>(type)] &= ~bit;
+    colorOccupancy[static_cast<int>(col)] &= ~bit;
+    occupancy &= ~bit;
+    PieceCode code = makePieceCode(col, type);
+    mailbox[sq] = NO_PIECE;
+    hashKey ^= zobristPieces[static_cast<int>(col)][static_cast<int>(type)][sq];
+    if (type == PieceType::Pawn){
+        pawnKey ^= zobristPieces[static_cast<int>(col)][0][sq];
+    }
+    midgameScore -= midgameTable[code][sq];
+    endgameScore -= endgameTable[code][sq];
+    gamePhase -= phaseWeight[static_cast<int>(type)];
+    material[static_cast<int>(col)] -= pieceValueTable[code];
+    if (network){
+        network->removePiece(accumulator, code, sq);
+    }
+}
+
+void Position::movePiece(Color col, PieceType type, int from, int to){
+    //A single xor moves the bit from the source to the target
+    Bitboard fromTo = squareBit(from) | squareBit(to);
+    pieces[static_cast<int>(col)][static_cast<int>(type)] ^= fromTo;
+    colorOccupancy[static_cast<int>(col)] ^= fromTo;
+    occupancy ^= fromTo;
+    PieceCode code = mailbox[from];
+    mailbox[to] = code;
+    mailbox[from] = NO_PIECE;
+    hashKey ^= zobristPieces[static_cast<int>(col)][static_cast<int>(type)][from]
+             ^ zobristPieces[static_cast<int>(col)][static_cast<int>(type)][to];
+    if (type == PieceType::Pawn){
+        pawnKey ^= zobristPieces[static_cast<int>(col)][0][from] ^ zobristPieces[static_cast<int>(col)][0][to];
+    }
+    midgameScore += midgameTable[code][to] - midgameTable[code][from];
+    endgameScore += endgameTable[code][to] - endgameTable[code][from];
+    if (network){
+        network->movePiece(accumulator, code, from, to);
+    }
+}
+
+void Position::addPiece(PieceCode code, int sq){
+    addPiece(pieceColorOf(code), pieceTypeOf(code), sq);
+}
+
+void Position::clearSquare(int sq){
+    if (mailbox[sq] != NO_PIECE){
+        removePiece(colorAt(sq), pieceTypeAt(sq), sq);
+    }
+}
+
+int Position::getCastlingRights() const{
+    return castlingRights;
+}
+
+void Position::setCastlingRights(int rights){
+    hashKey ^= zobristCastling[castlingRights] ^ zobristCastling[rights];
+    castlingRights = rights;
+}
+
+void Position::updateCastlingRights(int from, int to){
+    setCastlingRights(castlingRights & castlingMask[from] & castlingMask[to]);
+}
+
+int Position::getEnPassantSquare() const{
+    return enPassantSquare;
+}
+
+//A double push nobody can answer en passant leaves the same position as a quiet move,
+//so the file only goes into the key when an enemy pawn attacks the square. Goes by the
+//rank rather than sideToMove, makeMove sets the square before it hands over the turn.
+uint64_t Position::enPassantKey() const{
+    if (enPassantSquare < 0){
+        return 0;
+    }
+    Color taker = (enPassantSquare >> 3) == 2 ? Color::Black : Color::White;
+    if (!(pawnAttacks(opposite(taker), enPassantSquare) & getPieces(taker, PieceType::Pawn))){
+        return 0;
+    }
+    return zobristEnPassant[enPassantSquare & 7];
+}
+
+//The pawns must not change while a square is set, makeMove clears it before moving any
+void Position::setEnPassantSquare(int sq){
+    hashKey ^= enPassantKey();
+    enPassantSquare = sq;
+    hashKey ^= enPassantKey();
+}
+
+Color Position::getSideToMove() const{
+    return sideToMove;
+}
+
+void Position::setSideToMove(Color side){
+    if (side != sideToMove){
+        hashKey ^= zobristBlackToMove;
+    }
+    sideToMove = side;
+}
+
+uint64_t Position::getHashKey() const{
+    return hashKey;
+}
+
+//Full recompute, only for setting up a position and for checking the incremental key
+uint64_t Position::computeHashKey() const{
+    uint64_t key = 0;
+    for (int c = 0; c < 2; ++c){
+        for (int t = 0; t < 6; ++t){
+            Bitboard b = pieces[c][t];
+            while (b){
+                key ^= zobristPieces[c][t][popLsb(b)];
+            }
+        }
+    }
+    key ^= zobristCastling[castlingRights];
+    key ^= enPassantKey();
+    if (sideToMove == Color::Black){
+        key ^= zobristBlackToMove;
+    }
+    return key;
+}
+
+int Position::computeEvaluation() const{
+    int midgame = 0;
+    int endgame = 0;
+    int phase = 0;
+    for (int sq = 0; sq < 64; ++sq){
+        PieceCode code = mailbox[sq];
+        if (code != NO_PIECE){
+            midgame += midgameTable[code][sq];
+            endgame += endgameTable[code][sq];
+            phase += phaseWeight[static_cast<int>(pieceTypeOf(code))];
+        }
+    }
+    return taperedScore(midgame, endgame, phase);
+}
+
+int Position::getGamePhase() const{
+    return gamePhase;
+}
+
+int Position::getMaterialBalance() const{
+    return material[static_cast<int>(Color::White)] - material[static_cast<int>(Color::Black)];
+}
+
+int Position::getMaterial(Color col) const{
+    return material[static_cast<int>(col)];
+}
+
+void Position::setNetwork(const Network* net){
+    network = net && net->isLoaded() ? net : nullptr;
+    if (network){
+        network->resetAccumulator(accumulator);
+        for (int sq = 0; sq < 64; ++sq){
+            if (mailbox[sq] != NO_PIECE){
+                network->addPiece(accumulator, mailbox[sq], sq);
+            }
+        }
+    }
+}
+
+const Network* Position::getNetwork() const{
+    return network;
+}
+
+const Accumulator& Position::getAccumulator() const{
+    return accumulator;
+}
+
+uint64_t Position::computePawnKey() const{
+    uint64_t key = 0;
+    for (int c = 0; c < 2; ++c){
+        Bitboard b = pieces[c][0];
+        while (b){
+            key ^= zobristPieces[c][0][popLsb(b)];
+        }
+    }
+    return key;
+}
+
+int Position::getHalfmoveClock() const{
+    return halfmoveClock;
+}
+
+int Position::getFullmoveNumber() const{
+    return fullmoveNumber;
+}
+
+bool Position::hasInsufficientMaterial() const{
+    const Bitboard LIGHT_SQUARES = 0x55AA55AA55AA55AAULL;
+    Bitboard heavy = 0;
+    Bitboard knights = 0;
+    Bitboard bishops = 0;
+    for (Color col : {Color::White, Color::Black}){
+        heavy |= getPieces(col, PieceType::Pawn) | getPieces(col, PieceType::Rook) | getPieces(col, PieceType::Queen);
+        knights |= getPieces(col, PieceType::Knight);
+        bishops |= getPieces(col, PieceType::Bishop);
+    }
+    if (heavy){
+        return false;
+    }
+    if (popCount(knights | bishops) <= 1){
+        return true;
+    }
+    return !knights && ((bishops & LIGHT_SQUARES) == 0 || (bishops & ~LIGHT_SQUARES) == 0);
+}
+
+uint64_t Position::keyAfter(Move m) const{
+    int from = m.getFrom();
+    int to = m.getTo();
+    int us = static_cast<int>(colorAt(from));
+    int moving = static_cast<int>(pieceTypeAt(from));
+    int arriving = m.isPromotion() ? static_cast<int>(m.getPromotion()) : moving;
+
+    uint64_t key = hashKey ^ zobristBlackToMove ^ zobristPieces[us][moving][from] ^ zobristPieces[us][arriving][to];
+    if (isOccupied(to)){
+        key ^= zobristPieces[us ^ 1][static_cast<int>(pieceTypeAt(to))][to];
+    }
+    return key;
+}
+
+void Position::makeMove(Move m, UndoState& undo){
+    int from = m.getFrom();
+    int to = m.getTo();
+    //Go by the piece that moves rather than sideToMove so a board driven square by square stays consistent
+    Color us = colorAt(from);
+    Color them = opposite(us);
+    PieceType moving = pieceTypeAt(from);
+
+    undo.move = m;
+    undo.captured = PieceType::none;
+    undo.enPassantSquare = static_cast<int8_t>(enPassantSquare);
+    undo.castlingRights = static_cast<uint8_t>(castlingRights);
+    undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+    undo.hashKey = hashKey;
+    setEnPassantSquare(-1);
+
+    if (m.isEnPassant()){
+        undo.captured = PieceType::Pawn;
+        removePiece(them, PieceType::Pawn, us == Color::White ? to - 8 : to + 8);
+    }
+    else if (occupancy & squareBit(to)){
+        undo.captured = pieceTypeAt(to);
+        removePiece(them, undo.captured, to);
+    }
+
+    movePiece(us, moving, from, to);
+
+    if (m.isPromotion()){
+        removePiece(us, PieceType::Pawn, to);
+        addPiece(us, m.getPromotion(), to);
+    }
+    else if (m.getFlag() == KING_CASTLE){
+        movePiece(us, PieceType::Rook, from + 3, from + 1);
+    }
+    else if (m.getFlag() == QUEEN_CASTLE){
+        movePiece(us, PieceType::Rook, from - 4, from - 1);
+    }
+
+    halfmoveClock = (moving == PieceType::Pawn || undo.captured != PieceType::none) ? 0 : halfmoveClock + 1;
+    if (us == Color::Black){
+        ++fullmoveNumber;
+    }
+    setEnPassantSquare(m.getFlag() == DOUBLE_PAWN_PUSH ? (from + to) / 2 : -1);
+    updateCastlingRights(from, to);
+    sideToMove = them;
+    hashKey ^= zobristBlackToMove;
+}
+
+void Position::unmakeMove(const UndoState& undo){
+    Move m = undo.move;
+    int from = m.getFrom();
+    int to = m.getTo();
+    Color us = colorAt(to);
+    Color them = opposite(us);
+
+    if (m.isPromotion()){
+        removePiece(us, m.getPromotion(), to);
+        addPiece(us, PieceType::Pawn, to);
+    }
+    else if (m.getFlag() == KING_CASTLE){
+        movePiece(us, PieceType::Rook, from + 1, from + 3);
+    }
+    else if (m.getFlag() == QUEEN_CASTLE){
+        movePiece(us, PieceType::Rook, from - 1, from - 4);
+    }
+
+    movePiece(us, pieceTypeAt(to), to, from);
+
+    if (undo.captured != PieceType::none){
+        int capturedSq = m.isEnPassant() ? (us == Color::White ? to - 8 : to + 8) : to;
+        addPiece(them, undo.captured, capturedSq);
+    }
+
+    if (us == Color::Black){
+        --fullmoveNumber;
+    }
+    halfmoveClock = undo.halfmoveClock;
+    enPassantSquare = undo.enPassantSquare;
+    castlingRights = undo.castlingRights;
+    sideToMove = us;
+    //The piece moves above touched the key, the saved one is the exact previous key anyway
+    hashKey = undo.hashKey;
+}
+
+//Digits at c as a counter, false if there are none or it does not fit
+static bool readCounter(const char*& c, int limit, int& value){
+    if (*c < '0' || *c > '9'){
+        return false;
+    }
+    value = 0;
+    for (; *c >= '0' && *c <= '9'; ++c){
+        value = value * 10 + (*c - '0');
+        if (value > limit){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Position::loadFEN(const char* fen){
+    clear();
+    const char* c = fen;
+
+    //Piece placement, rank 8 first
+    int rank = 7;
+    int file = 0;
+    for (; *c && *c != ' '; ++c){
+        if (*c == '/'){
+            if (file != 8 || rank == 0){
+                return false;
+            }
+            --rank;
+            file = 0;
+        }
+        else if (*c >= '1' && *c <= '8'){
+            file += *c - '0';
+            if (file > 8){
+                return false;
+            }
+        }
+        else {
+            PieceType type = pieceTypeFromChar(*c);
+            if (type == PieceType::none || file > 7){
+                return false;
+            }
+            addPiece((*c >= 'a') ? Color::Black : Color::White, type, rank * 8 + file);
+            ++file;
+        }
+    }
+    if (rank != 0 || file != 8){
+        return false;
+    }
+
+    //Side to move
+    while (*c == ' ') ++c;
+    if (*c == 'b'){
+        sideToMove = Color::Black;
+    }
+    else if (*c != 'w'){
+        return false;
+    }
+    if (*c) ++c;
+
+    //Castling rights
+    while (*c == ' ') ++c;
+    for (; *c && *c != ' '; ++c){
+        switch (*c){
+            case 'K': castlingRights |= WHITE_KING_SIDE; break;
+            case 'Q': castlingRights |= WHITE_QUEEN_SIDE; break;
+            case 'k': castlingRights |= BLACK_KING_SIDE; break;
+            case 'q': castlingRights |= BLACK_QUEEN_SIDE; break;
+            case '-': break;
+            default: return false;
+        }
+    }
+
+    //En passant target
+    while (*c == ' ') ++c;
+    if (*c >= 'a' && *c <= 'h' && c[1] >= '1' && c[1] <= '8'){
+        enPassantSquare = (c[1] - '1') * 8 + (*c - 'a');
+        c += 2;
+    }
+    else if (*c == '-'){
+        ++c;
+    }
+    else if (*c){
+        return false;
+    }
+
+    //Move counters, positions written without them start at 0 and 1
+    while (*c == ' ') ++c;
+    if (*c && !readCounter(c, 0xFFFF, halfmoveClock)){
+        return false;
+    }
+    while (*c == ' ') ++c;
+    if (*c && (!readCounter(c, 1 << 20, fullmoveNumber) || fullmoveNumber == 0)){
+        return false;
+    }
+    while (*c == ' ') ++c;
+    if (*c || !setupIsLegal()){
+        return false;
+    }
+    hashKey = computeHashKey();
+    return true;
+}
+
+//What the move generator relies on: one king each, no pawn on a back rank, the side that
+//just moved not left in check, and an en passant square behind a pawn that just moved two
+bool Position::setupIsLegal() const{
+    for (int c = 0; c < 2; ++c){
+        if (popCount(pieces[c][static_cast<int>(PieceType::King)]) != 1){
+            return false;
+        }
+    }
+    Bitboard backRanks = 0xFFULL | 0xFF00000000000000ULL;
+    if ((getPieces(Color::White, PieceType::Pawn) | getPieces(Color::Black, PieceType::Pawn)) & backRanks){
+        return false;
+    }
+    Color mover = opposite(sideToMove);
+    if (isSquareAttacked(lsb(getPieces(mover, PieceType::King)), sideToMove)){
+        return false;
+    }
+    if (enPassantSquare >= 0){
+        //White to move takes on the sixth rank behind a black pawn, black on the third
+        int rank = sideToMove == Color::White ? 5 : 2;
+        int pawnSq = sideToMove == Color::White ? enPassantSquare - 8 : enPassantSquare + 8;
+        int fromSq = sideToMove == Color::White ? enPassantSquare + 8 : enPassantSquare - 8;
+        if ((enPassantSquare >> 3) != rank || !(getPieces(mover, PieceType::Pawn) & squareBit(pawnSq))
+            || (occupancy & (squareBit(enPassantSquare) | squareBit(fromSq)))){
+            return false;
+        }
+    }
+    return true;
+}
+
+//Writes the digits of a non negative value, returns the end
+static char* writeCounter(char* out, int value){
+    char digits[12];
+    int n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (n > 0){
+        *out++ = digits[--n];
+    }
+    return out;
+}
+
+int Position::writeFEN(char* out) const{
+    char* c = out;
+    for (int rank = 7; rank >= 0; --rank){
+        int empty = 0;
+        for (int file = 0; file < 8; ++file){
+            PieceCode code = mailbox[rank * 8 + file];
+            if (code == NO_PIECE){
+                ++empty;
+                continue;
+            }
+            if (empty > 0){
+                *c++ = static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            *c++ = pieceSymbolTable[code];
+        }
+        if (empty > 0){
+            *c++ = static_cast<char>('0' + empty);
+        }
+        if (rank > 0){
+            *c++ = '/';
+        }
+    }
+
+    *c++ = ' ';
+    *c++ = sideToMove == Color::Black ? 'b' : 'w';
+
+    *c++ = ' ';
+    if (castlingRights == 0){
+        *c++ = '-';
+    }
+    if (castlingRights & WHITE_KING_SIDE) *c++ = 'K';
+    if (castlingRights & WHITE_QUEEN_SIDE) *c++ = 'Q';
+    if (castlingRights & BLACK_KING_SIDE) *c++ = 'k';
+    if (castlingRights & BLACK_QUEEN_SIDE) *c++ = 'q';
+
+    *c++ = ' ';
+    if (enPassantSquare >= 0){
+        *c++ = static_cast<char>('a' + (enPassantSquare & 7));
+        *c++ = static_cast<char>('1' + (enPassantSquare >> 3));
+    }
+    else {
+        *c++ = '-';
+    }
+
+    *c++ = ' ';
+    c = writeCounter(c, halfmoveClock);
+    *c++ = ' ';
+    c = writeCounter(c, fullmoveNumber);
+    *c = '\0';
+    return static_cast<int>(c - out);
+}
+
+std::string Position::toFEN() const{
+    char buffer[FEN_MAX_LENGTH];
+    int length = writeFEN(buffer);
+    return std::string(buffer, length);
+}
@@ -0,0 +1,391 @@
+#include "../chessGameHeader/positionIndex.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char INDEX_MAGIC[4] = {'C', 'G', 'P', 'I'};
+static const char INDEX_FOOTER_MAGIC[4] = {'C', 'G', 'P', 'X'};
+static const uint32_t INDEX_VERSION = 1;
+static const int DIRECTORY_ENTRY_BYTES = 16;
+//Entries read from each run at a time while merging
+static const size_t RUN_BLOCK_ENTRIES = 1 << 16;
+
+struct IndexEntry {
+    uint64_t key;
+    uint32_t game;
+    uint16_t ply;
+};
+
+static bool entryBefore(const IndexEntry& a, const IndexEntry& b){
+    if (a.key != b.key){
+        return a.key < b.key;
+    }
+    if (a.game != b.game){
+        return a.game < b.game;
+    }
+    return a.ply < b.ply;
+}
+
+//Reads a sorted run back a block at a time
+struct RunReader {
+    FILE* file = nullptr;
+    std::vector<IndexEntry> block;
+    size_t next = 0;
+
+    bool read(IndexEntry& entry){
+        if (next == block.size()){
+            block.resize(RUN_BLOCK_ENTRIES);
+            block.resize(fread(block.data(), sizeof(IndexEntry), block.size(), file));
+            next = 0;
+            if (block.empty()){
+                return false;
+            }
+        }
+        entry = block[next++];
+        return true;
+    }
+};
+
+struct MergeHead {
+    IndexEntry entry;
+    size_t run;
+};
+
+//The heap keeps its greatest element on top, so this puts the smallest entry there
+struct MergeOrder {
+    bool operator()(const MergeHead& a, const MergeHead& b) const {
+        return entryBefore(b.entry, a.entry);
+    }
+};
+
+static void putVarint(std::vector<uint8_t>& out, uint64_t value){
+    while (value >= 0x80){
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+//False when the varint runs past end
+static bool getVarint(const unsigned char*& in, const unsigned char* end, uint64_t& value){
+    value = 0;
+    for (int shift = 0; shift < 64 && in < end; shift += 7){
+        uint8_t byte = *in++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)){
+            return true;
+        }
+    }
+    return false;
+}
+
+static void putLittle(std::vector<uint8_t>& out, uint64_t value, int bytes){
+    for (int i = 0; i < bytes; ++i){
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static uint64_t getLittle(const unsigned char* in, int bytes){
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i){
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+static bool writeBytes(FILE* file, const std::vector<uint8_t>& bytes){
+    return fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+}
+
+//Merges the sorted runs into the index. The directory is written to a file of its own
+//while the posting lists stream out and is copied after them at the end.
+static bool mergeRuns(const std::vector<std::string>& runs, const char* indexPath, uint64_t& keys, uint64_t& hits){
+    std::string directoryPath = std::string(indexPath) + ".keys";
+    FILE* out = fopen(indexPath, "wb");
+    FILE* directory = fopen(directoryPath.c_str(), "w+b");
+    std::vector<RunReader> readers(runs.size());
+    bool ok = out && directory;
+    for (size_t r = 0; ok && r < runs.size(); ++r){
+        readers[r].file = fopen(runs[r].c_str(), "rb");
+        ok = readers[r].file != nullptr;
+    }
+
+    std::vector<uint8_t> bytes(INDEX_MAGIC, INDEX_MAGIC + 4);
+    putLittle(bytes, INDEX_VERSION, 4);
+    ok = ok && writeBytes(out, bytes);
+    uint64_t offset = POSITION_INDEX_HEADER_BYTES;
+
+    std::priority_queue<MergeHead, std::vector<MergeHead>, MergeOrder> heap;
+    for (size_t r = 0; ok && r < readers.size(); ++r){
+        MergeHead head = {{0, 0, 0}, r};
+        if (readers[r].read(head.entry)){
+            heap.push(head);
+        }
+    }
+    std::vector<uint8_t> list;
+    std::vector<uint8_t> entry;
+    uint64_t listKey = 0;
+    uint64_t listCount = 0;
+    uint32_t lastGame = 0;
+    auto flush = [&](){
+        bytes.clear();
+        putVarint(bytes, listCount);
+        ok = ok && writeBytes(out, bytes) && writeBytes(out, list);
+        entry.clear();
+        putLittle(entry, listKey, 8);
+        putLittle(entry, offset, 8);
+        ok = ok && writeBytes(directory, entry);
+        offset += bytes.size() + list.size();
+        ++keys;
+        list.clear();
+        listCount = 0;
+    };
+    keys = 0;
+    hits = 0;
+    while (ok && !heap.empty()){
+        MergeHead head = heap.top();
+        heap.pop();
+        if (listCount > 0 && head.entry.key != listKey){
+            flush();
+        }
+        if (listCount == 0){
+            listKey = head.entry.key;
+            lastGame = 0;
+        }
+        putVarint(list, head.entry.game - lastGame);
+        putVarint(list, head.entry.ply);
+        lastGame = head.entry.game;
+        ++listCount;
+        ++hits;
+        if (readers[head.run].read(head.entry)){
+            heap.push(head);
+        }
+    }
+    if (listCount > 0){
+        flush();
+    }
+
+    if (ok){
+        rewind(directory);
+        std::vector<uint8_t> block(1 << 20);
+        size_t got;
+        while (ok && (got = fread(block.data(), 1, block.size(), directory)) > 0){
+            ok = fwrite(block.data(), 1, got, out) == got;
+        }
+        bytes.clear();
+        putLittle(bytes, offset, 8);
+        putLittle(bytes, keys, 8);
+        putLittle(bytes, hits, 8);
+        bytes.insert(bytes.end(), INDEX_FOOTER_MAGIC, INDEX_FOOTER_MAGIC + 4);
+        ok = ok && writeBytes(out, bytes);
+    }
+
+    for (RunReader& reader : readers){
+        if (reader.file){
+            fclose(reader.file);
+        }
+    }
+    if (directory){
+        fclose(directory);
+    }
+    std::remove(directoryPath.c_str());
+    if (out && fclose(out) != 0){
+        ok = false;
+    }
+    return ok;
+}
+
+bool buildPositionIndex(const GameArchive& archive, const char* indexPath,
+                        const PositionIndexOptions& options, std::ostream* log){
+    //Game numbers are stored in 32 bits
+    if (archive.size() > UINT32_MAX){
+        return false;
+    }
+    size_t runEntries = std::max<size_t>(options.runEntries, 1);
+    std::vector<IndexEntry> entries;
+    entries.reserve(std::min<size_t>(runEntries, RUN_BLOCK_ENTRIES * 16));
+    std::vector<std::string> runs;
+    bool ok = true;
+    auto spill = [&](){
+        std::sort(entries.begin(), entries.end(), entryBefore);
+        runs.push_back(std::string(indexPath) + ".run" + std::to_string(runs.size()));
+        FILE* file = fopen(runs.back().c_str(), "wb");
+        if (!file){
+            ok = false;
+            return;
+        }
+        ok = fwrite(entries.data(), sizeof(IndexEntry), entries.size(), file) == entries.size();
+        ok = fclose(file) == 0 && ok;
+        entries.clear();
+    };
+
+    ArchiveGame game;
+    Position pos;
+    uint64_t games = 0;
+    for (uint64_t n = 0; ok && n < archive.size(); ++n){
+        std::string fen;
+        if (!archive.readGame(n, game) || !pos.loadFEN((fen = game.tag("FEN")).empty() ? START_FEN : fen.c_str())){
+            continue;
+        }
+        //The archive stores the ply count in 16 bits, so every ply fits
+        size_t plies = game.moves.size();
+        if (options.maxPlies > 0 && plies > static_cast<size_t>(options.maxPlies)){
+            plies = options.maxPlies;
+        }
+        for (size_t ply = 0; ok; ++ply){
+            entries.push_back({pos.getHashKey(), static_cast<uint32_t>(n), static_cast<uint16_t>(ply)});
+            if (entries.size() == runEntries){
+                spill();
+            }
+            if (ply == plies){
+                break;
+            }
+            UndoState undo;
+            pos.makeMove(game.moves[ply], undo);
+        }
+        ++games;
+    }
+    if (ok && (!entries.empty() || runs.empty())){
+        spill();
+    }
+
+    uint64_t keys = 0;
+    uint64_t hits = 0;
+    ok = ok && mergeRuns(runs, indexPath, keys, hits);
+    for (const std::string& run : runs){
+        std::remove(run.c_str());
+    }
+    if (ok && log){
+        *log << games << " games, " << hits << " positions, " << keys << " distinct, merged from "
+             << runs.size() << " run" << (runs.size() == 1 ? "" : "s") << std::endl;
+    }
+    return ok;
+}
+
+PositionIndex::PositionIndex() : mapping(nullptr), mappedBytes(0), directory(nullptr), keyCount(0), hitCount(0) {}
+
+PositionIndex::~PositionIndex(){
+    unload();
+}
+
+void PositionIndex::unload(){
+    if (mapping){
+        munmap(mapping, mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+    directory = nullptr;
+    keyCount = 0;
+    hitCount = 0;
+}
+
+bool PositionIndex::load(const char* path){
+    unload();
+    int fd = open(path, O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < POSITION_INDEX_HEADER_BYTES + POSITION_INDEX_TRAILER_BYTES){
+        close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED){
+        return false;
+    }
+    //Lookups jump around the file, reading ahead of them would only waste the page cache
+    madvise(data, bytes, MADV_RANDOM);
+
+    const unsigned char* file = static_cast<const unsigned char*>(data);
+    const unsigned char* trailer = file + bytes - POSITION_INDEX_TRAILER_BYTES;
+    uint64_t directoryOffset = getLittle(trailer, 8);
+    uint64_t keys = getLittle(trailer + 8, 8);
+    uint64_t directoryRoom = bytes - POSITION_INDEX_TRAILER_BYTES;
+    if (memcmp(file, INDEX_MAGIC, 4) != 0 || getLittle(file + 4, 4) != INDEX_VERSION
+        || memcmp(trailer + 24, INDEX_FOOTER_MAGIC, 4) != 0
+        || directoryOffset < POSITION_INDEX_HEADER_BYTES || directoryOffset > directoryRoom
+        || keys != (directoryRoom - directoryOffset) / DIRECTORY_ENTRY_BYTES
+        || (directoryRoom - directoryOffset) % DIRECTORY_ENTRY_BYTES != 0){
+        munmap(data, bytes);
+        return false;
+    }
+    mapping = data;
+    mappedBytes = bytes;
+    directory = file + directoryOffset;
+    keyCount = keys;
+    hitCount = getLittle(trailer + 16, 8);
+    return true;
+}
+
+bool PositionIndex::isLoaded() const {
+    return mapping != nullptr;
+}
+
+size_t PositionIndex::size() const {
+    return keyCount;
+}
+
+uint64_t PositionIndex::hits() const {
+    return hitCount;
+}
+
+//Start of the key's posting list, nullptr when the position is not in the index
+const unsigned char* PositionIndex::postings(uint64_t key) const {
+    uint64_t low = 0;
+    uint64_t high = keyCount;
+    while (low < high){
+        uint64_t middle = low + (high - low) / 2;
+        uint64_t found = getLittle(directory + middle * DIRECTORY_ENTRY_BYTES, 8);
+        if (found == key){
+            uint64_t offset = getLittle(directory + middle * DIRECTORY_ENTRY_BYTES + 8, 8);
+            const unsigned char* file = static_cast<const unsigned char*>(mapping);
+            return offset >= POSITION_INDEX_HEADER_BYTES && file + offset < directory ? file + offset : nullptr;
+        }
+        if (found < key){
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t PositionIndex::count(uint64_t key) const {
+    const unsigned char* list = postings(key);
+    uint64_t total = 0;
+    if (!list || !getVarint(list, directory, total)){
+        return 0;
+    }
+    return total;
+}
+
+uint64_t PositionIndex::find(uint64_t key, std::vector<PositionHit>& hits, size_t max) const {
+    hits.clear();
+    const unsigned char* list = postings(key);
+    uint64_t total = 0;
+    if (!list || !getVarint(list, directory, total)){
+        return 0;
+    }
+    uint64_t game = 0;
+    for (uint64_t i = 0; i < total && hits.size() < max; ++i){
+        uint64_t gap, ply;
+        if (!getVarint(list, directory, gap) || !getVarint(list, directory, ply)){
+            break;
+        }
+        game += gap;
+        hits.push_back({static_cast<uint32_t>(game), static_cast<uint16_t>(ply)});
+    }
+    return total;
+}
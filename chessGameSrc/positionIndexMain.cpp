@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "../chessGameHeader/positionIndex.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./positionIndex [-plies N] [-run N] <games.cga> <index.cgp>
+//  ./positionIndex -find <games.cga> <index.cgp> "<FEN>" [max games]
+//The first form indexes every position of an archive made by ./pgnToArchive, sorting
+//N positions in memory at a time. The second lists the games that reach a position.
+
+static const char* resultText(GameResult result){
+    switch (result){
+        case GameResult::WhiteWin: return "1-0";
+        case GameResult::BlackWin: return "0-1";
+        case GameResult::Draw: return "1/2-1/2";
+        default: return "*";
+    }
+}
+
+static int findGames(const char* archivePath, const char* indexPath, const char* fen, size_t max){
+    GameArchive archive;
+    PositionIndex index;
+    if (!archive.load(archivePath) || !index.load(indexPath)){
+        cerr << "Could not read " << archivePath << " and " << indexPath << endl;
+        return 1;
+    }
+    Position pos;
+    if (!pos.loadFEN(fen)){
+        cerr << "Not a valid FEN: " << fen << endl;
+        return 1;
+    }
+    vector<PositionHit> hits;
+    auto start = chrono::steady_clock::now();
+    uint64_t total = index.find(pos, hits, max);
+    double micros = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    cout << total << " hits in " << index.size() << " positions, found in " << micros << " us" << endl;
+
+    ArchiveGame game;
+    for (const PositionHit& hit : hits){
+        if (!archive.readHeader(hit.game, game)){
+            continue;
+        }
+        cout << "game " << hit.game + 1 << ", ply " << hit.ply << ": " << game.tag("White") << " - "
+             << game.tag("Black") << " " << resultText(game.result) << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    if ((argc == 5 || argc == 6) && strcmp(argv[1], "-find") == 0){
+        return findGames(argv[2], argv[3], argv[4], argc == 6 ? strtoul(argv[5], nullptr, 10) : 20);
+    }
+    PositionIndexOptions options;
+    int first = 1;
+    while (first + 1 < argc && argv[first][0] == '-'){
+        if (strcmp(argv[first], "-plies") == 0){
+            options.maxPlies = atoi(argv[first + 1]);
+        }
+        else if (strcmp(argv[first], "-run") == 0){
+            options.runEntries = strtoull(argv[first + 1], nullptr, 10);
+        }
+        else {
+            break;
+        }
+        first += 2;
+    }
+    if (argc - first != 2){
+        cout << "Usage: ./positionIndex [-plies N] [-run N] <games.cga> <index.cgp>" << endl;
+        cout << "       ./positionIndex -find <games.cga> <index.cgp> \"<FEN>\" [max games]" << endl;
+        return 1;
+    }
+    GameArchive archive;
+    if (!archive.load(argv[first])){
+        cerr << "Could not read " << argv[first] << endl;
+        return 1;
+    }
+    if (!buildPositionIndex(archive, argv[first + 1], options, &cout)){
+        cerr << "Could not write " << argv[first + 1] << endl;
+        return 1;
+    }
+    return 0;
+}
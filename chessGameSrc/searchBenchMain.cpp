@@ -0,0 +1,78 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "../chessGameHeader/engine.hpp"
+#include "../chessGameHeader/perft.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./searchBench [max threads] [depth] [hash MB]
+//Searches every perft reference position to a fixed depth with 1, 2, 4, ... threads
+//up to the maximum (all cores by default) and prints time to depth and nodes per
+//second for each thread count next to the single thread numbers.
+
+struct BenchRun {
+    int threads;
+    double seconds;
+    uint64_t nodes;
+};
+
+static BenchRun runBench(int threads, int depth, size_t hashMegabytes){
+    Engine engine(hashMegabytes);
+    engine.setThreads(threads);
+    SearchLimits limits;
+    limits.maxDepth = depth;
+
+    BenchRun run = {threads, 0, 0};
+    for (int i = 0; i < perftSuiteSize; ++i){
+        Position position;
+        position.loadFEN(perftSuite[i].fen);
+        engine.setPosition(position);
+        //Every position starts cold so thread counts are compared on equal terms
+        engine.getTranspositionTable().clear();
+
+        SearchResult result = engine.search(limits);
+        run.seconds += result.seconds;
+        run.nodes += result.nodes;
+    }
+    return run;
+}
+
+int main(int argc, char* argv[]){
+    int cores = static_cast<int>(thread::hardware_concurrency());
+    int maxThreads = argc > 1 ? atoi(argv[1]) : (cores > 0 ? cores : 1);
+    int depth = argc > 2 ? atoi(argv[2]) : 8;
+    size_t hashMegabytes = argc > 3 ? strtoul(argv[3], nullptr, 10) : 64;
+    if (maxThreads > 32){
+        maxThreads = 32;
+    }
+
+    cout << "Depth " << depth << ", " << hashMegabytes << " MB hash, " << perftSuiteSize << " positions" << endl;
+    cout << setw(8) << "threads" << setw(12) << "time (s)" << setw(14) << "nodes" << setw(14) << "nps"
+         << setw(16) << "time speedup" << setw(14) << "nps speedup" << endl;
+
+    BenchRun single = {1, 0, 0};
+    for (int threads = 1; threads <= maxThreads; ){
+        BenchRun run = runBench(threads, depth, hashMegabytes);
+        if (threads == 1){
+            single = run;
+        }
+        double nps = run.nodes / (run.seconds > 0 ? run.seconds : 1e-9);
+        double singleNps = single.nodes / (single.seconds > 0 ? single.seconds : 1e-9);
+
+        cout << setw(8) << threads << setw(12) << fixed << setprecision(3) << run.seconds
+             << setw(14) << run.nodes << setw(14) << static_cast<uint64_t>(nps)
+             << setw(15) << setprecision(2) << single.seconds / (run.seconds > 0 ? run.seconds : 1e-9) << "x"
+             << setw(13) << nps / singleNps << "x" << endl;
+
+        //Doubling, but the exact maximum is measured too when it is not a power of two
+        if (threads == maxThreads){
+            break;
+        }
+        threads = threads * 2 > maxThreads ? maxThreads : threads * 2;
+    }
+    return 0;
+}
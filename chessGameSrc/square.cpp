@@ -1,8 +1,27 @@
 #include "../chessGameHeader/square.hpp"
+#include "../chessGameHeader/chessBoard.hpp"
 #include <iostream>
-Square::Square() : row(0), col(0), pieceType(nullptr) {}
+Square::Square() : owner(nullptr), row(0), col(0), code(NO_PIECE) {}
 
-Square::Square(int r, int c) : row(r), col(c), pieceType(nullptr) {}
+Square::Square(int r, int c) : owner(nullptr), row(r), col(c), code(NO_PIECE) {}
+
+Square::Square(int r, int c, chessBoard* board) : owner(board), row(r), col(c), code(NO_PIECE) {}
+
+PieceCode Square::currentCode() const {
+   if (owner != nullptr) {
+      return owner->getPieceCode(row, col);
+   }
+   return code;
+}
+
+void Square::storeCode(PieceCode newCode) {
+   if (owner != nullptr) {
+      owner->setPieceCode(row, col, newCode);
+   }
+   else {
+      code = newCode;
+   }
+}
 
 int Square::getRow(){
    return row;
@@ -12,30 +31,39 @@ int Square::getCol(){
    return col;
 }
 
+PieceCode Square::getPieceCode() const {
+   return currentCode();
+}
+
+//Hands out the shared piece for whatever code is stored here
 Piece& Square::getPiece(){
-   if (!pieceType) {
-        throw std::runtime_error("Attempted to access a null piece");
-    }
-    return *(this->pieceType);
+   return pieceFromCode(currentCode());
 }
 
+//The piece is only read for its type and color, the object itself is not kept
 void Square::setPiece(unique_ptr<Piece> p){
    if (!p) {
       cout << "Received null piece in setPiece" << endl;
+      storeCode(NO_PIECE);
+      return;
    }
-      this->clearSquare();
-      pieceType = std::move(p);
-   }
+   storeCode(pieceCodeOf(*p));
+}
 
 bool Square::isEmpty() {
-    return !pieceType;
+    return currentCode() == NO_PIECE;
 }
 
 
 void Square::clearSquare(){
-   this->pieceType.reset();
+   storeCode(NO_PIECE);
 }
 
 unique_ptr<Piece> Square::releasePiece() {
-    return std::move(pieceType);
-}
\ No newline at end of file
+    PieceCode released = currentCode();
+    if (released == NO_PIECE) {
+       return nullptr;
+    }
+    storeCode(NO_PIECE);
+    return makePiece(pieceColorOf(released), pieceTypeOf(released));
+}
@@ -0,0 +1,1046 @@
+#include "../chessGameHeader/syzygy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//Layout and index follow the Syzygy generator. Pieces in the files are 1-6 for white
+//pawn to king and 9-14 for black, the same order as PieceType.
+static const int BLACK_PIECE = 8;
+static const int MAX_TABLE_PIECES = 7;
+
+static const uint8_t WDL_MAGIC[4] = {0x71, 0xE8, 0x23, 0x5D};
+static const uint8_t DTZ_MAGIC[4] = {0xD7, 0x66, 0x0C, 0xA5};
+
+//Per table flags, the low bit of a DTZ table is the side to move it was made for
+enum TableFlag {
+    SIDE_TO_MOVE = 1,
+    MAPPED = 2,
+    WIN_PLIES = 4,
+    LOSS_PLIES = 8,
+    WIDE = 16,
+    SINGLE_VALUE = 128
+};
+
+static const char NAME_LETTERS[6] = {'P', 'N', 'B', 'R', 'Q', 'K'};
+
+static uint16_t readLittle16(const uint8_t* p){
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t readLittle32(const uint8_t* p){
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t readBig32(const uint8_t* p){
+    return __builtin_bswap32(readLittle32(p));
+}
+
+static uint64_t readBig64(const uint8_t* p){
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return __builtin_bswap64(value);
+}
+
+//Rank minus file: 0 on the a1-h8 diagonal, negative below it
+static int offDiagonal(int sq){
+    return (sq >> 3) - (sq & 7);
+}
+
+//Tables the index is built from, the same for every file
+struct Encoding {
+    //b1-h1-h7 triangle to 0..27
+    int mapB1H1H7[64];
+    //a1-d1-d4 triangle to 0..9, the squares on the diagonal last
+    int mapA1D1D4[64];
+    //The 462 king pairs with the first king in the triangle
+    int mapKK[10][64];
+    //binomial[k][n]: ways to pick k of n squares
+    uint64_t binomial[6][64];
+    //a2-h7 to 47..0, the leading pawn is the one with the highest value
+    int mapPawns[64];
+    int leadPawnIdx[6][64];
+    int leadPawnsSize[6][4];
+};
+
+static const Encoding& encoding(){
+    static const Encoding tables = []{
+        Encoding e;
+        memset(&e, 0, sizeof(e));
+        int code = 0;
+        for (int sq = 0; sq < 64; ++sq){
+            if (offDiagonal(sq) < 0){
+                e.mapB1H1H7[sq] = code++;
+            }
+        }
+
+        std::vector<int> diagonal;
+        code = 0;
+        for (int sq = 0; sq < 28; ++sq){
+            if ((sq & 7) > 3){
+                continue;
+            }
+            if (offDiagonal(sq) < 0){
+                e.mapA1D1D4[sq] = code++;
+            }
+            else if (offDiagonal(sq) == 0){
+                diagonal.push_back(sq);
+            }
+        }
+        for (int sq : diagonal){
+            e.mapA1D1D4[sq] = code++;
+        }
+
+        std::vector<std::pair<int, int>> bothOnDiagonal;
+        code = 0;
+        for (int idx = 0; idx < 10; ++idx){
+            for (int first = 0; first < 28; ++first){
+                //Squares outside the triangle are left at 0, which is b1's
+                if ((first & 7) > 3 || e.mapA1D1D4[first] != idx || (idx == 0 && first != 1)){
+                    continue;
+                }
+                for (int second = 0; second < 64; ++second){
+                    int fileGap = (first & 7) - (second & 7), rankGap = (first >> 3) - (second >> 3);
+                    if (fileGap >= -1 && fileGap <= 1 && rankGap >= -1 && rankGap <= 1){
+                        continue;
+                    }
+                    if (offDiagonal(first) == 0 && offDiagonal(second) > 0){
+                        continue;
+                    }
+                    if (offDiagonal(first) == 0 && offDiagonal(second) == 0){
+                        bothOnDiagonal.emplace_back(idx, second);
+                    }
+                    else {
+                        e.mapKK[idx][second] = code++;
+                    }
+                }
+            }
+        }
+        for (const std::pair<int, int>& pair : bothOnDiagonal){
+            e.mapKK[pair.first][pair.second] = code++;
+        }
+
+        e.binomial[0][0] = 1;
+        for (int n = 1; n < 64; ++n){
+            for (int k = 0; k < 6 && k <= n; ++k){
+                e.binomial[k][n] = (k > 0 ? e.binomial[k - 1][n - 1] : 0) + (k < n ? e.binomial[k][n - 1] : 0);
+            }
+        }
+
+        int available = 47;
+        for (int leadPawns = 1; leadPawns <= 5; ++leadPawns){
+            for (int file = 0; file < 4; ++file){
+                int idx = 0;
+                for (int rank = 1; rank <= 6; ++rank){
+                    int sq = rank * 8 + file;
+                    if (leadPawns == 1){
+                        e.mapPawns[sq] = available--;
+                        e.mapPawns[sq ^ 7] = available--;
+                    }
+                    e.leadPawnIdx[leadPawns][sq] = idx;
+                    idx += static_cast<int>(e.binomial[leadPawns - 1][e.mapPawns[sq]]);
+                }
+                e.leadPawnsSize[leadPawns][file] = idx;
+            }
+        }
+        return e;
+    }();
+    return tables;
+}
+
+//How one side (and for pawns one file of the leading pawn) of a table is stored:
+//Huffman coded symbols in fixed size blocks, each symbol standing for a run of values
+//it expands to through a tree of pairs
+struct PairsData {
+    uint8_t flags;
+    int maxSymLen;
+    int minSymLen;
+    uint32_t numBlocks;
+    size_t blockSize;
+    //A sparse index entry every span values
+    size_t span;
+    const uint8_t* lowestSym;
+    //3 bytes per symbol: 12 bits left and 12 bits right, right is 0xFFF for a value
+    const uint8_t* btree;
+    const uint8_t* blockLength;
+    uint32_t blockLengthSize;
+    //6 bytes per entry: block and offset in it of the value at k * span + span / 2
+    const uint8_t* sparseIndex;
+    size_t sparseIndexSize;
+    const uint8_t* data;
+    std::vector<uint64_t> base64;
+    //Values less one that each symbol expands to
+    std::vector<uint8_t> symlen;
+    int pieces[MAX_TABLE_PIECES];
+    uint64_t groupIdx[MAX_TABLE_PIECES + 1];
+    int groupLen[MAX_TABLE_PIECES + 1];
+    //DTZ only: where the win, loss, cursed win and blessed loss value maps start
+    uint16_t mapIdx[4];
+    //Names this PairsData in the block caches, never reused
+    uint64_t cacheId;
+};
+
+static std::atomic<uint64_t> nextCacheId(1);
+
+static int leftSymbol(const PairsData* d, int sym){
+    const uint8_t* lr = d->btree + 3 * sym;
+    return ((lr[1] & 0xF) << 8) | lr[0];
+}
+
+static int rightSymbol(const PairsData* d, int sym){
+    const uint8_t* lr = d->btree + 3 * sym;
+    return (lr[2] << 4) | (lr[1] >> 4);
+}
+
+//One .rtbw or .rtbz file, mapped on first use
+struct TableFile {
+    std::string path;
+    std::atomic<bool> ready;
+    void* mapping;
+    size_t mappedBytes;
+    //DTZ value maps
+    const uint8_t* map;
+    //[side to move][file of the leading pawn], a single side for DTZ
+    PairsData items[2][4];
+
+    TableFile() : ready(false), mapping(nullptr), mappedBytes(0), map(nullptr) {}
+};
+
+struct SyzygyTable {
+    //Material with the first side in the file name as white, and the colors swapped
+    uint64_t key;
+    uint64_t key2;
+    int pieceCount;
+    bool hasPawns;
+    bool hasUniquePieces;
+    //Pawns of the leading color, the side with fewer pawns, then of the other
+    int pawnCount[2];
+    TableFile wdl;
+    TableFile dtz;
+    std::mutex lock;
+
+    PairsData* get(TableFile& file, int stm, int pawnFile){
+        int side = &file == &wdl ? stm % 2 : 0;
+        return &file.items[side][hasPawns ? pawnFile : 0];
+    }
+};
+
+//Pawns to queens of each side, 4 bits each, first the side given
+static uint64_t materialKey(const int counts[2][6], int first){
+    uint64_t key = 0;
+    for (int side : {first, 1 - first}){
+        for (int type = 0; type < 5; ++type){
+            key = key * 16 + counts[side][type];
+        }
+    }
+    return key;
+}
+
+//Keyed with white as the first side
+static uint64_t materialKey(const Position& pos){
+    int counts[2][6];
+    for (int type = 0; type < 6; ++type){
+        counts[0][type] = popCount(pos.getPieces(Color::White, static_cast<PieceType>(type)));
+        counts[1][type] = popCount(pos.getPieces(Color::Black, static_cast<PieceType>(type)));
+    }
+    return materialKey(counts, 0);
+}
+
+static int sign(int value){
+    return (value > 0) - (value < 0);
+}
+
+static void setGroups(const SyzygyTable& table, PairsData* d, const int order[2], int pawnFile){
+    const Encoding& e = encoding();
+    int n = 0;
+    int firstLen = table.hasPawns ? 0 : table.hasUniquePieces ? 3 : 2;
+    d->groupLen[n] = 1;
+    //Runs of the same piece form a group, after the leading group of kings (and a
+    //third unique piece) or of the leading pawns
+    for (int i = 1; i < table.pieceCount; ++i){
+        if (--firstLen > 0 || d->pieces[i] == d->pieces[i - 1]){
+            d->groupLen[n]++;
+        }
+        else {
+            d->groupLen[++n] = 1;
+        }
+    }
+    d->groupLen[++n] = 0;
+
+    //The file picks the order the groups are multiplied in, the leading group at
+    //order[0] and the other side's pawns at order[1]
+    bool pawnsBothSides = table.hasPawns && table.pawnCount[1];
+    int next = pawnsBothSides ? 2 : 1;
+    int freeSquares = 64 - d->groupLen[0] - (pawnsBothSides ? d->groupLen[1] : 0);
+    uint64_t idx = 1;
+    for (int k = 0; next < n || k == order[0] || k == order[1]; ++k){
+        if (k == order[0]){
+            d->groupIdx[0] = idx;
+            idx *= table.hasPawns ? e.leadPawnsSize[d->groupLen[0]][pawnFile] : table.hasUniquePieces ? 31332 : 462;
+        }
+        else if (k == order[1]){
+            d->groupIdx[1] = idx;
+            idx *= e.binomial[d->groupLen[1]][48 - d->groupLen[0]];
+        }
+        else {
+            d->groupIdx[next] = idx;
+            idx *= e.binomial[d->groupLen[next]][freeSquares];
+            freeSquares -= d->groupLen[next++];
+        }
+    }
+    d->groupIdx[n] = idx;
+}
+
+static uint8_t setSymlen(PairsData* d, int sym, std::vector<bool>& visited){
+    visited[sym] = true;
+    int right = rightSymbol(d, sym);
+    if (right == 0xFFF){
+        return 0;
+    }
+    int left = leftSymbol(d, sym);
+    if (!visited[left]){
+        d->symlen[left] = setSymlen(d, left, visited);
+    }
+    if (!visited[right]){
+        d->symlen[right] = setSymlen(d, right, visited);
+    }
+    return static_cast<uint8_t>(d->symlen[left] + d->symlen[right] + 1);
+}
+
+static const uint8_t* setSizes(PairsData* d, const uint8_t* data){
+    d->flags = *data++;
+    d->cacheId = nextCacheId.fetch_add(1, std::memory_order_relaxed);
+    if (d->flags & SINGLE_VALUE){
+        d->numBlocks = 0;
+        d->span = 0;
+        d->blockLengthSize = 0;
+        d->sparseIndexSize = 0;
+        //The one value every position has
+        d->minSymLen = *data++;
+        return data;
+    }
+
+    uint64_t tableSize = d->groupIdx[std::find(d->groupLen, d->groupLen + MAX_TABLE_PIECES, 0) - d->groupLen];
+    d->blockSize = size_t(1) << *data++;
+    d->span = size_t(1) << *data++;
+    d->sparseIndexSize = static_cast<size_t>((tableSize + d->span - 1) / d->span);
+    int padding = *data++;
+    d->numBlocks = readLittle32(data);
+    data += 4;
+    //Padded so the sparse index never points past the end
+    d->blockLengthSize = d->numBlocks + padding;
+    d->maxSymLen = *data++;
+    d->minSymLen = *data++;
+    d->lowestSym = data;
+    d->base64.assign(d->maxSymLen - d->minSymLen + 1, 0);
+
+    //Canonical code: longer symbols have lower values, base64[l] is the lowest symbol
+    //of length l + minSymLen padded to 64 bits
+    for (int i = static_cast<int>(d->base64.size()) - 2; i >= 0; --i){
+        d->base64[i] = (d->base64[i + 1] + readLittle16(d->lowestSym + 2 * i) - readLittle16(d->lowestSym + 2 * (i + 1))) / 2;
+    }
+    for (size_t i = 0; i < d->base64.size(); ++i){
+        d->base64[i] <<= 64 - i - d->minSymLen;
+    }
+    data += d->base64.size() * 2;
+
+    d->symlen.assign(readLittle16(data), 0);
+    data += 2;
+    d->btree = data;
+    std::vector<bool> visited(d->symlen.size());
+    for (size_t sym = 0; sym < d->symlen.size(); ++sym){
+        if (!visited[sym]){
+            d->symlen[sym] = setSymlen(d, static_cast<int>(sym), visited);
+        }
+    }
+    return data + d->symlen.size() * 3 + (d->symlen.size() & 1);
+}
+
+static const uint8_t* setDtzMap(SyzygyTable& table, const uint8_t* data, int maxFile){
+    TableFile& file = table.dtz;
+    file.map = data;
+    for (int f = 0; f <= maxFile; ++f){
+        PairsData* d = table.get(file, 0, f);
+        if (!(d->flags & MAPPED)){
+            continue;
+        }
+        if (d->flags & WIDE){
+            data += reinterpret_cast<uintptr_t>(data) & 1;
+            for (int i = 0; i < 4; ++i){
+                d->mapIdx[i] = static_cast<uint16_t>((data - file.map) / 2 + 1);
+                data += 2 * readLittle16(data) + 2;
+            }
+        }
+        else {
+            for (int i = 0; i < 4; ++i){
+                d->mapIdx[i] = static_cast<uint16_t>(data - file.map + 1);
+                data += *data + 1;
+            }
+        }
+    }
+    return data + (reinterpret_cast<uintptr_t>(data) & 1);
+}
+
+//Reads the file's description of how each side and file is stored. False when the
+//file does not describe the material it is named after or is cut short.
+static bool setup(SyzygyTable& table, TableFile& file, const uint8_t* data, const uint8_t* end){
+    bool dtz = &file == &table.dtz;
+    bool split = (*data & 1) != 0;
+    if (((*data & 2) != 0) != table.hasPawns || (!dtz && split != (table.key != table.key2))){
+        return false;
+    }
+    data++;
+
+    int sides = !dtz && table.key != table.key2 ? 2 : 1;
+    int maxFile = table.hasPawns ? 3 : 0;
+    bool pawnsBothSides = table.hasPawns && table.pawnCount[1];
+    for (int f = 0; f <= maxFile; ++f){
+        for (int i = 0; i < sides; ++i){
+            *table.get(file, i, f) = PairsData();
+        }
+        int order[2][2] = {{*data & 0xF, pawnsBothSides ? *(data + 1) & 0xF : 0xF},
+                           {*data >> 4, pawnsBothSides ? *(data + 1) >> 4 : 0xF}};
+        data += 1 + pawnsBothSides;
+        for (int k = 0; k < table.pieceCount; ++k, ++data){
+            for (int i = 0; i < sides; ++i){
+                table.get(file, i, f)->pieces[k] = i ? *data >> 4 : *data & 0xF;
+            }
+        }
+        for (int i = 0; i < sides; ++i){
+            setGroups(table, table.get(file, i, f), order[i], f);
+        }
+    }
+    data += reinterpret_cast<uintptr_t>(data) & 1;
+
+    for (int f = 0; f <= maxFile; ++f){
+        for (int i = 0; i < sides; ++i){
+            data = setSizes(table.get(file, i, f), data);
+        }
+    }
+    if (dtz){
+        data = setDtzMap(table, data, maxFile);
+    }
+    for (int f = 0; f <= maxFile; ++f){
+        for (int i = 0; i < sides; ++i){
+            PairsData* d = table.get(file, i, f);
+            d->sparseIndex = data;
+            data += d->sparseIndexSize * 6;
+        }
+    }
+    for (int f = 0; f <= maxFile; ++f){
+        for (int i = 0; i < sides; ++i){
+            PairsData* d = table.get(file, i, f);
+            d->blockLength = data;
+            data += d->blockLengthSize * 2;
+        }
+    }
+    for (int f = 0; f <= maxFile; ++f){
+        for (int i = 0; i < sides; ++i){
+            PairsData* d = table.get(file, i, f);
+            data = reinterpret_cast<const uint8_t*>((reinterpret_cast<uintptr_t>(data) + 0x3F) & ~uintptr_t(0x3F));
+            d->data = data;
+            data += static_cast<size_t>(d->numBlocks) * d->blockSize;
+        }
+    }
+    return data <= end;
+}
+
+//Maps the file the first time any thread needs it, false when it is missing or broken
+static bool mapped(SyzygyTable& table, TableFile& file){
+    if (file.ready.load(std::memory_order_acquire)){
+        return file.mapping != nullptr;
+    }
+    std::lock_guard<std::mutex> guard(table.lock);
+    if (file.ready.load(std::memory_order_relaxed)){
+        return file.mapping != nullptr;
+    }
+    int fd = open(file.path.c_str(), O_RDONLY);
+    struct stat info;
+    void* data = MAP_FAILED;
+    //Every file ends 16 bytes past a multiple of 64
+    if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size % 64 == 16){
+        data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    if (fd >= 0){
+        close(fd);
+    }
+    if (data != MAP_FAILED){
+        madvise(data, static_cast<size_t>(info.st_size), MADV_RANDOM);
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        if (memcmp(bytes, &file == &table.dtz ? DTZ_MAGIC : WDL_MAGIC, 4) == 0 && setup(table, file, bytes + 4, bytes + info.st_size)){
+            file.mapping = data;
+            file.mappedBytes = static_cast<size_t>(info.st_size);
+        }
+        else {
+            munmap(data, static_cast<size_t>(info.st_size));
+        }
+    }
+    file.ready.store(true, std::memory_order_release);
+    return file.mapping != nullptr;
+}
+
+//Huffman symbols of one block read so far. Finding a value means walking the symbols
+//of its block from the start, so each thread keeps the walks of its latest blocks and
+//goes on from where one stopped.
+struct DecodedBlock {
+    uint64_t owner;
+    uint32_t block;
+    uint64_t lastUse;
+    std::vector<uint16_t> symbols;
+    //Offset one past the last value of each symbol
+    std::vector<int> ends;
+    const uint8_t* next;
+    uint64_t buffer;
+    int bufferBits;
+};
+
+static const int BLOCK_CACHE_SLOTS = 16;
+
+struct BlockCache {
+    DecodedBlock slots[BLOCK_CACHE_SLOTS];
+    uint64_t clock;
+};
+
+static thread_local BlockCache blockCache;
+
+static int readSymbol(const PairsData* d, DecodedBlock& walk){
+    //Symbol length from the padded lowest symbol of each length
+    int len = 0;
+    while (walk.buffer < d->base64[len]){
+        ++len;
+    }
+    int sym = static_cast<int>((walk.buffer - d->base64[len]) >> (64 - len - d->minSymLen));
+    sym += readLittle16(d->lowestSym + 2 * len);
+    len += d->minSymLen;
+    walk.buffer <<= len;
+    walk.bufferBits -= len;
+    if (walk.bufferBits <= 32){
+        walk.bufferBits += 32;
+        walk.buffer |= static_cast<uint64_t>(readBig32(walk.next)) << (64 - walk.bufferBits);
+        walk.next += 4;
+    }
+    return sym;
+}
+
+//Symbol holding the value at offset in the block, offset becomes the value's place in it
+static int symbolAt(const PairsData* d, uint32_t block, int& offset){
+    BlockCache& cache = blockCache;
+    DecodedBlock* walk = nullptr;
+    for (DecodedBlock& slot : cache.slots){
+        if (slot.owner == d->cacheId && slot.block == block){
+            walk = &slot;
+            break;
+        }
+        if (!walk || slot.lastUse < walk->lastUse){
+            walk = &slot;
+        }
+    }
+    if (walk->owner != d->cacheId || walk->block != block){
+        walk->owner = d->cacheId;
+        walk->block = block;
+        walk->symbols.clear();
+        walk->ends.clear();
+        walk->next = d->data + static_cast<uint64_t>(block) * d->blockSize;
+        walk->buffer = readBig64(walk->next);
+        walk->next += 8;
+        walk->bufferBits = 64;
+    }
+    walk->lastUse = ++cache.clock;
+
+    while (walk->ends.empty() || walk->ends.back() <= offset){
+        int sym = readSymbol(d, *walk);
+        int start = walk->ends.empty() ? 0 : walk->ends.back();
+        walk->symbols.push_back(static_cast<uint16_t>(sym));
+        walk->ends.push_back(start + d->symlen[sym] + 1);
+    }
+    size_t i = std::upper_bound(walk->ends.begin(), walk->ends.end(), offset) - walk->ends.begin();
+    offset -= i ? walk->ends[i - 1] : 0;
+    return walk->symbols[i];
+}
+
+static int decompressPairs(const PairsData* d, uint64_t idx){
+    if (d->flags & SINGLE_VALUE){
+        return d->minSymLen;
+    }
+    //Start from the nearest sparse index entry and step to the block holding idx
+    uint32_t k = static_cast<uint32_t>(idx / d->span);
+    uint32_t block = readLittle32(d->sparseIndex + 6 * k);
+    int offset = readLittle16(d->sparseIndex + 6 * k + 4);
+    offset += static_cast<int>(idx % d->span) - static_cast<int>(d->span / 2);
+    while (offset < 0){
+        offset += readLittle16(d->blockLength + 2 * --block) + 1;
+    }
+    while (offset > readLittle16(d->blockLength + 2 * block)){
+        offset -= readLittle16(d->blockLength + 2 * block++) + 1;
+    }
+
+    //Then down the pairs, the values of a pair's left symbol come first
+    int sym = symbolAt(d, block, offset);
+    while (d->symlen[sym]){
+        int left = leftSymbol(d, sym);
+        if (offset < d->symlen[left] + 1){
+            sym = left;
+        }
+        else {
+            offset -= d->symlen[left] + 1;
+            sym = rightSymbol(d, sym);
+        }
+    }
+    return leftSymbol(d, sym);
+}
+
+static int mapDtz(SyzygyTable& table, int pawnFile, int value, WDLScore wdl){
+    static const int WDL_MAP[5] = {1, 3, 0, 2, 0};
+    const PairsData* d = table.get(table.dtz, 0, pawnFile);
+    const uint8_t* map = table.dtz.map;
+    if (d->flags & MAPPED){
+        int start = d->mapIdx[WDL_MAP[static_cast<int>(wdl) + 2]];
+        value = d->flags & WIDE ? readLittle16(map + 2 * (start + value)) : map[start + value];
+    }
+    //Stored in moves unless the flags say plies, cursed results always in moves
+    if ((wdl == WDLScore::Win && !(d->flags & WIN_PLIES)) || (wdl == WDLScore::Loss && !(d->flags & LOSS_PLIES))
+        || wdl == WDLScore::CursedWin || wdl == WDLScore::BlessedLoss){
+        value *= 2;
+    }
+    return value + 1;
+}
+
+enum class ProbeState {Fail, Ok, ChangeSide, ZeroingBestMove};
+
+static int pieceCode(const Position& pos, int sq){
+    return static_cast<int>(pos.pieceTypeAt(sq)) + 1 + (pos.colorAt(sq) == Color::Black ? BLACK_PIECE : 0);
+}
+
+//Value stored for the position: a WDLScore for a WDL file, plies for a DTZ file
+static int probeFile(const Position& pos, SyzygyTable& table, bool dtz, WDLScore wdl, ProbeState& state){
+    const Encoding& e = encoding();
+    TableFile& file = dtz ? table.dtz : table.wdl;
+    auto pawnsBefore = [&e](int a, int b){
+        return e.mapPawns[a] < e.mapPawns[b];
+    };
+
+    //Tables are made with white as the first side in the name, and with both sides the
+    //same only for white to move. Anything else is looked up with the colors swapped.
+    bool blackToMove = pos.getSideToMove() == Color::Black;
+    bool flip = (table.key == table.key2 && blackToMove) || materialKey(pos) != table.key;
+    int flipColor = flip ? BLACK_PIECE : 0;
+    int flipSquares = flip ? 56 : 0;
+    int stm = flip != blackToMove;
+
+    int squares[MAX_TABLE_PIECES];
+    int pieces[MAX_TABLE_PIECES];
+    int size = 0, leadPawnsCount = 0, pawnFile = 0;
+    Bitboard leadPawns = 0;
+    if (table.hasPawns){
+        //Pawns of the leading color come first in every file's piece order
+        int lead = file.items[0][0].pieces[0] ^ flipColor;
+        Bitboard b = leadPawns = pos.getPieces(lead & BLACK_PIECE ? Color::Black : Color::White, PieceType::Pawn);
+        while (b){
+            squares[size++] = popLsb(b) ^ flipSquares;
+        }
+        leadPawnsCount = size;
+        std::swap(squares[0], *std::max_element(squares, squares + leadPawnsCount, pawnsBefore));
+        pawnFile = squares[0] & 7;
+        if (pawnFile > 3){
+            pawnFile = 7 - pawnFile;
+        }
+    }
+
+    //A DTZ file holds one side to move only
+    if (dtz){
+        const PairsData* d = table.get(file, stm, pawnFile);
+        if ((d->flags & SIDE_TO_MOVE) != stm && !(table.key == table.key2 && !table.hasPawns)){
+            state = ProbeState::ChangeSide;
+            return 0;
+        }
+    }
+
+    Bitboard b = pos.getOccupancy() ^ leadPawns;
+    while (b){
+        int sq = popLsb(b);
+        squares[size] = sq ^ flipSquares;
+        pieces[size++] = pieceCode(pos, sq) ^ flipColor;
+    }
+
+    //Same piece order as the file
+    const PairsData* d = table.get(file, stm, pawnFile);
+    for (int i = leadPawnsCount; i < size - 1; ++i){
+        for (int j = i; j < size; ++j){
+            if (d->pieces[i] == pieces[j]){
+                std::swap(pieces[i], pieces[j]);
+                std::swap(squares[i], squares[j]);
+                break;
+            }
+        }
+    }
+
+    //Leading piece or pawn onto files a-d
+    if ((squares[0] & 7) > 3){
+        for (int i = 0; i < size; ++i){
+            squares[i] ^= 7;
+        }
+    }
+
+    uint64_t idx;
+    if (table.hasPawns){
+        idx = e.leadPawnIdx[leadPawnsCount][squares[0]];
+        std::stable_sort(squares + 1, squares + leadPawnsCount, pawnsBefore);
+        for (int i = 1; i < leadPawnsCount; ++i){
+            idx += e.binomial[i][e.mapPawns[squares[i]]];
+        }
+    }
+    else {
+        //Without pawns onto ranks 1-4 and below the diagonal, decided by the first
+        //piece of the leading group that is off the diagonal
+        if ((squares[0] >> 3) > 3){
+            for (int i = 0; i < size; ++i){
+                squares[i] ^= 56;
+            }
+        }
+        for (int i = 0; i < d->groupLen[0]; ++i){
+            if (!offDiagonal(squares[i])){
+                continue;
+            }
+            if (offDiagonal(squares[i]) > 0){
+                for (int j = i; j < size; ++j){
+                    squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+                }
+            }
+            break;
+        }
+
+        if (table.hasUniquePieces){
+            //Three unique pieces together, each later one counted among the squares
+            //the earlier ones leave free
+            int adjust1 = squares[1] > squares[0];
+            int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+            if (offDiagonal(squares[0])){
+                idx = (e.mapA1D1D4[squares[0]] * 63 + (squares[1] - adjust1)) * 62 + squares[2] - adjust2;
+            }
+            else if (offDiagonal(squares[1])){
+                idx = (6 * 63 + (squares[0] >> 3) * 28 + e.mapB1H1H7[squares[1]]) * 62 + squares[2] - adjust2;
+            }
+            else if (offDiagonal(squares[2])){
+                idx = 6 * 63 * 62 + 4 * 28 * 62 + (squares[0] >> 3) * 7 * 28
+                    + ((squares[1] >> 3) - adjust1) * 28 + e.mapB1H1H7[squares[2]];
+            }
+            else {
+                idx = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + (squares[0] >> 3) * 6 * 7
+                    + ((squares[1] >> 3) - adjust1) * 6 + ((squares[2] >> 3) - adjust2);
+            }
+        }
+        else {
+            idx = e.mapKK[e.mapA1D1D4[squares[0]]][squares[1]];
+        }
+    }
+
+    //Every other group as a combination of the squares the earlier groups leave
+    idx *= d->groupIdx[0];
+    int* groupSquares = squares + d->groupLen[0];
+    bool remainingPawns = table.hasPawns && table.pawnCount[1];
+    for (int next = 1; d->groupLen[next]; ++next){
+        std::stable_sort(groupSquares, groupSquares + d->groupLen[next]);
+        uint64_t n = 0;
+        for (int i = 0; i < d->groupLen[next]; ++i){
+            int adjust = static_cast<int>(std::count_if(squares, groupSquares, [&](int sq){
+                return groupSquares[i] > sq;
+            }));
+            n += e.binomial[i + 1][groupSquares[i] - adjust - 8 * remainingPawns];
+        }
+        remainingPawns = false;
+        idx += n * d->groupIdx[next];
+        groupSquares += d->groupLen[next];
+    }
+
+    int value = decompressPairs(d, idx);
+    return dtz ? mapDtz(table, pawnFile, value, wdl) : value - 2;
+}
+
+static int probeTable(const std::map<uint64_t, SyzygyTable*>& tables, const Position& pos, bool dtz, WDLScore wdl, ProbeState& state){
+    //Bare kings are no file
+    if (popCount(pos.getOccupancy()) == 2){
+        return 0;
+    }
+    auto found = tables.find(materialKey(pos));
+    if (found == tables.end() || !mapped(*found->second, dtz ? found->second->dtz : found->second->wdl)){
+        state = ProbeState::Fail;
+        return 0;
+    }
+    return probeFile(pos, *found->second, dtz, wdl, state);
+}
+
+static WDLScore negate(WDLScore score){
+    return static_cast<WDLScore>(-static_cast<int>(score));
+}
+
+static int dtzBeforeZeroing(WDLScore wdl){
+    switch (wdl){
+        case WDLScore::Win: return 1;
+        case WDLScore::CursedWin: return 101;
+        case WDLScore::BlessedLoss: return -101;
+        case WDLScore::Loss: return -1;
+        default: return 0;
+    }
+}
+
+//A file need not hold the right value where a capture (or with zeroingMoves a pawn
+//move) is at least as good, the generator stores whatever compresses best there. So
+//those moves are played out and the best of them and the file's value is the result.
+//state becomes ZeroingBestMove when such a move is the best, the DTZ value is then
+//not stored.
+static WDLScore searchZeroing(const std::map<uint64_t, SyzygyTable*>& tables, Position& pos, bool zeroingMoves, ProbeState& state){
+    WDLScore best = WDLScore::Loss;
+    MoveList moves;
+    pos.generateLegalMoves(pos.getSideToMove(), moves);
+    int searched = 0;
+    for (int i = 0; i < moves.size(); ++i){
+        Move m = moves[i];
+        if (!m.isCapture() && (!zeroingMoves || pos.pieceTypeAt(m.getFrom()) != PieceType::Pawn)){
+            continue;
+        }
+        ++searched;
+        UndoState undo;
+        pos.makeMove(m, undo);
+        WDLScore value = negate(searchZeroing(tables, pos, false, state));
+        pos.unmakeMove(undo);
+        if (state == ProbeState::Fail){
+            return WDLScore::Draw;
+        }
+        if (value > best){
+            best = value;
+            if (value >= WDLScore::Win){
+                state = ProbeState::ZeroingBestMove;
+                return value;
+            }
+        }
+    }
+
+    //With every move already played the file is not needed, and may be wrong
+    bool allSearched = searched && searched == moves.size();
+    WDLScore value = best;
+    if (!allSearched){
+        value = static_cast<WDLScore>(probeTable(tables, pos, false, WDLScore::Draw, state));
+        if (state == ProbeState::Fail){
+            return WDLScore::Draw;
+        }
+    }
+    if (best >= value){
+        state = best > WDLScore::Draw || allSearched ? ProbeState::ZeroingBestMove : ProbeState::Ok;
+        return best;
+    }
+    state = ProbeState::Ok;
+    return value;
+}
+
+static int probeDtzPlies(const std::map<uint64_t, SyzygyTable*>& tables, Position& pos, ProbeState& state){
+    state = ProbeState::Ok;
+    WDLScore wdl = searchZeroing(tables, pos, true, state);
+    if (state == ProbeState::Fail || wdl == WDLScore::Draw){
+        return 0;
+    }
+    if (state == ProbeState::ZeroingBestMove){
+        return dtzBeforeZeroing(wdl);
+    }
+    int dtz = probeTable(tables, pos, true, wdl, state);
+    if (state == ProbeState::Fail){
+        return 0;
+    }
+    if (state != ProbeState::ChangeSide){
+        return (dtz + 100 * (wdl == WDLScore::BlessedLoss || wdl == WDLScore::CursedWin)) * sign(static_cast<int>(wdl));
+    }
+
+    //The file only holds the other side to move, so look one ply ahead
+    int minDtz = 0xFFFF;
+    MoveList moves;
+    pos.generateLegalMoves(pos.getSideToMove(), moves);
+    for (int i = 0; i < moves.size(); ++i){
+        Move m = moves[i];
+        bool zeroing = m.isCapture() || pos.pieceTypeAt(m.getFrom()) == PieceType::Pawn;
+        UndoState undo;
+        pos.makeMove(m, undo);
+        //A zeroing move counts as the move before it, the position after only gives the sign
+        int childDtz = zeroing ? -dtzBeforeZeroing(searchZeroing(tables, pos, false, state)) : -probeDtzPlies(tables, pos, state);
+        if (childDtz == 1 && pos.isInCheck(pos.getSideToMove())){
+            MoveList replies;
+            pos.generateLegalMoves(pos.getSideToMove(), replies);
+            if (replies.size() == 0){
+                minDtz = 1;
+            }
+        }
+        pos.unmakeMove(undo);
+        if (state == ProbeState::Fail){
+            return 0;
+        }
+        if (!zeroing){
+            childDtz += sign(childDtz);
+        }
+        if (childDtz < minDtz && sign(childDtz) == sign(static_cast<int>(wdl))){
+            minDtz = childDtz;
+        }
+    }
+    //No legal move: mated
+    return minDtz == 0xFFFF ? -1 : minDtz;
+}
+
+SyzygyTablebases::SyzygyTablebases() : maxPieces(0) {}
+
+SyzygyTablebases::~SyzygyTablebases(){
+    for (const std::unique_ptr<SyzygyTable>& table : tables){
+        for (TableFile* file : {&table->wdl, &table->dtz}){
+            if (file->mapping){
+                munmap(file->mapping, file->mappedBytes);
+            }
+        }
+    }
+}
+
+//Counts of each side, false for anything but one king each and up to MAX_TABLE_PIECES
+static bool parseName(const std::string& name, int counts[2][6], int& total){
+    memset(counts, 0, sizeof(int) * 12);
+    int side = 0;
+    total = 0;
+    for (char letter : name){
+        if (letter == 'v' && side == 0){
+            side = 1;
+            continue;
+        }
+        const char* found = static_cast<const char*>(memchr(NAME_LETTERS, letter, 6));
+        if (!found){
+            return false;
+        }
+        ++counts[side][found - NAME_LETTERS];
+        ++total;
+    }
+    int king = static_cast<int>(PieceType::King);
+    return side == 1 && counts[0][king] == 1 && counts[1][king] == 1 && total <= MAX_TABLE_PIECES;
+}
+
+int SyzygyTablebases::load(const std::string& paths){
+    int added = 0;
+    size_t begin = 0;
+    while (begin <= paths.size()){
+        size_t end = paths.find(':', begin);
+        end = end == std::string::npos ? paths.size() : end;
+        std::string directory = paths.substr(begin, end - begin);
+        begin = end + 1;
+        DIR* dir = directory.empty() ? nullptr : opendir(directory.c_str());
+        if (!dir){
+            continue;
+        }
+        while (dirent* entry = readdir(dir)){
+            std::string file = entry->d_name;
+            if (file.size() < 5 || file.compare(file.size() - 5, 5, ".rtbw") != 0){
+                continue;
+            }
+            std::string name = file.substr(0, file.size() - 5);
+            int counts[2][6];
+            int total;
+            if (!parseName(name, counts, total) || byMaterial.count(materialKey(counts, 0))){
+                continue;
+            }
+            std::unique_ptr<SyzygyTable> table(new SyzygyTable());
+            table->key = materialKey(counts, 0);
+            table->key2 = materialKey(counts, 1);
+            table->pieceCount = total;
+            int pawn = static_cast<int>(PieceType::Pawn);
+            table->hasPawns = counts[0][pawn] + counts[1][pawn] > 0;
+            table->hasUniquePieces = false;
+            for (int side = 0; side < 2; ++side){
+                for (int type = 0; type < 5; ++type){
+                    table->hasUniquePieces |= counts[side][type] == 1;
+                }
+            }
+            //The side with fewer pawns leads, it compresses better
+            int lead = !counts[1][pawn] || (counts[0][pawn] && counts[1][pawn] >= counts[0][pawn]) ? 0 : 1;
+            table->pawnCount[0] = counts[lead][pawn];
+            table->pawnCount[1] = counts[1 - lead][pawn];
+            table->wdl.path = directory + "/" + file;
+            table->dtz.path = directory + "/" + name + ".rtbz";
+            byMaterial[table->key] = table.get();
+            byMaterial[table->key2] = table.get();
+            maxPieces = total > maxPieces ? total : maxPieces;
+            tables.push_back(std::move(table));
+            ++added;
+        }
+        closedir(dir);
+    }
+    return added;
+}
+
+size_t SyzygyTablebases::size() const {
+    return tables.size();
+}
+
+int SyzygyTablebases::getMaxPieces() const {
+    return maxPieces;
+}
+
+bool SyzygyTablebases::probeWDL(Position& pos, WDLScore& result) const {
+    if (pos.getCastlingRights() != 0 || popCount(pos.getOccupancy()) > maxPieces){
+        return false;
+    }
+    ProbeState state = ProbeState::Ok;
+    result = searchZeroing(byMaterial, pos, false, state);
+    return state != ProbeState::Fail;
+}
+
+bool SyzygyTablebases::probeDTZ(Position& pos, int& dtz) const {
+    if (pos.getCastlingRights() != 0 || popCount(pos.getOccupancy()) > maxPieces){
+        return false;
+    }
+    ProbeState state;
+    dtz = probeDtzPlies(byMaterial, pos, state);
+    return state != ProbeState::Fail;
+}
+
+bool SyzygyTablebases::probeRoot(Position& pos, Move& best, WDLScore& result) const {
+    if (!probeWDL(pos, result)){
+        return false;
+    }
+    int halfmoves = pos.getHalfmoveClock();
+    MoveList moves;
+    pos.generateLegalMoves(pos.getSideToMove(), moves);
+    //Wins inside the fifty move rule, other wins, draws, losses the rule saves, then
+    //the rest. Among equals the quickest win or the slowest loss.
+    int bestRank = -1, bestDtz = 0;
+    for (int i = 0; i < moves.size(); ++i){
+        UndoState undo;
+        ProbeState state = ProbeState::Ok;
+        int dtz;
+        pos.makeMove(moves[i], undo);
+        if (pos.getHalfmoveClock() == 0){
+            dtz = dtzBeforeZeroing(negate(searchZeroing(byMaterial, pos, false, state)));
+        }
+        else {
+            dtz = -probeDtzPlies(byMaterial, pos, state);
+            dtz += sign(dtz);
+        }
+        if (dtz == 2 && pos.isInCheck(pos.getSideToMove())){
+            MoveList replies;
+            pos.generateLegalMoves(pos.getSideToMove(), replies);
+            dtz = replies.size() == 0 ? 1 : dtz;
+        }
+        pos.unmakeMove(undo);
+        if (state == ProbeState::Fail){
+            return false;
+        }
+        int rank = dtz > 0 ? (dtz + halfmoves <= 99 ? 4 : 3) : dtz == 0 ? 2 : -dtz * 2 + halfmoves >= 100 ? 1 : 0;
+        if (rank > bestRank || (rank == bestRank && dtz < bestDtz)){
+            bestRank = rank;
+            bestDtz = dtz;
+            best = moves[i];
+        }
+    }
+    return bestRank >= 0;
+}
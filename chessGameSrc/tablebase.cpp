@@ -0,0 +1,959 @@
+#include "../chessGameHeader/tablebase.hpp"
+#include "../chessGameHeader/attacks.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char TABLE_MAGIC[4] = {'C', 'G', 'T', 'B'};
+static const uint32_t TABLE_VERSION = 2;
+static const size_t HEADER_BYTES = 32;
+static const size_t NAME_OFFSET = 16;
+
+//A value byte is 0 for a draw, 255 for an index that is not a legal position and
+//otherwise 1 + plies to mate: odd plies when the side to move mates, even when it is mated
+static const uint8_t VALUE_DRAW = 0;
+static const uint8_t VALUE_ILLEGAL = 255;
+static const int MAX_PLIES = 253;
+
+static const int PAWN = static_cast<int>(PieceType::Pawn);
+static const int KNIGHT = static_cast<int>(PieceType::Knight);
+static const int BISHOP = static_cast<int>(PieceType::Bishop);
+static const int ROOK = static_cast<int>(PieceType::Rook);
+static const int QUEEN = static_cast<int>(PieceType::Queen);
+static const int KING = static_cast<int>(PieceType::King);
+
+//Order of the pieces in a name and in the index, strongest first
+static const int NAME_ORDER[6] = {KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN};
+static const char NAME_LETTERS[6] = {'K', 'Q', 'R', 'B', 'N', 'P'};
+//Only decides which side's pieces come first, indexed by piece type
+static const int SIDE_VALUE[6] = {100, 320, 330, 500, 900, 0};
+
+static uint8_t encodeValue(int plies){
+    return static_cast<uint8_t>(plies + 1);
+}
+
+static std::string sideName(const int counts[6]){
+    std::string name;
+    for (int i = 0; i < 6; ++i){
+        name.append(counts[NAME_ORDER[i]], NAME_LETTERS[i]);
+    }
+    return name;
+}
+
+//True when white's pieces are the ones that go first in the name and the index
+static bool whiteGoesFirst(const int white[6], const int black[6]){
+    int whiteValue = 0, blackValue = 0;
+    for (int type = 0; type < 6; ++type){
+        whiteValue += white[type] * SIDE_VALUE[type];
+        blackValue += black[type] * SIDE_VALUE[type];
+    }
+    if (whiteValue != blackValue){
+        return whiteValue > blackValue;
+    }
+    return sideName(white) >= sideName(black);
+}
+
+static std::string nameOf(const int white[6], const int black[6]){
+    if (whiteGoesFirst(white, black)){
+        return sideName(white) + "v" + sideName(black);
+    }
+    return sideName(black) + "v" + sideName(white);
+}
+
+//Counts of each side in the name's order, false for anything but one king and up to
+//TB_MAX_PIECES pieces in all
+static bool parseName(const std::string& name, int counts[2][6]){
+    memset(counts, 0, sizeof(int) * 12);
+    int side = 0;
+    int total = 0;
+    for (char letter : name){
+        if (letter == 'v' && side == 0){
+            side = 1;
+            continue;
+        }
+        const char* found = static_cast<const char*>(memchr(NAME_LETTERS, letter, 6));
+        if (!found){
+            return false;
+        }
+        ++counts[side][NAME_ORDER[found - NAME_LETTERS]];
+        ++total;
+    }
+    return side == 1 && counts[0][KING] == 1 && counts[1][KING] == 1 && total <= TB_MAX_PIECES;
+}
+
+std::string canonicalTablebaseName(const std::string& name){
+    int counts[2][6];
+    if (!parseName(name, counts)){
+        return "";
+    }
+    return nameOf(counts[0], counts[1]);
+}
+
+static void countPieces(const Bitboard pieces[2][6], int counts[2][6], int& total){
+    total = 0;
+    for (int col = 0; col < 2; ++col){
+        for (int type = 0; type < 6; ++type){
+            counts[col][type] = popCount(pieces[col][type]);
+            total += counts[col][type];
+        }
+    }
+}
+
+std::string tablebaseName(const Position& pos){
+    Bitboard pieces[2][6];
+    for (int col = 0; col < 2; ++col){
+        for (int type = 0; type < 6; ++type){
+            pieces[col][type] = pos.getPieces(static_cast<Color>(col), static_cast<PieceType>(type));
+        }
+    }
+    int counts[2][6];
+    int total;
+    countPieces(pieces, counts, total);
+    if (total > TB_MAX_PIECES){
+        return "";
+    }
+    return nameOf(counts[static_cast<int>(Color::White)], counts[static_cast<int>(Color::Black)]);
+}
+
+//The two kings stand for one number: the pairs that do not touch with the first king on
+//files a-d, and without pawns also on ranks 1-4 below the a1-h8 diagonal (on it with the
+//other king on or below the diagonal). Index 0 without pawns, 1 with.
+struct KingPairs {
+    int16_t index[2][64][64];
+    uint8_t first[2][1806];
+    uint8_t second[2][1806];
+    int count[2];
+};
+
+//Bit 0 mirrors the files, bit 1 the ranks and bit 2 the a1-h8 diagonal, in that order
+static int applySymmetry(int sq, int symmetry){
+    if (symmetry & 1){
+        sq ^= 7;
+    }
+    if (symmetry & 2){
+        sq ^= 56;
+    }
+    if (symmetry & 4){
+        sq = ((sq & 7) << 3) | (sq >> 3);
+    }
+    return sq;
+}
+
+//Symmetry that moves the kings onto one of the pairs above. Pawns only allow the files
+//to be mirrored.
+static int symmetryOf(int first, int second, bool pawns){
+    int symmetry = 0;
+    if ((first & 7) > 3){
+        symmetry |= 1;
+        first ^= 7;
+        second ^= 7;
+    }
+    if (pawns){
+        return symmetry;
+    }
+    if ((first >> 3) > 3){
+        symmetry |= 2;
+        first ^= 56;
+        second ^= 56;
+    }
+    int rank = first >> 3, file = first & 7;
+    if (rank > file || (rank == file && (second >> 3) > (second & 7))){
+        symmetry |= 4;
+    }
+    return symmetry;
+}
+
+static const KingPairs& kingPairs(){
+    static const KingPairs pairs = []{
+        KingPairs built;
+        for (int pawns = 0; pawns < 2; ++pawns){
+            built.count[pawns] = 0;
+            for (int first = 0; first < 64; ++first){
+                for (int second = 0; second < 64; ++second){
+                    int fileGap = (first & 7) - (second & 7), rankGap = (first >> 3) - (second >> 3);
+                    bool touching = fileGap >= -1 && fileGap <= 1 && rankGap >= -1 && rankGap <= 1;
+                    if (touching || symmetryOf(first, second, pawns) != 0){
+                        built.index[pawns][first][second] = -1;
+                        continue;
+                    }
+                    int n = built.count[pawns]++;
+                    built.index[pawns][first][second] = static_cast<int16_t>(n);
+                    built.first[pawns][n] = static_cast<uint8_t>(first);
+                    built.second[pawns][n] = static_cast<uint8_t>(second);
+                }
+            }
+        }
+        return built;
+    }();
+    return pairs;
+}
+
+static bool onDiagonal(int sq){
+    return (sq >> 3) == (sq & 7);
+}
+
+//Side to move first (stronger side first), then the king pair, then a square per other
+//piece: 64 each, 48 for a pawn since it never stands on the first or last rank. Like
+//pieces are stored in ascending square order. With flipped set black plays the role of
+//the side that goes first and the board is mirrored top to bottom.
+static uint64_t indexWith(const Bitboard pieces[2][6], Color sideToMove, bool flipped, int symmetry){
+    Color first = flipped ? Color::Black : Color::White;
+    auto oriented = [flipped](Bitboard b){
+        return flipped ? __builtin_bswap64(b) : b;
+    };
+    bool pawns = (pieces[0][PAWN] | pieces[1][PAWN]) != 0;
+    int firstKing = applySymmetry(lsb(oriented(pieces[static_cast<int>(first)][KING])), symmetry);
+    int secondKing = applySymmetry(lsb(oriented(pieces[static_cast<int>(opposite(first))][KING])), symmetry);
+    const KingPairs& pairs = kingPairs();
+    uint64_t index = (sideToMove == first ? 0 : 1) * pairs.count[pawns] + pairs.index[pawns][firstKing][secondKing];
+    for (int side = 0; side < 2; ++side){
+        int col = static_cast<int>(side == 0 ? first : opposite(first));
+        for (int type : NAME_ORDER){
+            if (type == KING){
+                continue;
+            }
+            int squares[TB_MAX_PIECES];
+            int count = 0;
+            Bitboard b = oriented(pieces[col][type]);
+            while (b){
+                squares[count++] = applySymmetry(popLsb(b), symmetry);
+            }
+            std::sort(squares, squares + count);
+            for (int n = 0; n < count; ++n){
+                index = type == PAWN ? index * 48 + squares[n] - 8 : index * 64 + squares[n];
+            }
+        }
+    }
+    return index;
+}
+
+static uint64_t indexOf(const Bitboard pieces[2][6], Color sideToMove, bool flipped){
+    Color first = flipped ? Color::Black : Color::White;
+    auto oriented = [flipped](Bitboard b){
+        return flipped ? __builtin_bswap64(b) : b;
+    };
+    bool pawns = (pieces[0][PAWN] | pieces[1][PAWN]) != 0;
+    int firstKing = lsb(oriented(pieces[static_cast<int>(first)][KING]));
+    int secondKing = lsb(oriented(pieces[static_cast<int>(opposite(first))][KING]));
+    int symmetry = symmetryOf(firstKing, secondKing, pawns);
+    uint64_t index = indexWith(pieces, sideToMove, flipped, symmetry);
+    //With both kings on the diagonal the board and its reflection in it share the king
+    //pair, the smaller index stands for both
+    if (!pawns && onDiagonal(applySymmetry(firstKing, symmetry)) && onDiagonal(applySymmetry(secondKing, symmetry))){
+        uint64_t reflected = indexWith(pieces, sideToMove, flipped, symmetry | 4);
+        index = reflected < index ? reflected : index;
+    }
+    return index;
+}
+
+//Board used while generating: the bitboards of a position and nothing else
+struct TableBoard {
+    Bitboard pieces[2][6];
+    Bitboard colors[2];
+    Bitboard occupied;
+    Color sideToMove;
+
+    void updateOccupancy(){
+        for (int col = 0; col < 2; ++col){
+            colors[col] = 0;
+            for (int type = 0; type < 6; ++type){
+                colors[col] |= pieces[col][type];
+            }
+        }
+        occupied = colors[0] | colors[1];
+    }
+};
+
+static Bitboard pieceAttacks(int type, int sq, Bitboard occupied){
+    if (type == KNIGHT){
+        return knightAttacks(sq);
+    }
+    if (type == BISHOP){
+        return bishopAttacks(sq, occupied);
+    }
+    if (type == ROOK){
+        return rookAttacks(sq, occupied);
+    }
+    if (type == QUEEN){
+        return queenAttacks(sq, occupied);
+    }
+    return kingAttacks(sq);
+}
+
+static bool isAttacked(const TableBoard& b, int sq, Color by){
+    const Bitboard* p = b.pieces[static_cast<int>(by)];
+    return (pawnAttacks(opposite(by), sq) & p[PAWN])
+        || (knightAttacks(sq) & p[KNIGHT])
+        || (kingAttacks(sq) & p[KING])
+        || (bishopAttacks(sq, b.occupied) & (p[BISHOP] | p[QUEEN]))
+        || (rookAttacks(sq, b.occupied) & (p[ROOK] | p[QUEEN]));
+}
+
+static bool kingAttacked(const TableBoard& b, Color col){
+    return isAttacked(b, lsb(b.pieces[static_cast<int>(col)][KING]), opposite(col));
+}
+
+//Which piece each part of the index stands for, in index order
+struct TableLayout {
+    int pieceCount;
+    int color[TB_MAX_PIECES];
+    int type[TB_MAX_PIECES];
+    //Slot of the second side's king, the first side's is slot 0
+    int secondKing;
+    bool pawns;
+};
+
+static TableLayout layoutOf(const int counts[2][6]){
+    TableLayout layout;
+    layout.pieceCount = 0;
+    layout.secondKing = 0;
+    layout.pawns = counts[0][PAWN] + counts[1][PAWN] > 0;
+    for (int side = 0; side < 2; ++side){
+        for (int type : NAME_ORDER){
+            for (int n = 0; n < counts[side][type]; ++n){
+                if (type == KING && side == 1){
+                    layout.secondKing = layout.pieceCount;
+                }
+                //The side named first is white on the generator's boards
+                layout.color[layout.pieceCount] = static_cast<int>(side == 0 ? Color::White : Color::Black);
+                layout.type[layout.pieceCount] = type;
+                ++layout.pieceCount;
+            }
+        }
+    }
+    return layout;
+}
+
+static size_t tableEntries(const TableLayout& layout){
+    size_t entries = 2 * kingPairs().count[layout.pawns];
+    for (int slot = 0; slot < layout.pieceCount; ++slot){
+        if (layout.type[slot] != KING){
+            entries *= layout.type[slot] == PAWN ? 48 : 64;
+        }
+    }
+    return entries;
+}
+
+//False when the index is no legal position, or is a copy of one with two like pieces
+//swapped or reflected in the diagonal
+static bool decode(const TableLayout& layout, uint64_t index, TableBoard& b){
+    uint64_t original = index;
+    int squares[TB_MAX_PIECES];
+    for (int slot = layout.pieceCount - 1; slot > 0; --slot){
+        if (layout.type[slot] == PAWN){
+            squares[slot] = static_cast<int>(index % 48) + 8;
+            index /= 48;
+        }
+        else if (layout.type[slot] != KING){
+            squares[slot] = static_cast<int>(index & 63);
+            index >>= 6;
+        }
+    }
+    const KingPairs& pairs = kingPairs();
+    int kings = static_cast<int>(index % pairs.count[layout.pawns]);
+    index /= pairs.count[layout.pawns];
+    squares[0] = pairs.first[layout.pawns][kings];
+    squares[layout.secondKing] = pairs.second[layout.pawns][kings];
+    memset(b.pieces, 0, sizeof(b.pieces));
+    b.sideToMove = index == 0 ? Color::White : Color::Black;
+    Bitboard occupied = 0;
+    for (int slot = 0; slot < layout.pieceCount; ++slot){
+        int sq = squares[slot];
+        bool samePiece = slot > 0 && layout.color[slot] == layout.color[slot - 1] && layout.type[slot] == layout.type[slot - 1];
+        if ((samePiece && sq <= squares[slot - 1]) || (occupied & squareBit(sq))){
+            return false;
+        }
+        occupied |= squareBit(sq);
+        b.pieces[layout.color[slot]][layout.type[slot]] |= squareBit(sq);
+    }
+    b.updateOccupancy();
+    if (!layout.pawns && onDiagonal(squares[0]) && onDiagonal(squares[layout.secondKing])
+        && indexOf(b.pieces, b.sideToMove, false) != original){
+        return false;
+    }
+    return !kingAttacked(b, opposite(b.sideToMove));
+}
+
+//Calls visit(child, leavesTable) for each legal move, where leavesTable is set for
+//captures and promotions since those change the material
+template <typename Visit>
+static void forEachMove(const TableBoard& b, Visit visit){
+    int us = static_cast<int>(b.sideToMove);
+    int them = static_cast<int>(opposite(b.sideToMove));
+    for (int type = 0; type < 6; ++type){
+        Bitboard from = b.pieces[us][type];
+        while (from){
+            int sq = popLsb(from);
+            Bitboard targets;
+            if (type == PAWN){
+                int forward = b.sideToMove == Color::White ? 8 : -8;
+                targets = pawnAttacks(b.sideToMove, sq) & b.colors[them];
+                if (!(b.occupied & squareBit(sq + forward))){
+                    targets |= squareBit(sq + forward);
+                    int startRank = b.sideToMove == Color::White ? 1 : 6;
+                    if ((sq >> 3) == startRank && !(b.occupied & squareBit(sq + 2 * forward))){
+                        targets |= squareBit(sq + 2 * forward);
+                    }
+                }
+            }
+            else {
+                targets = pieceAttacks(type, sq, b.occupied) & ~b.colors[us];
+            }
+
+            while (targets){
+                int to = popLsb(targets);
+                TableBoard child = b;
+                bool capture = (b.colors[them] & squareBit(to)) != 0;
+                for (int victim = 0; victim < 6 && capture; ++victim){
+                    child.pieces[them][victim] &= ~squareBit(to);
+                }
+                child.pieces[us][type] ^= squareBit(sq) | squareBit(to);
+                child.updateOccupancy();
+                if (kingAttacked(child, b.sideToMove)){
+                    continue;
+                }
+                child.sideToMove = opposite(b.sideToMove);
+                if (type == PAWN && (to < 8 || to >= 56)){
+                    for (int promotion : {QUEEN, ROOK, BISHOP, KNIGHT}){
+                        TableBoard promoted = child;
+                        promoted.pieces[us][PAWN] ^= squareBit(to);
+                        promoted.pieces[us][promotion] |= squareBit(to);
+                        visit(promoted, true);
+                    }
+                }
+                else {
+                    visit(child, capture);
+                }
+            }
+        }
+    }
+}
+
+//Calls visit(parent) for each legal position one quiet move before b, the moves that
+//stay inside the same table
+template <typename Visit>
+static void forEachUnmove(const TableBoard& b, Visit visit){
+    Color mover = opposite(b.sideToMove);
+    int col = static_cast<int>(mover);
+    for (int type = 0; type < 6; ++type){
+        Bitboard pieces = b.pieces[col][type];
+        while (pieces){
+            int to = popLsb(pieces);
+            Bitboard origins;
+            if (type == PAWN){
+                int back = mover == Color::White ? -8 : 8;
+                int one = to + back;
+                origins = 0;
+                if ((one >> 3) >= 1 && (one >> 3) <= 6 && !(b.occupied & squareBit(one))){
+                    origins = squareBit(one);
+                    int startRank = mover == Color::White ? 1 : 6;
+                    int two = one + back;
+                    if ((two >> 3) == startRank && !(b.occupied & squareBit(two))){
+                        origins |= squareBit(two);
+                    }
+                }
+            }
+            else {
+                origins = pieceAttacks(type, to, b.occupied) & ~b.occupied;
+            }
+
+            while (origins){
+                int from = popLsb(origins);
+                TableBoard parent = b;
+                parent.pieces[col][type] ^= squareBit(from) | squareBit(to);
+                parent.updateOccupancy();
+                parent.sideToMove = mover;
+                if (!kingAttacked(parent, b.sideToMove)){
+                    visit(parent);
+                }
+            }
+        }
+    }
+}
+
+TablebaseFile::TablebaseFile() : mapping(nullptr), mappedBytes(0), values(nullptr), pieceCount(0), longestMate(0) {}
+
+TablebaseFile::~TablebaseFile(){
+    unload();
+}
+
+void TablebaseFile::unload(){
+    if (mapping){
+        munmap(mapping, mappedBytes);
+    }
+    mapping = nullptr;
+    mappedBytes = 0;
+    values = nullptr;
+}
+
+bool TablebaseFile::load(const std::string& path){
+    unload();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0){
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HEADER_BYTES){
+        close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED){
+        return false;
+    }
+
+    const unsigned char* header = static_cast<const unsigned char*>(data);
+    uint32_t version, longest, pieces;
+    memcpy(&version, header + 4, sizeof(version));
+    memcpy(&longest, header + 8, sizeof(longest));
+    memcpy(&pieces, header + 12, sizeof(pieces));
+    std::string storedName(reinterpret_cast<const char*>(header + NAME_OFFSET), strnlen(reinterpret_cast<const char*>(header + NAME_OFFSET), HEADER_BYTES - NAME_OFFSET));
+    int counts[2][6];
+    if (memcmp(header, TABLE_MAGIC, 4) != 0 || version != TABLE_VERSION || pieces > TB_MAX_PIECES
+        || !parseName(storedName, counts) || canonicalTablebaseName(storedName) != storedName
+        || static_cast<int>(pieces) != layoutOf(counts).pieceCount || bytes != HEADER_BYTES + tableEntries(layoutOf(counts))){
+        munmap(data, bytes);
+        return false;
+    }
+
+    mapping = data;
+    mappedBytes = bytes;
+    values = header + HEADER_BYTES;
+    name = storedName;
+    pieceCount = static_cast<int>(pieces);
+    longestMate = static_cast<int>(longest);
+    return true;
+}
+
+const std::string& TablebaseFile::getName() const {
+    return name;
+}
+
+int TablebaseFile::getPieceCount() const {
+    return pieceCount;
+}
+
+int TablebaseFile::getLongestMate() const {
+    return longestMate;
+}
+
+Tablebases::Tablebases() : maxPieces(0) {}
+
+int Tablebases::load(const std::string& directory){
+    DIR* dir = opendir(directory.c_str());
+    if (!dir){
+        return 0;
+    }
+    int added = 0;
+    while (dirent* entry = readdir(dir)){
+        std::string file = entry->d_name;
+        if (file.size() < 5 || file.compare(file.size() - 5, 5, ".cgtb") != 0){
+            continue;
+        }
+        std::unique_ptr<TablebaseFile> table(new TablebaseFile());
+        if (!table->load(directory + "/" + file) || contains(table->getName())){
+            continue;
+        }
+        if (table->getPieceCount() > maxPieces){
+            maxPieces = table->getPieceCount();
+        }
+        tables[table->getName()] = std::move(table);
+        ++added;
+    }
+    closedir(dir);
+    return added;
+}
+
+bool Tablebases::contains(const std::string& name) const {
+    return tables.count(name) != 0;
+}
+
+size_t Tablebases::size() const {
+    return tables.size();
+}
+
+int Tablebases::getMaxPieces() const {
+    return maxPieces;
+}
+
+bool Tablebases::probe(const Bitboard pieces[2][6], Color sideToMove, TBResult& result) const {
+    int counts[2][6];
+    int total;
+    countPieces(pieces, counts, total);
+    //Bare kings need no table
+    if (total == 2){
+        result.outcome = TBOutcome::Draw;
+        result.plies = 0;
+        return true;
+    }
+    if (total > maxPieces){
+        return false;
+    }
+    const int* white = counts[static_cast<int>(Color::White)];
+    const int* black = counts[static_cast<int>(Color::Black)];
+    auto found = tables.find(nameOf(white, black));
+    if (found == tables.end()){
+        return false;
+    }
+    uint8_t value = found->second->valueAt(indexOf(pieces, sideToMove, !whiteGoesFirst(white, black)));
+    if (value == VALUE_ILLEGAL){
+        return false;
+    }
+    if (value == VALUE_DRAW){
+        result.outcome = TBOutcome::Draw;
+        result.plies = 0;
+        return true;
+    }
+    result.plies = value - 1;
+    result.outcome = result.plies % 2 ? TBOutcome::Win : TBOutcome::Loss;
+    return true;
+}
+
+bool Tablebases::probe(const Position& pos, TBResult& result) const {
+    if (pos.getCastlingRights() != 0){
+        return false;
+    }
+    //An en passant square only matters when the capture can actually be played
+    if (pos.getEnPassantSquare() >= 0){
+        MoveList moves;
+        pos.generateLegalMoves(pos.getSideToMove(), moves, GenStage::CAPTURES);
+        for (int i = 0; i < moves.size(); ++i){
+            if (moves[i].isEnPassant()){
+                return false;
+            }
+        }
+    }
+    Bitboard pieces[2][6];
+    for (int col = 0; col < 2; ++col){
+        for (int type = 0; type < 6; ++type){
+            pieces[col][type] = pos.getPieces(static_cast<Color>(col), static_cast<PieceType>(type));
+        }
+    }
+    return probe(pieces, pos.getSideToMove(), result);
+}
+
+//Runs work(begin, end) over [0, count) split evenly between the threads
+template <typename Work>
+static void parallelFor(size_t count, int threads, Work work){
+    std::vector<std::thread> workers;
+    size_t chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; ++t){
+        size_t begin = t * chunk;
+        size_t end = begin + chunk < count ? begin + chunk : count;
+        if (begin < end){
+            workers.emplace_back(work, begin, end);
+        }
+    }
+    for (std::thread& worker : workers){
+        worker.join();
+    }
+}
+
+static bool fileExists(const std::string& path){
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+}
+
+static std::string tablePath(const std::string& directory, const std::string& name){
+    return directory + "/" + name + ".cgtb";
+}
+
+//Every material one capture, one promotion or a capturing promotion away
+static std::set<std::string> smallerTables(const int counts[2][6]){
+    std::set<std::string> names;
+    for (int mover = 0; mover < 2; ++mover){
+        int other = 1 - mover;
+        //-1 stands for a move that captures nothing
+        for (int victim = -1; victim < 6; ++victim){
+            if (victim == KING || (victim >= 0 && counts[other][victim] == 0)){
+                continue;
+            }
+            int after[2][6];
+            memcpy(after, counts, sizeof(after));
+            if (victim >= 0){
+                --after[other][victim];
+                names.insert(nameOf(after[0], after[1]));
+            }
+            if (counts[mover][PAWN] == 0){
+                continue;
+            }
+            for (int promotion : {QUEEN, ROOK, BISHOP, KNIGHT}){
+                int promoted[2][6];
+                memcpy(promoted, after, sizeof(promoted));
+                --promoted[mover][PAWN];
+                ++promoted[mover][promotion];
+                names.insert(nameOf(promoted[0], promoted[1]));
+            }
+        }
+    }
+    names.erase("KvK");
+    return names;
+}
+
+static bool writeTable(const std::string& path, const std::string& name, int pieceCount, int longest, const std::vector<std::atomic<uint8_t>>& values){
+    unsigned char header[HEADER_BYTES] = {0};
+    uint32_t version = TABLE_VERSION;
+    uint32_t longestMate = static_cast<uint32_t>(longest);
+    uint32_t pieces = static_cast<uint32_t>(pieceCount);
+    memcpy(header, TABLE_MAGIC, 4);
+    memcpy(header + 4, &version, sizeof(version));
+    memcpy(header + 8, &longestMate, sizeof(longestMate));
+    memcpy(header + 12, &pieces, sizeof(pieces));
+    memcpy(header + NAME_OFFSET, name.data(), name.size());
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file){
+        return false;
+    }
+    bool written = fwrite(header, 1, HEADER_BYTES, file) == HEADER_BYTES;
+    std::vector<uint8_t> buffer(1 << 16);
+    for (size_t begin = 0; begin < values.size() && written; begin += buffer.size()){
+        size_t count = values.size() - begin < buffer.size() ? values.size() - begin : buffer.size();
+        for (size_t i = 0; i < count; ++i){
+            buffer[i] = values[begin + i].load(std::memory_order_relaxed);
+        }
+        written = fwrite(buffer.data(), 1, count, file) == count;
+    }
+    return fclose(file) == 0 && written;
+}
+
+static bool generate(const std::string& name, const std::string& directory, int threads, std::ostream* log, std::set<std::string>& done){
+    if (done.count(name)){
+        return true;
+    }
+    int counts[2][6];
+    parseName(name, counts);
+    for (const std::string& smaller : smallerTables(counts)){
+        if (!fileExists(tablePath(directory, smaller)) && !generate(smaller, directory, threads, log, done)){
+            return false;
+        }
+    }
+    Tablebases smaller;
+    smaller.load(directory);
+
+    TableLayout layout = layoutOf(counts);
+    size_t entries = tableEntries(layout);
+    //The only full size buffer: a value per position, a win found through a capture or a
+    //promotion is stored right away and shortened if a quiet move turns out faster
+    std::vector<std::atomic<uint8_t>> value(entries);
+    //One bit per position, set for the ones to check for a loss in the current ply
+    std::vector<std::atomic<uint64_t>> candidates((entries + 63) / 64);
+    //Positions whose quiet moves all lose already but whose captures or promotions hold
+    //out longer, with the ply they are lost in. Rare, so kept as a list.
+    std::vector<std::pair<uint64_t, int>> pending;
+    std::mutex pendingLock;
+    std::atomic<bool> missingTable(false);
+    std::atomic<int> longestExit(0);
+
+    //First pass: mates, stalemates and every move that leaves for a smaller table
+    parallelFor(entries, threads, [&](size_t begin, size_t end){
+        int localLongest = 0;
+        for (size_t i = begin; i < end; ++i){
+            TableBoard b;
+            if (!decode(layout, i, b)){
+                value[i].store(VALUE_ILLEGAL, std::memory_order_relaxed);
+                continue;
+            }
+            int moves = 0, quiet = 0, fastestWin = 0, floor = 0;
+            bool holds = false;
+            forEachMove(b, [&](const TableBoard& child, bool leavesTable){
+                ++moves;
+                TBResult result;
+                if (!leavesTable){
+                    ++quiet;
+                }
+                else if (!smaller.probe(child.pieces, child.sideToMove, result)){
+                    missingTable.store(true, std::memory_order_relaxed);
+                }
+                else if (result.outcome == TBOutcome::Loss){
+                    if (!fastestWin || result.plies + 1 < fastestWin){
+                        fastestWin = result.plies + 1;
+                    }
+                }
+                else if (result.outcome == TBOutcome::Draw){
+                    holds = true;
+                }
+                else if (result.plies + 1 > floor){
+                    floor = result.plies + 1;
+                }
+            });
+            uint8_t v = VALUE_DRAW;
+            if (moves == 0){
+                v = kingAttacked(b, b.sideToMove) ? encodeValue(0) : VALUE_DRAW;
+            }
+            else if (fastestWin && fastestWin <= MAX_PLIES){
+                v = encodeValue(fastestWin);
+            }
+            //With only captures and promotions to play nothing in this table can change it
+            else if (quiet == 0 && !holds && floor <= MAX_PLIES){
+                v = encodeValue(floor);
+            }
+            value[i].store(v, std::memory_order_relaxed);
+            int exitPlies = holds ? fastestWin : (fastestWin > floor ? fastestWin : floor);
+            localLongest = exitPlies > localLongest ? exitPlies : localLongest;
+        }
+        int seen = longestExit.load();
+        while (localLongest > seen && !longestExit.compare_exchange_weak(seen, localLongest)){
+        }
+    });
+    if (missingTable){
+        if (log){
+            *log << name << ": a smaller table is missing" << std::endl;
+        }
+        return false;
+    }
+
+    //True when every move reaches a win for the opponent, quiet ones in at most plies - 1.
+    //floor is the ply the captures and promotions allow the loss in.
+    auto allMovesLose = [&](const TableBoard& b, int plies, int& floor){
+        bool lose = true;
+        floor = 0;
+        forEachMove(b, [&](const TableBoard& child, bool leavesTable){
+            if (!lose){
+                return;
+            }
+            if (!leavesTable){
+                uint8_t v = value[indexOf(child.pieces, child.sideToMove, false)].load(std::memory_order_relaxed);
+                //Wins have an odd number of plies, so an even value byte
+                lose = v != VALUE_DRAW && v % 2 == 0 && v < encodeValue(plies);
+                return;
+            }
+            TBResult result;
+            smaller.probe(child.pieces, child.sideToMove, result);
+            lose = result.outcome == TBOutcome::Win;
+            floor = result.plies + 1 > floor ? result.plies + 1 : floor;
+        });
+        return lose;
+    };
+
+    //Then one ply at a time: a position is won in n if a move reaches a loss in n - 1,
+    //and lost in n once every move reaches a win and the longest of them is n - 1
+    for (int plies = 1; plies <= MAX_PLIES; ++plies){
+        std::atomic<uint64_t> changed(0);
+        uint8_t previous = encodeValue(plies - 1);
+        uint8_t current = encodeValue(plies);
+        if (plies % 2){
+            parallelFor(entries, threads, [&](size_t begin, size_t end){
+                uint64_t localChanged = 0;
+                for (size_t i = begin; i < end; ++i){
+                    if (value[i].load(std::memory_order_relaxed) != previous){
+                        continue;
+                    }
+                    TableBoard b;
+                    decode(layout, i, b);
+                    forEachUnmove(b, [&](const TableBoard& parent){
+                        std::atomic<uint8_t>& target = value[indexOf(parent.pieces, parent.sideToMove, false)];
+                        uint8_t seen = target.load(std::memory_order_relaxed);
+                        //Unknown, or a slower win through a capture or promotion
+                        while (seen == VALUE_DRAW || (seen % 2 == 0 && seen > current && seen != VALUE_ILLEGAL)){
+                            if (target.compare_exchange_weak(seen, current, std::memory_order_relaxed)){
+                                ++localChanged;
+                                break;
+                            }
+                        }
+                    });
+                }
+                changed += localChanged;
+            });
+        }
+        else {
+            parallelFor(entries, threads, [&](size_t begin, size_t end){
+                for (size_t i = begin; i < end; ++i){
+                    if (value[i].load(std::memory_order_relaxed) != previous){
+                        continue;
+                    }
+                    TableBoard b;
+                    decode(layout, i, b);
+                    forEachUnmove(b, [&](const TableBoard& parent){
+                        uint64_t j = indexOf(parent.pieces, parent.sideToMove, false);
+                        if (value[j].load(std::memory_order_relaxed) == VALUE_DRAW){
+                            candidates[j / 64].fetch_or(uint64_t(1) << (j % 64), std::memory_order_relaxed);
+                        }
+                    });
+                }
+            });
+            for (const std::pair<uint64_t, int>& entry : pending){
+                if (entry.second == plies){
+                    candidates[entry.first / 64].fetch_or(uint64_t(1) << (entry.first % 64), std::memory_order_relaxed);
+                }
+            }
+            pending.erase(std::remove_if(pending.begin(), pending.end(), [plies](const std::pair<uint64_t, int>& entry){
+                return entry.second == plies;
+            }), pending.end());
+            parallelFor(candidates.size(), threads, [&](size_t begin, size_t end){
+                uint64_t localChanged = 0;
+                std::vector<std::pair<uint64_t, int>> localPending;
+                for (size_t word = begin; word < end; ++word){
+                    uint64_t bits = candidates[word].exchange(0, std::memory_order_relaxed);
+                    while (bits){
+                        uint64_t i = word * 64 + popLsb(bits);
+                        TableBoard b;
+                        int floor;
+                        decode(layout, i, b);
+                        if (!allMovesLose(b, plies, floor)){
+                            continue;
+                        }
+                        if (floor <= plies){
+                            value[i].store(current, std::memory_order_relaxed);
+                            ++localChanged;
+                        }
+                        else if (floor <= MAX_PLIES){
+                            localPending.emplace_back(i, floor);
+                        }
+                    }
+                }
+                changed += localChanged;
+                std::lock_guard<std::mutex> lock(pendingLock);
+                pending.insert(pending.end(), localPending.begin(), localPending.end());
+            });
+        }
+        //Nothing new and no capture or promotion left that could start something
+        if (!changed && plies >= longestExit){
+            break;
+        }
+    }
+
+    int longest = 0;
+    for (size_t i = 0; i < entries; ++i){
+        uint8_t v = value[i].load(std::memory_order_relaxed);
+        if (v != VALUE_DRAW && v != VALUE_ILLEGAL && v - 1 > longest){
+            longest = v - 1;
+        }
+    }
+
+    std::string path = tablePath(directory, name);
+    if (!writeTable(path, name, layout.pieceCount, longest, value)){
+        if (log){
+            *log << name << ": could not write " << path << std::endl;
+        }
+        return false;
+    }
+    if (log){
+        *log << name << ": " << entries << " positions, longest mate " << longest << " plies" << std::endl;
+    }
+    done.insert(name);
+    return true;
+}
+
+bool generateTablebase(const std::string& name, const std::string& directory, int threads, std::ostream* log){
+    std::string canonical = canonicalTablebaseName(name);
+    if (canonical.empty() || canonical == "KvK"){
+        return false;
+    }
+    std::set<std::string> done;
+    return generate(canonical, directory, threads < 1 ? 1 : threads, log, done);
+}
@@ -0,0 +1,41 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "../chessGameHeader/tablebase.hpp"
+
+using namespace std;
+
+//Usage:
+//  ./tablebaseGen <directory> [threads] [material ...]
+//Writes one <material>.cgtb file per table into the directory, KQvK KRvK KPvK KBNvK when
+//no material is given. Smaller tables reached by captures and promotions are made too.
+//A five piece table without pawns has 2 * 462 * 64^3 positions, a byte each and a bit
+//more while it is built.
+
+int main(int argc, char* argv[]){
+    if (argc < 2){
+        cout << "Usage: ./tablebaseGen <directory> [threads] [material ...]" << endl;
+        return 1;
+    }
+    string directory = argv[1];
+    int cores = static_cast<int>(thread::hardware_concurrency());
+    int threads = argc > 2 ? atoi(argv[2]) : (cores > 0 ? cores : 1);
+    const char* defaults[] = {"KQvK", "KRvK", "KPvK", "KBNvK"};
+
+    int failures = 0;
+    int count = argc > 3 ? argc - 3 : 4;
+    for (int i = 0; i < count; ++i){
+        string name = argc > 3 ? argv[3 + i] : defaults[i];
+        auto start = chrono::steady_clock::now();
+        if (!generateTablebase(name, directory, threads, &cout)){
+            cout << "Could not generate " << name << endl;
+            ++failures;
+            continue;
+        }
+        cout << canonicalTablebaseName(name) << " done in "
+             << chrono::duration<double>(chrono::steady_clock::now() - start).count() << " s" << endl;
+    }
+    return failures ? 1 : 0;
+}
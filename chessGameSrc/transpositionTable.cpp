@@ -0,0 +1,158 @@
+#include "../chessGameHeader/transpositionTable.hpp"
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+static_assert(std::is_trivially_destructible<TTBucket>::value, "buckets are released with free");
+
+//Packed entry layout: move 16 bits, score 16 bits, depth 8 bits, bound 2 bits, generation 6 bits
+static const int SCORE_SHIFT = 16;
+static const int DEPTH_SHIFT = 32;
+static const int BOUND_SHIFT = 40;
+static const int GENERATION_SHIFT = 42;
+static const uint8_t GENERATION_MASK = 63;
+
+//Transparent huge pages need 2MB aligned memory, smaller tables only need cache line alignment
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static uint64_t packEntry(Move move, int score, int depth, TTBound bound, uint8_t generation){
+    return static_cast<uint64_t>(move.getRaw())
+         | static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(score))) << SCORE_SHIFT
+         | static_cast<uint64_t>(static_cast<uint8_t>(depth)) << DEPTH_SHIFT
+         | static_cast<uint64_t>(bound) << BOUND_SHIFT
+         | static_cast<uint64_t>(generation) << GENERATION_SHIFT;
+}
+
+static Move entryMove(uint64_t data){
+    uint16_t raw = static_cast<uint16_t>(data);
+    return Move(raw & 63, (raw >> 6) & 63, raw >> 12);
+}
+
+static int entryDepth(uint64_t data){
+    return static_cast<uint8_t>(data >> DEPTH_SHIFT);
+}
+
+static uint8_t entryGeneration(uint64_t data){
+    return static_cast<uint8_t>(data >> GENERATION_SHIFT) & GENERATION_MASK;
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) : buckets(nullptr), bucketCount(0), allocatedBytes(0), generation(0) {
+    resize(megabytes);
+}
+
+TranspositionTable::~TranspositionTable(){
+    free(buckets);
+}
+
+void TranspositionTable::resize(size_t megabytes){
+    free(buckets);
+    size_t bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+    bucketCount = bytes / sizeof(TTBucket);
+    allocatedBytes = bucketCount * sizeof(TTBucket);
+
+    size_t alignment = allocatedBytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : alignof(TTBucket);
+    //aligned_alloc wants the size to be a multiple of the alignment
+    size_t rounded = (allocatedBytes + alignment - 1) / alignment * alignment;
+    void* memory = aligned_alloc(alignment, rounded);
+    if (!memory){
+        throw std::bad_alloc();
+    }
+    //The atomics need real objects to live in. Nothing has to run before free gives the memory back.
+    buckets = static_cast<TTBucket*>(memory);
+    std::uninitialized_default_construct_n(buckets, bucketCount);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    //Only a hint, the kernel falls back to normal pages when it has no huge ones
+    if (alignment == HUGE_PAGE_SIZE){
+        madvise(buckets, rounded, MADV_HUGEPAGE);
+    }
+#endif
+    clear();
+}
+
+void TranspositionTable::clear(){
+    for (size_t i = 0; i < bucketCount; ++i){
+        for (TTEntry& entry : buckets[i].entries){
+            entry.keyXorData.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch(){
+    generation = (generation + 1) & GENERATION_MASK;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTData& out) const {
+    const TTBucket& bucket = bucketFor(key);
+    for (const TTEntry& entry : bucket.entries){
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.keyXorData.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && data != 0){
+            out.move = entryMove(data);
+            out.score = static_cast<int16_t>(static_cast<uint16_t>(data >> SCORE_SHIFT));
+            out.depth = entryDepth(data);
+            out.bound = static_cast<TTBound>((data >> BOUND_SHIFT) & 3);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, TTBound bound){
+    TTBucket& bucket = bucketFor(key);
+    TTEntry* replace = &bucket.entries[0];
+    int replaceValue = 1 << 30;
+
+    for (TTEntry& entry : bucket.entries){
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        uint64_t check = entry.keyXorData.load(std::memory_order_relaxed);
+        if ((check ^ data) == key || data == 0){
+            //Same position, keep the old best move if the new result has none
+            if (move.isNull() && data != 0){
+                move = entryMove(data);
+            }
+            replace = &entry;
+            break;
+        }
+        //Shallow entries from old searches go first
+        int age = (generation - entryGeneration(data)) & GENERATION_MASK;
+        int value = entryDepth(data) - 8 * age;
+        if (value < replaceValue){
+            replaceValue = value;
+            replace = &entry;
+        }
+    }
+
+    uint64_t data = packEntry(move, score, depth < 0 ? 0 : depth, bound, generation);
+    replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    replace->data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    size_t sample = bucketCount < 250 ? bucketCount : 250;
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i){
+        for (const TTEntry& entry : buckets[i].entries){
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            if (data != 0 && entryGeneration(data) == generation){
+                ++used;
+            }
+        }
+    }
+    return sample ? static_cast<int>(used * 1000 / (sample * TT_BUCKET_SIZE)) : 0;
+}
+
+size_t TranspositionTable::getSizeInBytes() const {
+    return allocatedBytes;
+}
+
+size_t TranspositionTable::getEntryCount() const {
+    return bucketCount * TT_BUCKET_SIZE;
+}
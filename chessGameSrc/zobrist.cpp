@@ -0,0 +1,46 @@
+#include "../chessGameHeader/zobrist.hpp"
+
+uint64_t zobristPieces[2][6][64];
+uint64_t zobristCastling[16];
+uint64_t zobristEnPassant[8];
+uint64_t zobristBlackToMove;
+
+//splitmix64, good enough spread for hash keys and cheap to seed
+static uint64_t nextKey(uint64_t& state){
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void initZobrist(){
+    uint64_t state = 1070372;
+    for (int c = 0; c < 2; ++c){
+        for (int t = 0; t < 6; ++t){
+            for (int sq = 0; sq < 64; ++sq){
+                zobristPieces[c][t][sq] = nextKey(state);
+            }
+        }
+    }
+
+    //Each right gets a key and a set of rights is the xor of its members
+    uint64_t rightKeys[4];
+    for (int i = 0; i < 4; ++i){
+        rightKeys[i] = nextKey(state);
+    }
+    for (int rights = 0; rights < 16; ++rights){
+        zobristCastling[rights] = 0;
+        for (int i = 0; i < 4; ++i){
+            if (rights & (1 << i)){
+                zobristCastling[rights] ^= rightKeys[i];
+            }
+        }
+    }
+
+    for (int file = 0; file < 8; ++file){
+        zobristEnPassant[file] = nextKey(state);
+    }
+    zobristBlackToMove = nextKey(state);
+}
+
+static const bool zobristReady = (initZobrist(), true);
@@ -11,5 +11,6 @@ class Bishop : public Piece{
    Bishop(Color col);
    bool canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const override;
    string getSymbol() const override;
+   PieceType getType() const override;
 };
 #endif /* BISHOP_HPP */
\ No newline at end of file
@@ -11,6 +11,7 @@ class King : public Piece{
    King(Color col);
    bool canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const override;
    string getSymbol() const override;
+   PieceType getType() const override;
 };
 
 #endif /* KING_HPP */
\ No newline at end of file
@@ -11,6 +11,7 @@ class Pawn : public Piece{
    Pawn(Color col);
    bool canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const override;
    string getSymbol() const override;
+   PieceType getType() const override;
 };
 
 #endif /* PAWN_HPP */ 
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define PIECE_HPP
 
 #include "../chessGameHeader/chessGame.hpp"
+#include "pieceType.hpp"
+#include "pieceCode.hpp"
 
 #include <string>
 #include <memory>
@@ -10,7 +12,6 @@
 class chessBoard;
 
 using namespace std;
-enum class Color {Black, White, none};
 
 class Piece{
     protected:
@@ -22,8 +23,15 @@ class Piece{
     virtual ~Piece();
     virtual bool canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const = 0;
     virtual string getSymbol() const = 0;
+    virtual PieceType getType() const = 0;
     Color getColor() const;
    
 };
 
+//The board stores PieceCodes, these turn them back into Piece objects for code that still wants one.
+//pieceFromCode hands out a shared instance, makePiece a new one the caller owns.
+Piece& pieceFromCode(PieceCode code);
+unique_ptr<Piece> makePiece(Color col, PieceType type);
+PieceCode pieceCodeOf(const Piece& piece);
+
 #endif /* PIECE_HPP */  
\ No newline at end of file
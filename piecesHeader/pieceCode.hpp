@@ -0,0 +1,60 @@
+#ifndef PIECECODE_HPP
+#define PIECECODE_HPP
+
+#include <cstdint>
+
+#include "pieceType.hpp"
+
+//One byte per piece on the board: color * 6 + type, with NO_PIECE for an empty square.
+//Everything the old piece objects answered through virtual calls is a table lookup here.
+typedef uint8_t PieceCode;
+
+constexpr PieceCode NO_PIECE = 12;
+
+//How a piece gets around the board
+enum class Movement : unsigned char {PawnStep, Leaper, Slider, none};
+
+constexpr PieceCode makePieceCode(Color col, PieceType type){
+    return static_cast<PieceCode>(static_cast<int>(col) * 6 + static_cast<int>(type));
+}
+
+constexpr PieceType pieceTypeTable[13] = {
+    PieceType::Pawn, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen, PieceType::King,
+    PieceType::Pawn, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen, PieceType::King,
+    PieceType::none
+};
+
+constexpr Color pieceColorTable[13] = {
+    Color::Black, Color::Black, Color::Black, Color::Black, Color::Black, Color::Black,
+    Color::White, Color::White, Color::White, Color::White, Color::White, Color::White,
+    Color::none
+};
+
+//Same letters getSymbol() gives, '.' for an empty square
+constexpr char pieceSymbolTable[13] = {'p', 'n', 'b', 'r', 'q', 'k', 'P', 'N', 'B', 'R', 'Q', 'K', '.'};
+
+//What displayBoard prints for each piece
+constexpr const char* pieceGlyphTable[13] = {
+    "\u265F", "\u265E", "\u265D", "\u265C", "\u265B", "\u265A", // BLACK PAWN to KING
+    "\u2659", "\u2658", "\u2657", "\u2656", "\u2655", "\u2654", // WHITE PAWN to KING
+    "."
+};
+
+//Material value in centipawns, the king is never traded so it counts for nothing
+constexpr int pieceValueTable[13] = {100, 320, 330, 500, 900, 0, 100, 320, 330, 500, 900, 0, 0};
+
+constexpr Movement pieceMovementTable[13] = {
+    Movement::PawnStep, Movement::Leaper, Movement::Slider, Movement::Slider, Movement::Slider, Movement::Leaper,
+    Movement::PawnStep, Movement::Leaper, Movement::Slider, Movement::Slider, Movement::Slider, Movement::Leaper,
+    Movement::none
+};
+
+constexpr PieceType pieceTypeOf(PieceCode code){
+    return pieceTypeTable[code];
+}
+
+constexpr Color pieceColorOf(PieceCode code){
+    return pieceColorTable[code];
+}
+
+#endif /* PIECECODE_HPP */
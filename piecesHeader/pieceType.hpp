@@ -0,0 +1,25 @@
+#ifndef PIECETYPE_HPP
+#define PIECETYPE_HPP
+
+//Shared by the piece classes and the bitboard position, kept apart from piece.hpp
+//so the board headers can use them without pulling in the whole Piece hierarchy
+enum class Color {Black, White, none};
+
+//Ordered the same way as the bitboards in Position (pawn first, king last).
+//One byte so it packs into the per move undo record.
+enum class PieceType : unsigned char {Pawn, Knight, Bishop, Rook, Queen, King, none};
+
+//Letter as used in FEN and SAN, either case
+inline PieceType pieceTypeFromChar(char c){
+    switch (c){
+        case 'p': case 'P': return PieceType::Pawn;
+        case 'n': case 'N': return PieceType::Knight;
+        case 'b': case 'B': return PieceType::Bishop;
+        case 'r': case 'R': return PieceType::Rook;
+        case 'q': case 'Q': return PieceType::Queen;
+        case 'k': case 'K': return PieceType::King;
+        default: return PieceType::none;
+    }
+}
+
+#endif /* PIECETYPE_HPP */
@@ -12,6 +12,7 @@ class Queen : public Piece{
    bool canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const override;
 
    string getSymbol() const override;
+   PieceType getType() const override;
 };
 
 #endif /* QUEEN_HPP */
\ No newline at end of file
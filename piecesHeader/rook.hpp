@@ -11,6 +11,7 @@ class Rook : public Piece{
    Rook(Color col);
    bool canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const override;
    string getSymbol() const override;
+   PieceType getType() const override;
 };
 
 #endif /* ROOK_HPP */
\ No newline at end of file
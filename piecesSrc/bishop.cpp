@@ -1,4 +1,5 @@
 #include "../piecesHeader/bishop.hpp"
+#include "../chessGameHeader/attacks.hpp"
 
 Bishop::~Bishop(){
 }
@@ -9,32 +10,18 @@ Bishop::Bishop(Color col){
 
 bool Bishop::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const{
 
-// Check if the move is a diagonal move
-// The reason this works is because to move diagonally if you shift two steps rights, you must shift two steps up to
-// be in diagonal
-    
-    if (abs(targetX - sourceX) != abs(targetY - sourceY)) {
-        return false; // not moving diagonally
-    }
-
-    // Determine the direction of movement
-    int deltaX = (targetX > sourceX) ? 1 : -1;
-    int deltaY = (targetY > sourceY) ? 1 : -1;
-
-    // Check each square along the diagonal path
-    int x = sourceX + deltaX;
-    int y = sourceY + deltaY;
-    while (x != targetX && y != targetY) {
-        if (!board.getSquare(x, y).isEmpty()) {
-            return false; // Path is obstructed
-        }
-        x += deltaX;
-        y += deltaY;
-    }
-
-    return true; // Path is clear, move is valid
+// The bishop moves diagonally until the first piece in the way. The magic table gives
+// every square it can reach from the source for the current occupancy in one lookup
+
+    Bitboard reachable = bishopAttacks(squareIndex(sourceX, sourceY), board.getPosition().getOccupancy());
+
+    return (reachable & squareBit(squareIndex(targetX, targetY))) != 0;
 }
 
 string Bishop::getSymbol() const{
     return color == Color::White ? "B" : "b";
+}
+
+PieceType Bishop::getType() const{
+    return PieceType::Bishop;
 }
\ No newline at end of file
@@ -28,6 +28,10 @@ string King::getSymbol() const{
     return color == Color::White ? "K" : "k";
 }
 
+PieceType King::getType() const{
+    return PieceType::King;
+}
+
 /* 
 1) User enters a move 
 2) The move is validated first 
@@ -22,4 +22,8 @@ bool Knight::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const
 
 string Knight::getSymbol() const{
     return color == Color::White ? "N" : "n";
+}
+
+PieceType Knight::getType() const{
+    return PieceType::Knight;
 }
\ No newline at end of file
@@ -17,7 +17,7 @@ bool Pawn::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const c
     }
 
     //Checks if pawn can move one space forward
-    if (targetX == sourceX + direction && targetY == sourceY && board.getSquare(targetX, targetY).isEmpty()) {
+    if (targetX == sourceX + direction && targetY == sourceY && !board.isOccupied(targetX, targetY)) {
         return true;
     }
 
@@ -29,12 +29,12 @@ bool Pawn::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const c
     }
 
     if (sourceX == sourceRow && targetX == sourceX + 2 * direction && targetY == sourceY) {
-        if (board.getSquare(targetX, targetY).isEmpty() && board.getSquare(sourceX + direction, sourceY).isEmpty()) {
+        if (!board.isOccupied(targetX, targetY) && !board.isOccupied(sourceX + direction, sourceY)) {
             return true;
         }
     }
      if (targetX == sourceX + direction && (targetY == sourceY + 1 || targetY == sourceY - 1)) {
-        if(!board.getSquare(targetX, targetX).isEmpty()){
+        if(board.isOccupied(targetX, targetX)){
             return true; 
         }
      }
@@ -45,4 +45,8 @@ bool Pawn::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const c
 
 string Pawn::getSymbol() const{
     return color == Color::White ? "P" : "p";
+}
+
+PieceType Pawn::getType() const{
+    return PieceType::Pawn;
 }
\ No newline at end of file
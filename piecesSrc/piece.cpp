@@ -1,4 +1,12 @@
 #include "../piecesHeader/piece.hpp"
+#include "../piecesHeader/pawn.hpp"
+#include "../piecesHeader/knight.hpp"
+#include "../piecesHeader/bishop.hpp"
+#include "../piecesHeader/rook.hpp"
+#include "../piecesHeader/queen.hpp"
+#include "../piecesHeader/king.hpp"
+
+#include <stdexcept>
 
 Piece::Piece(){
     color = Color::none;
@@ -14,3 +22,47 @@ Piece::~Piece() {
 Color Piece::getColor() const{
     return color;
 }
+
+Piece& pieceFromCode(PieceCode code){
+    //Pieces hold nothing but their color, so one of each is enough for every board
+    static Pawn blackPawn(Color::Black);
+    static Knight blackKnight(Color::Black);
+    static Bishop blackBishop(Color::Black);
+    static Rook blackRook(Color::Black);
+    static Queen blackQueen(Color::Black);
+    static King blackKing(Color::Black);
+    static Pawn whitePawn(Color::White);
+    static Knight whiteKnight(Color::White);
+    static Bishop whiteBishop(Color::White);
+    static Rook whiteRook(Color::White);
+    static Queen whiteQueen(Color::White);
+    static King whiteKing(Color::White);
+    static Piece* const pieces[12] = {
+        &blackPawn, &blackKnight, &blackBishop, &blackRook, &blackQueen, &blackKing,
+        &whitePawn, &whiteKnight, &whiteBishop, &whiteRook, &whiteQueen, &whiteKing
+    };
+
+    if (code >= NO_PIECE) {
+        throw std::runtime_error("Attempted to access a null piece");
+    }
+    return *pieces[code];
+}
+
+unique_ptr<Piece> makePiece(Color col, PieceType type){
+    switch (type){
+        case PieceType::Pawn: return make_unique<Pawn>(col);
+        case PieceType::Knight: return make_unique<Knight>(col);
+        case PieceType::Bishop: return make_unique<Bishop>(col);
+        case PieceType::Rook: return make_unique<Rook>(col);
+        case PieceType::Queen: return make_unique<Queen>(col);
+        case PieceType::King: return make_unique<King>(col);
+        default: return nullptr;
+    }
+}
+
+PieceCode pieceCodeOf(const Piece& piece){
+    if (piece.getColor() == Color::none){
+        return NO_PIECE;
+    }
+    return makePieceCode(piece.getColor(), piece.getType());
+}
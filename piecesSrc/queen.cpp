@@ -1,4 +1,5 @@
 #include "../piecesHeader/queen.hpp"
+#include "../chessGameHeader/attacks.hpp"
 
 Queen::~Queen(){
 }
@@ -8,53 +9,19 @@ Queen::Queen(Color col){
 }
 
 bool Queen::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const{
-    // Check for horizontal or vertical movement
-    if (sourceX == targetX || sourceY == targetY) {
-        int stepX = (targetX - sourceX != 0) ? (targetX - sourceX) / abs(targetX - sourceX) : 0;
-        int stepY = (targetY - sourceY != 0) ? (targetY - sourceY) / abs(targetY - sourceY) : 0;
-        int x = sourceX + stepX;
-        int y = sourceY + stepY;
-        
-        // Traverse the path from source to target and check if it's clear
-        while (x != targetX || y != targetY) {
-            if (!board.getSquare(x, y).isEmpty()) {
-            return false; // Path is obstructed
-        }
-            
-            x += stepX;
-            y += stepY;
-        }
-    }
-
-    // Check for diagonal movement
-    else if (abs(targetX - sourceX) == abs(targetY - sourceY)) {
-        int stepX = (targetX - sourceX) / abs(targetX - sourceX);
-        int stepY = (targetY - sourceY) / abs(targetY - sourceY);
-        int x = sourceX + stepX;
-        int y = sourceY + stepY;
-        
-        // Traverse the path from source to target and check if it's clear
-        while (x != targetX && y != targetY) {
-            if (!board.getSquare(x, y).isEmpty()) {
-                return false; // Path is obstructed
-            }
-            x += stepX;
-            y += stepY;
-        }
-    }
-    else {
-        // The move is not horizontal, vertical, or diagonal and thus is not valid for the queen
-        return false;
-    }
-
-        
-    
-    // The move is valid if none of the invalid conditions are met
-    return true;
+    // The queen combines the rook and bishop rays, both stop at the first piece in the way
+    Bitboard reachable = queenAttacks(squareIndex(sourceX, sourceY), board.getPosition().getOccupancy());
+
+    // The move is valid if the target is on one of the unobstructed rays
+    return (reachable & squareBit(squareIndex(targetX, targetY))) != 0;
 }
 
 
 
 string Queen::getSymbol() const{
     return color == Color::White ? "Q" : "q";
+}
+
+PieceType Queen::getType() const{
+    return PieceType::Queen;
 }
\ No newline at end of file
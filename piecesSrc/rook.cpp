@@ -1,4 +1,5 @@
 #include "../piecesHeader/rook.hpp"
+#include "../chessGameHeader/attacks.hpp"
 
 Rook::~Rook(){
 }
@@ -8,52 +9,17 @@ Rook::Rook(Color col){
 }
 
 bool Rook::canMoveTo(int sourceX, int sourceY, int targetX, int targetY, const chessBoard& board) const{
-    //Rooks only move horizontally or vertically
-   if ((sourceX != targetX) && (sourceY != targetY)) {
-       return false; // Not moving either way
-   }
+   //Rooks only move horizontally or vertically and cannot jump over pieces,
+   //the attack set from the magic table already stops at the first blocker on each ray
+   Bitboard reachable = rookAttacks(squareIndex(sourceX, sourceY), board.getPosition().getOccupancy());
 
-   // Find the direction of the move
-   int deltaX, deltaY;
-
-   if (targetX > sourceX){
-       deltaX = 1;
-   }
-
-   else if (targetX < sourceX){
-       deltaX = -1;
-   }
-
-   else{
-       deltaX = 0;
-   }
-
-   if (targetY > sourceY){
-       deltaY = 1;
-   }
-
-   else if (targetY < sourceY){
-       deltaY = -1;
-   }
-
-   else{
-       deltaY = 0;
-   }
-
-   // Check each square along the path
-   int x = sourceX + deltaX;
-   int y = sourceY + deltaY;
-   while (x != targetX || y != targetY) {
-       if (!board.getSquare(x, y).isEmpty()) {
-           return false; // Path is obstructed
-       }
-       x += deltaX;
-       y += deltaY;
-   }
-   
-   return true; // Path is clear, move is valid
+   return (reachable & squareBit(squareIndex(targetX, targetY))) != 0;
 }
 
 string Rook::getSymbol() const{
     return color == Color::White ? "R" : "r";
-};
\ No newline at end of file
+};
+
+PieceType Rook::getType() const{
+    return PieceType::Rook;
+}
\ No newline at end of file
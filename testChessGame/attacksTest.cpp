@@ -0,0 +1,89 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/attacks.hpp"
+
+//Slow ray walk used as the reference for the magic tables
+static Bitboard walkRays(int sq, Bitboard occupancy, bool diagonal)
+{
+    static const int straight[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    static const int diagonals[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+    const int (*directions)[2] = diagonal ? diagonals : straight;
+    Bitboard attacks = 0;
+    for (int d = 0; d < 4; ++d) {
+        int rank = sq / 8 + directions[d][0];
+        int file = sq % 8 + directions[d][1];
+        while (rank >= 0 && rank < 8 && file >= 0 && file < 8) {
+            attacks |= squareBit(rank * 8 + file);
+            if (occupancy & squareBit(rank * 8 + file)) {
+                break;
+            }
+            rank += directions[d][0];
+            file += directions[d][1];
+        }
+    }
+    return attacks;
+}
+
+static void checkAgainstReference()
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 2000; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        Bitboard occupancy = state & (state >> 3);
+        int sq = i % 64;
+        ASSERT_EQ(rookAttacks(sq, occupancy), walkRays(sq, occupancy, false));
+        ASSERT_EQ(bishopAttacks(sq, occupancy), walkRays(sq, occupancy, true));
+    }
+}
+
+//Slider Tests
+TEST(AttacksTests, testRookEmptyBoard)
+{
+    EXPECT_EQ(popCount(rookAttacks(0, 0)), 14);
+}
+
+TEST(AttacksTests, testBishopBlocked)
+{
+    //Bishop on a1 with a blocker on c3 sees b2 and c3 only
+    EXPECT_EQ(bishopAttacks(0, squareBit(18)), squareBit(9) | squareBit(18));
+}
+
+TEST(AttacksTests, testQueenIsRookAndBishop)
+{
+    Bitboard occupancy = squareBit(35) | squareBit(12);
+    ASSERT_EQ(queenAttacks(27, occupancy), rookAttacks(27, occupancy) | bishopAttacks(27, occupancy));
+}
+
+TEST(AttacksTests, testMatchesRayWalk)
+{
+    checkAgainstReference();
+}
+
+TEST(AttacksTests, testMagicMultiplyMatchesRayWalk)
+{
+    //Force the multiply path even when the CPU has PEXT, then put the tables back
+    initAttacks(false);
+    checkAgainstReference();
+    initAttacks(true);
+    checkAgainstReference();
+}
+
+//Leaper Tests
+TEST(AttacksTests, testKnightCorner)
+{
+    EXPECT_EQ(knightAttacks(0), squareBit(10) | squareBit(17));
+}
+
+TEST(AttacksTests, testKingCenter)
+{
+    EXPECT_EQ(popCount(kingAttacks(27)), 8);
+}
+
+TEST(AttacksTests, testPawnAttacks)
+{
+    EXPECT_EQ(pawnAttacks(Color::White, 8), squareBit(17));
+    ASSERT_EQ(pawnAttacks(Color::Black, 52), squareBit(43) | squareBit(45));
+}
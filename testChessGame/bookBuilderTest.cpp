@@ -0,0 +1,94 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/bookBuilder.hpp"
+
+static const char* pgnPath = "bookBuilderTest.pgn";
+static const char* bookPath = "bookBuilderTest.bin";
+
+//Three games after 1. e4: two white wins and a draw, one game with 1. d4 that black won.
+//The last two are left out, one has no result and one breaks off with an illegal move.
+static void writeTestGames()
+{
+    std::ofstream out(pgnPath);
+    out << "[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 Nc6 1-0\n\n"
+        << "[Result \"1-0\"]\n\n1. e4 c5 2. Nf3 1-0\n\n"
+        << "[Result \"1/2-1/2\"]\n\n1. e4 e5 2. Bc4 1/2-1/2\n\n"
+        << "[Result \"0-1\"]\n\n1. d4 d5 0-1\n\n"
+        << "[Result \"*\"]\n\n1. c4 *\n\n"
+        << "[Result \"1-0\"]\n\n1. e4 Ke6 1-0\n";
+}
+
+static Position startPosition()
+{
+    Position position;
+    position.loadFEN(START_FEN);
+    return position;
+}
+
+TEST(BookBuilderTests, testStatisticsPerMove)
+{
+    writeTestGames();
+    std::ifstream in(pgnPath);
+    PgnReader reader(in);
+    std::vector<PgnGame> games(1);
+    while (reader.next(games.back())) {
+        games.emplace_back();
+    }
+    games.pop_back();
+
+    BookStatistics statistics(20, 4);
+    statistics.addGames(games);
+    EXPECT_EQ(statistics.getGames(), 4u);
+    EXPECT_EQ(statistics.getRejected(), 2u);
+
+    uint64_t start = polyglotKey(startPosition());
+    MoveStats kingPawn = statistics.lookup(start, toPolyglotMove(Move(12, 28, DOUBLE_PAWN_PUSH)));
+    EXPECT_EQ(kingPawn.wins, 2u);
+    EXPECT_EQ(kingPawn.draws, 1u);
+    EXPECT_EQ(kingPawn.losses, 0u);
+    MoveStats queenPawn = statistics.lookup(start, toPolyglotMove(Move(11, 27, DOUBLE_PAWN_PUSH)));
+    EXPECT_EQ(queenPawn.losses, 1u);
+
+    //Black's reply after 1. e4 is scored from black's side
+    Position afterE4 = startPosition();
+    UndoState undo;
+    afterE4.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH), undo);
+    MoveStats reply = statistics.lookup(polyglotKey(afterE4), toPolyglotMove(Move(52, 36, DOUBLE_PAWN_PUSH)));
+    EXPECT_EQ(reply.losses, 1u);
+    ASSERT_EQ(reply.draws, 1u);
+}
+
+TEST(BookBuilderTests, testBuildBook)
+{
+    writeTestGames();
+    BookBuildOptions options;
+    options.maxPlies = 2;
+    options.threads = 3;
+    options.batchSize = 1;
+    ASSERT_TRUE(buildBook({pgnPath}, bookPath, options));
+
+    OpeningBook book;
+    ASSERT_TRUE(book.load(bookPath));
+    BookMove moves[8];
+    //1. d4 only lost, so it has no weight and stays out
+    ASSERT_EQ(book.findMoves(startPosition(), moves, 8), 1);
+    EXPECT_EQ(moves[0].move, Move(12, 28, DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(moves[0].weight, 5);
+
+    //Only two plies went in, nothing after 1. e4 e5
+    Position position = startPosition();
+    UndoState undo;
+    position.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH), undo);
+    position.makeMove(Move(52, 36, DOUBLE_PAWN_PUSH), undo);
+    EXPECT_EQ(book.findMoves(position, moves, 8), 0);
+
+    options.minGames = 2;
+    ASSERT_TRUE(buildBook({pgnPath}, bookPath, options));
+    ASSERT_TRUE(book.load(bookPath));
+    //1... c5 was played once
+    EXPECT_EQ(book.size(), 2u);
+    ASSERT_FALSE(buildBook({"noSuchGames.pgn"}, bookPath, options));
+}
@@ -327,4 +327,110 @@ TEST(ChessBoardTests, testMovePiecesMutlipleTimes)
     board1->movePiece(2, 1, 4, 2);
 
     ASSERT_TRUE(board1->getSquare(4, 2).getPiece().getSymbol() == "N");
-}
\ No newline at end of file
+}
+
+//makeMove & unmakeMove Tests
+TEST(ChessBoardTests, testMakeMoveUpdatesSquares)
+{
+    chessBoard board1;
+    board1.setupBoard();
+    board1.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH));
+
+    EXPECT_TRUE(board1.getSquare(6, 4).isEmpty());
+    EXPECT_EQ(board1.getSquare(4, 4).getPiece().getSymbol(), "P");
+    ASSERT_EQ(board1.getPosition().getEnPassantSquare(), 20);
+}
+
+TEST(ChessBoardTests, testUnmakeMoveRestoresCapture)
+{
+    chessBoard board1;
+    board1.getSquare(7, 0).setPiece(make_unique<Knight>(Color::White));
+    board1.getSquare(5, 1).setPiece(make_unique<Knight>(Color::Black));
+    board1.makeMove(Move(0, 17, CAPTURE));
+
+    EXPECT_EQ(board1.getSquare(5, 1).getPiece().getSymbol(), "N");
+
+    EXPECT_TRUE(board1.unmakeMove());
+    EXPECT_EQ(board1.getSquare(5, 1).getPiece().getSymbol(), "n");
+    EXPECT_EQ(board1.getSquare(7, 0).getPiece().getSymbol(), "N");
+    ASSERT_FALSE(board1.unmakeMove());
+}
+
+TEST(ChessBoardTests, testUnmakeCastleRestoresRights)
+{
+    Position position;
+    position.loadFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    UndoState undo;
+    position.makeMove(Move(4, 6, KING_CASTLE), undo);
+
+    EXPECT_EQ(position.pieceTypeAt(5), PieceType::Rook);
+    EXPECT_EQ(position.getCastlingRights(), BLACK_KING_SIDE | BLACK_QUEEN_SIDE);
+
+    position.unmakeMove(undo);
+    EXPECT_EQ(position.pieceTypeAt(7), PieceType::Rook);
+    EXPECT_EQ(position.pieceTypeAt(4), PieceType::King);
+    EXPECT_EQ(position.getSideToMove(), Color::White);
+    ASSERT_EQ(position.getCastlingRights(), ALL_CASTLING);
+}
+
+TEST(ChessBoardTests, testCopiedBoardIsIndependent)
+{
+    chessBoard board;
+    board.setupBoard();
+    chessBoard copy(board);
+
+    copy.movePiece(6, 4, 4, 4);
+
+    EXPECT_TRUE(copy.getSquare(6, 4).isEmpty());
+    EXPECT_TRUE(copy.getSquare(4, 4).getPiece().getType() == PieceType::Pawn);
+    ASSERT_FALSE(board.getSquare(6, 4).isEmpty());
+}
+
+TEST(ChessBoardTests, testLoadFEN)
+{
+    chessBoard board;
+    board.setupBoard();
+    board.makeMove(board.findLegalMove(6, 4, 4, 4));
+
+    ASSERT_TRUE(board.loadFEN("r3k2r/8/8/8/8/8/8/R3K2R b Kq - 3 20"));
+
+    EXPECT_EQ(board.getPlyCount(), 0);
+    EXPECT_TRUE(board.getSquare(6, 4).isEmpty());
+    EXPECT_TRUE(board.getSquare(0, 0).getPiece().getType() == PieceType::Rook);
+    EXPECT_TRUE(board.getSquare(7, 4).getPiece().getColor() == Color::White);
+    EXPECT_EQ(board.getPosition().getSideToMove(), Color::Black);
+    EXPECT_EQ(board.getPosition().getCastlingRights(), WHITE_KING_SIDE | BLACK_QUEEN_SIDE);
+    ASSERT_EQ(board.toFEN(), "r3k2r/8/8/8/8/8/8/R3K2R b Kq - 3 20");
+}
+
+TEST(ChessBoardTests, testLoadFENKeepsBoardOnError)
+{
+    chessBoard board;
+    board.setupBoard();
+
+    ASSERT_FALSE(board.loadFEN("r3k2r/8/8/8/8/8/8/R3K2Z w - - 0 1"));
+
+    ASSERT_EQ(board.toFEN(), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}
+
+TEST(ChessBoardTests, testRepetitionCountStopsAtPawnMove)
+{
+    chessBoard board;
+    board.setupBoard();
+    EXPECT_EQ(board.repetitionCount(), 1);
+    for (int i = 0; i < 2; ++i){
+        board.makeMove(board.findLegalMove(7, 6, 5, 5));
+        board.makeMove(board.findLegalMove(0, 6, 2, 5));
+        board.makeMove(board.findLegalMove(5, 5, 7, 6));
+        board.makeMove(board.findLegalMove(2, 5, 0, 6));
+    }
+    EXPECT_EQ(board.repetitionCount(), 3);
+
+    //After a pawn move the earlier positions can never come back
+    board.makeMove(board.findLegalMove(6, 0, 5, 0));
+    board.makeMove(board.findLegalMove(0, 6, 2, 5));
+    board.makeMove(board.findLegalMove(7, 6, 5, 5));
+    board.makeMove(board.findLegalMove(2, 5, 0, 6));
+    board.makeMove(board.findLegalMove(5, 5, 7, 6));
+    ASSERT_EQ(board.repetitionCount(), 2);
+}
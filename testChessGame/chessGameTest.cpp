@@ -107,7 +107,7 @@ TEST(ChessGameTests, getStringOfTwoMoves) {
 //addMove & printMoveHistory Tests
 TEST(ChessGameTests, moveHistory) {
     chessGame game;
-    game.addMoves(1, 2);
+    game.addMoves(Move(squareIndex(0, 3), squareIndex(1, 2)));
 
     //Move printed correctly
     testing::internal::CaptureStdout();
@@ -119,7 +119,7 @@ TEST(ChessGameTests, moveHistory) {
 
 TEST(ChessGameTests, moveHistoryIncorrectly) {
     chessGame game;
-    game.addMoves(1, 2);
+    game.addMoves(Move(squareIndex(0, 3), squareIndex(1, 2)));
 
     //Move printed correctly
     testing::internal::CaptureStdout();
@@ -131,8 +131,8 @@ TEST(ChessGameTests, moveHistoryIncorrectly) {
 
 TEST(ChessGameTests, moveHistoryTwoTimes) {
     chessGame game;
-    game.addMoves(1, 2);
-    game.addMoves(3, 4);
+    game.addMoves(Move(squareIndex(0, 3), squareIndex(1, 2)));
+    game.addMoves(Move(squareIndex(1, 4), squareIndex(3, 4), DOUBLE_PAWN_PUSH));
 
     //Move printed correctly
     testing::internal::CaptureStdout();
@@ -152,4 +152,138 @@ TEST(ChessGameTests, printCapturedPieces) {
     string output = testing::internal::GetCapturedStdout();
 
     ASSERT_EQ(output, "Rook Pawn \n");
-}
\ No newline at end of file
+}
+
+//Packed move history Tests
+TEST(ChessGameTests, moveHistoryKeepsPackedMoves) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 4, 4, 4, true);
+
+    ASSERT_EQ(game.getMoveHistory().size(), 1);
+    EXPECT_EQ(game.getMoveHistory()[0], Move(12, 28, DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(moveToString(game.getMoveHistory()[0]), "e2e4");
+    ASSERT_EQ(sizeof(Move), 2);
+}
+
+TEST(ChessGameTests, makeMoveFromPackedMove) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(Move(52, 36), false);
+
+    EXPECT_TRUE(game.moveSucess());
+    ASSERT_EQ(game.getMoveHistory()[0].getFlag(), DOUBLE_PAWN_PUSH);
+}
+
+TEST(ChessGameTests, moveToStringPromotion) {
+    ASSERT_EQ(moveToString(Move(52, 60, PROMOTION + 3)), "e7e8q");
+}
+
+TEST(ChessGameTests, pinnedPieceCannotMove) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 3, 4, 3, true);
+    game.makeMove(1, 4, 3, 4, false);
+    game.makeMove(7, 1, 6, 3, true);
+    game.makeMove(0, 5, 4, 1, false);
+
+    //The knight on d2 shields the king from the bishop on b4
+    game.makeMove(6, 3, 5, 5, true);
+    EXPECT_FALSE(game.moveSucess());
+    ASSERT_EQ(game.getMoveHistory().size(), 4);
+}
+
+TEST(ChessGameTests, enPassantCapturesPawn) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 4, 4, 4, true);
+    game.makeMove(1, 0, 2, 0, false);
+    game.makeMove(4, 4, 3, 4, true);
+    game.makeMove(1, 3, 3, 3, false);
+
+    game.makeMove(3, 4, 2, 3, true);
+    EXPECT_TRUE(game.moveSucess());
+    ASSERT_EQ(game.getMoveHistory().size(), 5);
+    EXPECT_TRUE(game.getMoveHistory()[4].isEnPassant());
+    ASSERT_EQ(game.getMaterialBalance(), 100);
+}
+
+//undoMove & redoMove Tests
+TEST(ChessGameTests, undoMoveRestoresBoard) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 4, 4, 4, true);
+
+    EXPECT_TRUE(game.undoMove());
+    EXPECT_TRUE(game.getMoveHistory().empty());
+    ASSERT_FALSE(game.undoMove());
+}
+
+TEST(ChessGameTests, redoMoveReplays) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 4, 4, 4, true);
+    game.undoMove();
+
+    EXPECT_TRUE(game.redoMove());
+    ASSERT_EQ(game.getMoveHistory().size(), 1);
+    EXPECT_FALSE(game.redoMove());
+}
+
+TEST(ChessGameTests, newMoveClearsRedo) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 4, 4, 4, true);
+    game.undoMove();
+    game.makeMove(6, 3, 4, 3, true);
+
+    ASSERT_FALSE(game.redoMove());
+}
+
+//Material balance Tests
+TEST(ChessGameTests, materialBalanceAfterCapture) {
+    chessGame game;
+    game.startGame();
+    EXPECT_EQ(game.getMaterialBalance(), 0);
+
+    game.makeMove(6, 4, 4, 4, true);
+    game.makeMove(1, 3, 3, 3, false);
+    game.makeMove(4, 4, 3, 3, true);
+
+    EXPECT_EQ(game.getMaterialBalance(), 100);
+    game.undoMove();
+    ASSERT_EQ(game.getMaterialBalance(), 0);
+}
+
+//Game end Tests
+static void shuffleKnights(chessGame& game) {
+    game.makeMove(7, 6, 5, 5, true);
+    game.makeMove(0, 6, 2, 5, false);
+    game.makeMove(5, 5, 7, 6, true);
+    game.makeMove(2, 5, 0, 6, false);
+}
+
+TEST(ChessGameTests, threefoldRepetitionIsDraw) {
+    chessGame game;
+    game.startGame();
+    shuffleKnights(game);
+    EXPECT_EQ(game.getGameStatus(), gameStatus::IN_PROGRESS);
+    shuffleKnights(game);
+
+    EXPECT_EQ(game.getGameStatus(), gameStatus::DRAW);
+    EXPECT_EQ(game.getDrawReason(), drawReason::REPETITION);
+    game.undoMove();
+    EXPECT_EQ(game.getGameStatus(), gameStatus::IN_PROGRESS);
+    ASSERT_EQ(game.getDrawReason(), drawReason::NONE);
+}
+
+TEST(ChessGameTests, checkmateEndsGame) {
+    chessGame game;
+    game.startGame();
+    game.makeMove(6, 5, 5, 5, true);
+    game.makeMove(1, 4, 3, 4, false);
+    game.makeMove(6, 6, 4, 6, true);
+    game.makeMove(0, 3, 4, 7, false);
+
+    ASSERT_EQ(game.getGameStatus(), gameStatus::CHECKMATE);
+}
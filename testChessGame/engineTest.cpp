@@ -0,0 +1,110 @@
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/engine.hpp"
+#include "../chessGameHeader/chessBoard.hpp"
+
+static Engine engineFromFEN(const char* fen)
+{
+    Position position;
+    EXPECT_TRUE(position.loadFEN(fen));
+    Engine engine;
+    engine.setPosition(position);
+    return engine;
+}
+
+TEST(EngineTests, testFindsMateInOne)
+{
+    Engine engine = engineFromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    SearchResult result = engine.search(limits);
+
+    EXPECT_EQ(moveToString(result.bestMove), "a1a8");
+    ASSERT_EQ(result.score, MATE_SCORE - 1);
+}
+
+TEST(EngineTests, testTakesHangingQueen)
+{
+    Engine engine = engineFromFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    SearchResult result = engine.search(limits);
+
+    ASSERT_EQ(moveToString(result.bestMove), "d2d5");
+}
+
+TEST(EngineTests, testNoMoveWhenCheckmated)
+{
+    Engine engine = engineFromFEN("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1");
+    SearchResult result = engine.search(SearchLimits());
+
+    EXPECT_TRUE(result.bestMove.isNull());
+    ASSERT_EQ(result.score, -MATE_SCORE);
+}
+
+TEST(EngineTests, testStalemateScoresZero)
+{
+    Engine engine = engineFromFEN("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    SearchResult result = engine.search(SearchLimits());
+
+    EXPECT_TRUE(result.bestMove.isNull());
+    ASSERT_EQ(result.score, 0);
+}
+
+TEST(EngineTests, testNodeLimitStopsSearch)
+{
+    Engine engine = engineFromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    SearchLimits limits;
+    limits.maxNodes = 20000;
+    SearchResult result = engine.search(limits);
+
+    EXPECT_FALSE(result.bestMove.isNull());
+    EXPECT_LT(result.depth, 64);
+    ASSERT_LE(result.nodes, limits.maxNodes + 1);
+}
+
+TEST(EngineTests, testReportsPrincipalVariation)
+{
+    chessBoard board;
+    board.setupBoard();
+    Engine engine;
+    engine.setPosition(board.getPosition(), board.getUndoHistory());
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    std::ostringstream info;
+    SearchResult result = engine.search(limits, &info);
+
+    EXPECT_EQ(result.depth, 4);
+    EXPECT_EQ(result.principalVariation.size(), 4u);
+    EXPECT_EQ(result.principalVariation[0], result.bestMove);
+    EXPECT_NE(info.str().find("info depth 4 score cp"), std::string::npos);
+    ASSERT_NE(info.str().find(" nps "), std::string::npos);
+}
+
+TEST(EngineTests, testLazySmpFindsSameMate)
+{
+    Engine engine = engineFromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    engine.setThreads(4);
+    SearchLimits limits;
+    limits.maxDepth = 6;
+    SearchResult result = engine.search(limits);
+
+    EXPECT_EQ(engine.getThreads(), 4);
+    EXPECT_EQ(moveToString(result.bestMove), "a1a8");
+    ASSERT_EQ(result.score, MATE_SCORE - 1);
+}
+
+TEST(EngineTests, testLazySmpStopsOnTimeLimit)
+{
+    Engine engine = engineFromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    engine.setThreads(3);
+    SearchLimits limits;
+    limits.maxTimeMs = 100;
+    SearchResult result = engine.search(limits);
+
+    EXPECT_FALSE(result.bestMove.isNull());
+    EXPECT_GT(result.depth, 0);
+    ASSERT_LT(result.seconds, 2.0);
+}
@@ -0,0 +1,64 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/position.hpp"
+#include "../chessGameHeader/perft.hpp"
+
+//Walks the move tree and checks the running score against a full recompute at every node
+static void checkScores(Position& position, int depth)
+{
+    ASSERT_EQ(position.getEvaluation(), position.computeEvaluation());
+    if (depth == 0) {
+        return;
+    }
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves);
+    for (const Move& m : moves) {
+        UndoState undo;
+        position.makeMove(m, undo);
+        checkScores(position, depth - 1);
+        position.unmakeMove(undo);
+    }
+}
+
+TEST(EvaluationTests, testStartPositionIsBalanced)
+{
+    Position position;
+    position.loadFEN(perftSuite[0].fen);
+
+    EXPECT_EQ(position.getEvaluation(), 0);
+    EXPECT_EQ(position.getGamePhase(), MAX_PHASE);
+    EXPECT_EQ(position.getMaterialBalance(), 0);
+    ASSERT_EQ(position.getMaterial(Color::White), 8 * 100 + 2 * 320 + 2 * 330 + 2 * 500 + 900);
+}
+
+TEST(EvaluationTests, testRunningScoreMatchesRecompute)
+{
+    for (int i = 0; i < perftSuiteSize; ++i) {
+        Position position;
+        position.loadFEN(perftSuite[i].fen);
+        checkScores(position, 3);
+    }
+}
+
+TEST(EvaluationTests, testMirroredPositionNegatesScore)
+{
+    Position white;
+    white.loadFEN("4k3/8/8/8/3N4/8/4P3/4K3 w - - 0 1");
+    Position black;
+    black.loadFEN("4k3/4p3/8/3n4/8/8/8/4K3 b - - 0 1");
+
+    EXPECT_GT(white.getEvaluation(), 0);
+    ASSERT_EQ(white.getEvaluation(), -black.getEvaluation());
+}
+
+TEST(EvaluationTests, testEndgameKingPrefersCentre)
+{
+    Position corner;
+    corner.loadFEN("7k/8/8/8/8/8/8/K7 w - - 0 1");
+    Position centre;
+    centre.loadFEN("7k/8/8/8/3K4/8/8/8 w - - 0 1");
+
+    EXPECT_EQ(corner.getGamePhase(), 0);
+    ASSERT_GT(centre.getEvaluation(), corner.getEvaluation());
+}
@@ -0,0 +1,177 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/gameArchive.hpp"
+
+static const char* archivePath = "gameArchiveTest.cga";
+
+static Position fromFEN(const char* fen)
+{
+    Position position;
+    position.loadFEN(fen);
+    return position;
+}
+
+//Plays SAN moves from the game's start so the tests can write games the short way
+static ArchiveGame makeGame(const char* fen, std::initializer_list<const char*> sans, GameResult result)
+{
+    ArchiveGame game;
+    game.result = result;
+    game.tags.push_back({"Event", "Archive \"test\""});
+    Position position = fromFEN(fen ? fen : START_FEN);
+    if (fen){
+        game.tags.push_back({"FEN", fen});
+    }
+    for (const char* san : sans){
+        Move m = parseSan(san, position);
+        EXPECT_FALSE(m.isNull()) << san;
+        UndoState undo;
+        position.makeMove(m, undo);
+        game.moves.push_back(m);
+    }
+    return game;
+}
+
+TEST(GameArchiveTests, testDefaultCodeIsComplete)
+{
+    MoveCode code;
+    uint32_t kraft = 0;
+    for (int s = 0; s < ARCHIVE_SYMBOLS; ++s){
+        ASSERT_GE(code.length(s), 1);
+        ASSERT_LE(code.length(s), ARCHIVE_MAX_CODE_BITS);
+        kraft += 1u << (ARCHIVE_MAX_CODE_BITS - code.length(s));
+        int length;
+        EXPECT_EQ(code.decode(code.code(s) << (ARCHIVE_MAX_CODE_BITS - code.length(s)), length), s);
+        EXPECT_EQ(length, code.length(s));
+    }
+    EXPECT_EQ(kraft, 1u << ARCHIVE_MAX_CODE_BITS);
+    ASSERT_LT(code.length(0), code.length(40));
+}
+
+TEST(GameArchiveTests, testCodeFromCounts)
+{
+    uint64_t counts[ARCHIVE_SYMBOLS] = {};
+    counts[0] = 1000000;
+    counts[1] = 500000;
+    counts[2] = 10;
+    MoveCode code = MoveCode::fromCounts(counts);
+    EXPECT_EQ(code.length(0), 1);
+    EXPECT_EQ(code.length(1), 2);
+    EXPECT_LE(code.length(255), ARCHIVE_MAX_CODE_BITS);
+
+    MoveCode copy;
+    EXPECT_TRUE(copy.setLengths(code.getLengths()));
+    EXPECT_EQ(copy.code(2), code.code(2));
+    uint8_t incomplete[ARCHIVE_SYMBOLS] = {};
+    incomplete[0] = 1;
+    ASSERT_FALSE(copy.setLengths(incomplete));
+}
+
+TEST(GameArchiveTests, testRankMoves)
+{
+    MoveList ranked;
+    Position start = fromFEN(START_FEN);
+    rankMoves(start, ranked);
+    EXPECT_EQ(ranked.size(), 20);
+
+    //The capture of the queen beats the capture of the pawn, both beat quiet moves
+    Position captures = fromFEN("4k3/8/8/3p1q2/4P3/8/8/4K3 w - - 0 1");
+    rankMoves(captures, ranked);
+    EXPECT_EQ(ranked[0], Move(28, 37, CAPTURE));
+    ASSERT_EQ(ranked[1], Move(28, 35, CAPTURE));
+}
+
+TEST(GameArchiveTests, testWriteAndRead)
+{
+    std::vector<ArchiveGame> games;
+    games.push_back(makeGame(nullptr, {"e4", "e5", "Nf3", "Nc6", "Bb5", "a6", "Bxc6", "dxc6", "O-O"}, GameResult::Draw));
+    games.push_back(makeGame("r3k2r/P7/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1", {"exd6", "O-O-O", "a8=N", "Kd7", "O-O"}, GameResult::WhiteWin));
+    games.push_back(makeGame(nullptr, {}, GameResult::Unknown));
+
+    GameArchiveWriter writer;
+    ASSERT_TRUE(writer.open(archivePath));
+    for (const ArchiveGame& game : games){
+        ASSERT_TRUE(writer.add(game));
+    }
+    ArchiveGame illegal = games[0];
+    illegal.moves.push_back(Move(12, 28, DOUBLE_PAWN_PUSH));
+    EXPECT_FALSE(writer.add(illegal));
+    EXPECT_EQ(writer.size(), 3u);
+    ASSERT_TRUE(writer.close());
+
+    GameArchive archive;
+    ASSERT_TRUE(archive.load(archivePath));
+    ASSERT_EQ(archive.size(), 3u);
+    for (int n : {2, 0, 1}){
+        ArchiveGame read;
+        ASSERT_TRUE(archive.readGame(n, read));
+        EXPECT_EQ(read.tags, games[n].tags);
+        EXPECT_EQ(read.result, games[n].result);
+        EXPECT_EQ(read.moves, games[n].moves);
+    }
+    ArchiveGame header;
+    ASSERT_TRUE(archive.readHeader(1, header));
+    EXPECT_EQ(header.tag("Event"), "Archive \"test\"");
+    EXPECT_TRUE(header.moves.empty());
+    ASSERT_FALSE(archive.readGame(3, header));
+}
+
+TEST(GameArchiveTests, testRejectsDamagedFile)
+{
+    GameArchiveWriter writer;
+    ASSERT_TRUE(writer.open(archivePath));
+    writer.add(makeGame(nullptr, {"d4", "d5"}, GameResult::Draw));
+    ASSERT_TRUE(writer.close());
+
+    //Without its last byte the index magic is gone
+    std::ifstream in(archivePath, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(archivePath, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size() - 1);
+    out.close();
+
+    GameArchive archive;
+    ASSERT_FALSE(archive.load(archivePath));
+    ASSERT_FALSE(archive.load("noSuchArchive.cga"));
+}
+
+TEST(GameArchiveTests, testConvertPgn)
+{
+    const char* pgnPath = "gameArchiveTest.pgn";
+    {
+        std::ofstream out(pgnPath);
+        for (int i = 0; i < 20; ++i){
+            out << "[White \"Player " << i << "\"]\n[Result \"1-0\"]\n\n"
+                << "1. e4 e5 2. Nf3 Nc6 3. Bc4 Bc5 4. c3 Nf6 5. d4 exd4 6. cxd4 Bb4+ 7. Bd2 Bxd2+ "
+                << "8. Nbxd2 d5 9. exd5 Nxd5 10. Qb3 Na5 11. Qa4+ c6 12. Bxd5 Qxd5 1-0\n\n";
+        }
+        out << "[White \"Broken\"]\n\n1. e4 e5 2. Ke3 *\n";
+    }
+    uint64_t written, skipped;
+    ASSERT_TRUE(convertPgnToArchive(pgnPath, archivePath, true, written, skipped));
+    EXPECT_EQ(written, 20u);
+    EXPECT_EQ(skipped, 1u);
+
+    GameArchive archive;
+    ASSERT_TRUE(archive.load(archivePath));
+    ArchiveGame game;
+    ASSERT_TRUE(archive.readGame(19, game));
+    EXPECT_EQ(game.tag("White"), "Player 19");
+    EXPECT_EQ(game.result, GameResult::WhiteWin);
+    ASSERT_EQ(game.moves.size(), 24u);
+    EXPECT_EQ(game.moves.back(), Move(59, 35, CAPTURE));
+    //Every position stays inside the 256 ranks the code covers, and the fitted code puts
+    //a move in well under a byte
+    Position position = fromFEN(START_FEN);
+    MoveList ranked;
+    for (const Move& m : game.moves){
+        rankMoves(position, ranked);
+        EXPECT_LT(ranked.size(), 256);
+        UndoState undo;
+        position.makeMove(m, undo);
+    }
+    ASSERT_LT(archive.fileBytes(), 20u * (24 + 40) + ARCHIVE_HEADER_BYTES + ARCHIVE_TRAILER_BYTES + 20u * 8);
+}
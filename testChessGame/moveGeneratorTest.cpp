@@ -0,0 +1,144 @@
+#include <iostream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/chessBoard.hpp"
+#include "../chessGameHeader/attacks.hpp"
+
+//Builds a Position from the piece placement part of a FEN string
+static Position makePosition(const string& placement, int castling = 0, int enPassant = -1)
+{
+    Position position;
+    int rank = 7;
+    int file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            --rank;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        } else {
+            Color col = isupper(c) ? Color::White : Color::Black;
+            PieceType type = PieceType::none;
+            switch (tolower(c)) {
+                case 'p': type = PieceType::Pawn; break;
+                case 'n': type = PieceType::Knight; break;
+                case 'b': type = PieceType::Bishop; break;
+                case 'r': type = PieceType::Rook; break;
+                case 'q': type = PieceType::Queen; break;
+                case 'k': type = PieceType::King; break;
+            }
+            position.addPiece(col, type, rank * 8 + file);
+            ++file;
+        }
+    }
+    position.setCastlingRights(castling);
+    position.setEnPassantSquare(enPassant);
+    return position;
+}
+
+//Start Position Tests
+TEST(MoveGeneratorTests, testStartPositionWhite)
+{
+    chessBoard board;
+    board.setupBoard();
+    MoveList moves;
+    board.generateLegalMoves(Color::White, moves);
+
+    EXPECT_EQ(moves.size(), 20);
+}
+
+TEST(MoveGeneratorTests, testStartPositionNoCaptures)
+{
+    chessBoard board;
+    board.setupBoard();
+    MoveList moves;
+    board.generateLegalMoves(Color::Black, moves, GenStage::CAPTURES);
+
+    ASSERT_EQ(moves.size(), 0);
+}
+
+//Stage Tests
+TEST(MoveGeneratorTests, testKiwipeteStages)
+{
+    Position position = makePosition("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", ALL_CASTLING);
+    MoveList all;
+    MoveList captures;
+    MoveList quiets;
+    position.generateLegalMoves(Color::White, all);
+    position.generateLegalMoves(Color::White, captures, GenStage::CAPTURES);
+    position.generateLegalMoves(Color::White, quiets, GenStage::QUIETS);
+
+    EXPECT_EQ(all.size(), 48);
+    EXPECT_EQ(captures.size(), 8);
+    EXPECT_EQ(quiets.size(), 40);
+    EXPECT_TRUE(all.contains(Move(4, 6, KING_CASTLE)));
+    ASSERT_TRUE(all.contains(Move(4, 2, QUEEN_CASTLE)));
+}
+
+//Check & Pin Tests
+TEST(MoveGeneratorTests, testCheckEvasions)
+{
+    Position position = makePosition("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1", BLACK_KING_SIDE | BLACK_QUEEN_SIDE);
+    MoveList moves;
+    position.generateLegalMoves(Color::White, moves);
+
+    EXPECT_TRUE(position.isInCheck(Color::White));
+    EXPECT_EQ(moves.size(), 6);
+}
+
+TEST(MoveGeneratorTests, testPinnedRookStaysOnPin)
+{
+    //White rook on e2 is pinned by the black rook on e8
+    Position position = makePosition("4r2k/8/8/8/8/8/4R3/4K3");
+    MoveList moves;
+    position.generateLegalMoves(Color::White, moves);
+
+    for (const Move& m : moves) {
+        if (m.getFrom() == 12) {
+            EXPECT_EQ(colOf(m.getTo()), 4);
+        }
+    }
+    EXPECT_TRUE(moves.contains(Move(12, 60, CAPTURE)));
+}
+
+TEST(MoveGeneratorTests, testEnPassantHorizontalPin)
+{
+    //Taking en passant would leave both pawns off the fifth rank and expose the king to the rook
+    Position position = makePosition("8/8/8/KPp4r/8/8/8/7k", 0, 42);
+    MoveList moves;
+    position.generateLegalMoves(Color::White, moves);
+
+    EXPECT_FALSE(moves.contains(Move(33, 42, EN_PASSANT)));
+}
+
+TEST(MoveGeneratorTests, testEnPassantAllowed)
+{
+    Position position = makePosition("4k3/8/8/1Pp5/8/8/8/4K3", 0, 42);
+    MoveList moves;
+    position.generateLegalMoves(Color::White, moves, GenStage::CAPTURES);
+
+    ASSERT_TRUE(moves.contains(Move(33, 42, EN_PASSANT)));
+}
+
+TEST(MoveGeneratorTests, testPromotions)
+{
+    Position position = makePosition("1n2k3/P7/8/8/8/8/8/4K3");
+    MoveList quiets;
+    MoveList captures;
+    position.generateLegalMoves(Color::White, quiets, GenStage::QUIETS);
+    position.generateLegalMoves(Color::White, captures, GenStage::CAPTURES);
+
+    EXPECT_TRUE(quiets.contains(Move(48, 56, PROMOTION + 3)));
+    ASSERT_EQ(captures.size(), 4);
+}
+
+//chessBoard legality helpers
+TEST(MoveGeneratorTests, testBoardIsLegalMove)
+{
+    chessBoard board;
+    board.setupBoard();
+
+    EXPECT_TRUE(board.isLegalMove(6, 4, 4, 4));
+    EXPECT_FALSE(board.isLegalMove(7, 4, 6, 4));
+}
@@ -0,0 +1,110 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/engine.hpp"
+#include "../chessGameHeader/perft.hpp"
+
+static const char* networkPath = "nnueTestNetwork.bin";
+
+static void loadTestNetwork(Network& network)
+{
+    ASSERT_TRUE(writeRandomNetwork(networkPath, 2024));
+    ASSERT_TRUE(network.load(networkPath));
+}
+
+//Walks the move tree and checks the running accumulator against one built from scratch
+static void checkAccumulator(Position& position, int depth)
+{
+    Position rebuilt = position;
+    rebuilt.setNetwork(position.getNetwork());
+    ASSERT_EQ(memcmp(&position.getAccumulator(), &rebuilt.getAccumulator(), sizeof(Accumulator)), 0);
+    if (depth == 0) {
+        return;
+    }
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves);
+    for (const Move& m : moves) {
+        UndoState undo;
+        position.makeMove(m, undo);
+        checkAccumulator(position, depth - 1);
+        position.unmakeMove(undo);
+    }
+}
+
+TEST(NnueTests, testLoadRejectsBadFiles)
+{
+    Network network;
+    EXPECT_FALSE(network.load("noSuchNetwork.bin"));
+
+    FILE* file = fopen(networkPath, "wb");
+    fputs("not a network", file);
+    fclose(file);
+    EXPECT_FALSE(network.load(networkPath));
+    ASSERT_FALSE(network.isLoaded());
+}
+
+TEST(NnueTests, testLoadMapsNetwork)
+{
+    Network network;
+    loadTestNetwork(network);
+
+    ASSERT_TRUE(network.isLoaded());
+}
+
+TEST(NnueTests, testAccumulatorFollowsMoves)
+{
+    Network network;
+    loadTestNetwork(network);
+    for (int i = 0; i < 3; ++i) {
+        Position position;
+        position.setNetwork(&network);
+        position.loadFEN(perftSuite[i].fen);
+        checkAccumulator(position, 3);
+    }
+}
+
+TEST(NnueTests, testKernelsAgree)
+{
+    Network network;
+    loadTestNetwork(network);
+    SimdLevel best = detectSimdLevel();
+
+    Position position;
+    position.setNetwork(&network);
+    position.loadFEN(perftSuite[1].fen);
+    selectSimdLevel(SimdLevel::Scalar);
+    int scalarScore = network.evaluate(position.getAccumulator(), Color::White);
+
+    for (SimdLevel level : {SimdLevel::SSE41, SimdLevel::AVX2}) {
+        if (level > best) {
+            continue;
+        }
+        selectSimdLevel(level);
+        Position simd;
+        simd.setNetwork(&network);
+        simd.loadFEN(perftSuite[1].fen);
+        EXPECT_EQ(memcmp(&simd.getAccumulator(), &position.getAccumulator(), sizeof(Accumulator)), 0) << simdLevelName(level);
+        EXPECT_EQ(network.evaluate(simd.getAccumulator(), Color::White), scalarScore) << simdLevelName(level);
+    }
+    selectSimdLevel(best);
+    ASSERT_EQ(getSimdLevel(), best);
+}
+
+TEST(NnueTests, testEngineSearchesWithNetwork)
+{
+    Network network;
+    loadTestNetwork(network);
+    Position position;
+    position.loadFEN(perftSuite[0].fen);
+    Engine engine(1);
+    engine.setNetwork(&network);
+    engine.setPosition(position);
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    SearchResult result = engine.search(limits);
+
+    EXPECT_EQ(engine.evaluate(), network.evaluate(engine.getPosition().getAccumulator(), Color::White));
+    ASSERT_FALSE(result.bestMove.isNull());
+}
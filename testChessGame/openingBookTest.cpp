@@ -0,0 +1,128 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/engine.hpp"
+#include "../chessGameHeader/openingBook.hpp"
+#include "../chessGameHeader/perft.hpp"
+
+static const char* bookPath = "openingBookTest.bin";
+
+static Position startPosition()
+{
+    Position position;
+    position.loadFEN(perftSuite[0].fen);
+    return position;
+}
+
+//Start position with e2e4 weighted 3 to 1 over d2d4, and a reply to e2e4
+static void writeTestBook()
+{
+    Position position = startPosition();
+    std::vector<BookEntry> entries;
+    entries.push_back({polyglotKey(position), toPolyglotMove(Move(11, 27, DOUBLE_PAWN_PUSH)), 1, 0});
+    entries.push_back({polyglotKey(position), toPolyglotMove(Move(12, 28, DOUBLE_PAWN_PUSH)), 3, 0});
+    UndoState undo;
+    position.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH), undo);
+    entries.push_back({polyglotKey(position), toPolyglotMove(Move(50, 34, DOUBLE_PAWN_PUSH)), 5, 0});
+    //Keys the book never asks for, so the search has something to skip past
+    for (uint64_t i = 1; i <= 200; ++i) {
+        entries.push_back({i * 0x9E3779B97F4A7C15ULL, 1, 1, 0});
+    }
+    ASSERT_TRUE(writeBook(bookPath, entries));
+}
+
+//Keys published with the Polyglot book format
+TEST(OpeningBookTests, testPublishedPolyglotKeys)
+{
+    Position position = startPosition();
+    EXPECT_EQ(polyglotKey(position), 0x463b96181691fc9cULL);
+    UndoState undo;
+    position.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH), undo);
+    EXPECT_EQ(polyglotKey(position), 0x823c9b50fd114196ULL);
+
+    struct { const char* fen; uint64_t key; } published[] = {
+        {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0ULL},
+        {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4ULL},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78ULL},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1ULL},
+        {"rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9ULL},
+        {"rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637ULL},
+        {"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560ULL},
+    };
+    for (const auto& entry : published) {
+        Position fromFen;
+        ASSERT_TRUE(fromFen.loadFEN(entry.fen));
+        EXPECT_EQ(polyglotKey(fromFen), entry.key) << entry.fen;
+    }
+}
+
+TEST(OpeningBookTests, testCastlingMoveFormat)
+{
+    Position position;
+    position.loadFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    //The king takes its own rook in book format
+    EXPECT_EQ(toPolyglotMove(Move(4, 6, KING_CASTLE)), 7 | (4 << 6));
+    EXPECT_EQ(toPolyglotMove(Move(4, 2, QUEEN_CASTLE)), 0 | (4 << 6));
+    EXPECT_EQ(fromPolyglotMove(7 | (4 << 6), position), Move(4, 6, KING_CASTLE));
+    EXPECT_EQ(toPolyglotMove(Move(52, 60, PROMOTION + 3)), 60 | (52 << 6) | (4 << 12));
+    ASSERT_TRUE(fromPolyglotMove(12 | (20 << 6), position).isNull());
+}
+
+TEST(OpeningBookTests, testFindMoves)
+{
+    writeTestBook();
+    OpeningBook book;
+    EXPECT_FALSE(book.load("noSuchBook.bin"));
+    ASSERT_TRUE(book.load(bookPath));
+    EXPECT_EQ(book.size(), 203u);
+
+    BookMove moves[8];
+    int count = book.findMoves(startPosition(), moves, 8);
+    ASSERT_EQ(count, 2);
+    EXPECT_EQ(moves[0].move, Move(12, 28, DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(moves[0].weight, 3);
+    EXPECT_EQ(moves[1].move, Move(11, 27, DOUBLE_PAWN_PUSH));
+
+    Position outOfBook;
+    outOfBook.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    ASSERT_EQ(book.findMoves(outOfBook, moves, 8), 0);
+}
+
+TEST(OpeningBookTests, testSelection)
+{
+    writeTestBook();
+    OpeningBook book;
+    ASSERT_TRUE(book.load(bookPath));
+    uint64_t state = 7;
+    EXPECT_EQ(book.pickMove(startPosition(), BookSelection::Best, state), Move(12, 28, DOUBLE_PAWN_PUSH));
+
+    //Both moves come up, e2e4 about three times as often, and a seed replays the same picks
+    int kingPawn = 0;
+    uint64_t first = 42, second = 42;
+    for (int i = 0; i < 400; ++i) {
+        Move m = book.pickMove(startPosition(), BookSelection::WeightedRandom, first);
+        EXPECT_EQ(m, book.pickMove(startPosition(), BookSelection::WeightedRandom, second));
+        kingPawn += m == Move(12, 28, DOUBLE_PAWN_PUSH);
+    }
+    EXPECT_GT(kingPawn, 250);
+    ASSERT_LT(kingPawn, 350);
+}
+
+TEST(OpeningBookTests, testEnginePlaysBookMove)
+{
+    writeTestBook();
+    OpeningBook book;
+    ASSERT_TRUE(book.load(bookPath));
+    Engine engine(1);
+    engine.setBook(&book, BookSelection::Best);
+
+    Position position = startPosition();
+    UndoState undo;
+    position.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH), undo);
+    engine.setPosition(position);
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    SearchResult result = engine.search(limits);
+    EXPECT_EQ(result.bestMove, Move(50, 34, DOUBLE_PAWN_PUSH));
+    ASSERT_EQ(result.nodes, 0u);
+}
@@ -0,0 +1,181 @@
+#include <fstream>
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/openingExplorer.hpp"
+
+static const char* explorerArchivePath = "openingExplorerTest.cga";
+static const char* explorerPath = "openingExplorerTest.cge";
+
+struct StoredGame {
+    std::vector<const char*> sans;
+    GameResult result;
+    const char* whiteElo;
+    const char* blackElo;
+};
+
+static Position explorerStart()
+{
+    Position position;
+    position.loadFEN(START_FEN);
+    return position;
+}
+
+static Position playedFrom(std::initializer_list<const char*> sans)
+{
+    Position position = explorerStart();
+    for (const char* san : sans){
+        UndoState undo;
+        position.makeMove(parseSan(san, position), undo);
+    }
+    return position;
+}
+
+static void buildExplorer(const std::vector<ArchiveGame>& games, const OpeningExplorerOptions& options)
+{
+    GameArchiveWriter writer;
+    ASSERT_TRUE(writer.open(explorerArchivePath));
+    for (const ArchiveGame& game : games){
+        ASSERT_TRUE(writer.add(game));
+    }
+    ASSERT_TRUE(writer.close());
+    GameArchive archive;
+    ASSERT_TRUE(archive.load(explorerArchivePath));
+    ASSERT_TRUE(buildOpeningExplorer(archive, explorerPath, options));
+}
+
+static std::vector<ArchiveGame> storedGames(const std::vector<StoredGame>& stored)
+{
+    std::vector<ArchiveGame> games;
+    for (const StoredGame& s : stored){
+        ArchiveGame game;
+        game.result = s.result;
+        if (s.whiteElo){
+            game.tags.push_back({"WhiteElo", s.whiteElo});
+        }
+        if (s.blackElo){
+            game.tags.push_back({"BlackElo", s.blackElo});
+        }
+        Position position = explorerStart();
+        for (const char* san : s.sans){
+            Move m = parseSan(san, position);
+            UndoState undo;
+            position.makeMove(m, undo);
+            game.moves.push_back(m);
+        }
+        games.push_back(game);
+    }
+    return games;
+}
+
+static const std::vector<StoredGame> sampleGames = {
+    {{"e4", "e5", "Nf3"}, GameResult::WhiteWin, "2000", "1800"},
+    {{"e4", "c5"}, GameResult::BlackWin, "2200", nullptr},
+    {{"d4", "d5"}, GameResult::Draw, nullptr, "?"},
+    {{"e4", "e5"}, GameResult::Unknown, nullptr, nullptr},
+};
+
+TEST(OpeningExplorerTests, testBuildAndFind)
+{
+    buildExplorer(storedGames(sampleGames), OpeningExplorerOptions());
+    OpeningExplorer explorer;
+    ASSERT_TRUE(explorer.load(explorerPath));
+    EXPECT_EQ(explorer.size(), 4u);
+
+    ExplorerMove moves[8];
+    Position start = explorerStart();
+    ASSERT_EQ(explorer.findMoves(start, moves, 8), 2);
+    EXPECT_EQ(moves[0].move, parseSan("e4", start));
+    EXPECT_EQ(moves[0].games, 3u);
+    EXPECT_EQ(moves[0].whiteWins, 1u);
+    EXPECT_EQ(moves[0].blackWins, 1u);
+    EXPECT_DOUBLE_EQ(moves[0].score, 50.0);
+    EXPECT_EQ(moves[0].averageRating, 2100);
+    EXPECT_EQ(moves[1].move, parseSan("d4", start));
+    EXPECT_EQ(moves[1].draws, 1u);
+    EXPECT_EQ(moves[1].averageRating, 0);
+
+    //Black's moves are scored from black's side
+    Position afterE4 = playedFrom({"e4"});
+    ASSERT_EQ(explorer.findMoves(afterE4, moves, 8), 2);
+    EXPECT_EQ(moves[0].move, parseSan("e5", afterE4));
+    EXPECT_EQ(moves[0].games, 2u);
+    EXPECT_DOUBLE_EQ(moves[0].score, 0.0);
+    EXPECT_EQ(moves[0].averageRating, 1800);
+    EXPECT_EQ(moves[1].move, parseSan("c5", afterE4));
+    EXPECT_DOUBLE_EQ(moves[1].score, 100.0);
+
+    EXPECT_EQ(explorer.findMoves(playedFrom({"e4", "e5"}), moves, 8), 1);
+    EXPECT_EQ(explorer.findMoves(start, moves, 1), 1);
+    ASSERT_EQ(explorer.findMoves(playedFrom({"a4"}), moves, 8), 0);
+}
+
+TEST(OpeningExplorerTests, testOptions)
+{
+    OpeningExplorerOptions options;
+    options.maxPlies = 1;
+    options.minGames = 2;
+    buildExplorer(storedGames(sampleGames), options);
+    OpeningExplorer explorer;
+    ASSERT_TRUE(explorer.load(explorerPath));
+    EXPECT_EQ(explorer.size(), 1u);
+
+    ExplorerMove moves[8];
+    EXPECT_EQ(explorer.findMoves(explorerStart(), moves, 8), 1);
+    ASSERT_EQ(explorer.findMoves(playedFrom({"e4"}), moves, 8), 0);
+}
+
+TEST(OpeningExplorerTests, testFindsEveryStoredPosition)
+{
+    //Lines picked by a fixed pattern, enough positions for a tree of several levels
+    //that is not full
+    std::vector<ArchiveGame> games;
+    for (int i = 0; i < 40; ++i){
+        ArchiveGame game;
+        game.result = GameResult::Draw;
+        Position position = explorerStart();
+        for (int ply = 0; ply < 7; ++ply){
+            MoveList legal;
+            position.generateLegalMoves(position.getSideToMove(), legal);
+            Move m = legal[(i * 7 + ply * 3 + i * ply) % legal.size()];
+            UndoState undo;
+            position.makeMove(m, undo);
+            game.moves.push_back(m);
+        }
+        games.push_back(game);
+    }
+    buildExplorer(games, OpeningExplorerOptions());
+    OpeningExplorer explorer;
+    ASSERT_TRUE(explorer.load(explorerPath));
+    EXPECT_GT(explorer.size(), 100u);
+
+    ExplorerMove moves[64];
+    for (const ArchiveGame& game : games){
+        Position position = explorerStart();
+        for (const Move& m : game.moves){
+            int count = explorer.findMoves(position, moves, 64);
+            bool found = false;
+            for (int i = 0; i < count; ++i){
+                found = found || moves[i].move == m;
+            }
+            ASSERT_TRUE(found);
+            UndoState undo;
+            position.makeMove(m, undo);
+        }
+    }
+}
+
+TEST(OpeningExplorerTests, testRejectsDamagedFile)
+{
+    buildExplorer(storedGames(sampleGames), OpeningExplorerOptions());
+    std::ifstream in(explorerPath, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::ofstream out(explorerPath, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size() - 1);
+    out.close();
+
+    OpeningExplorer explorer;
+    ASSERT_FALSE(explorer.load(explorerPath));
+    ASSERT_FALSE(explorer.load(explorerArchivePath));
+}
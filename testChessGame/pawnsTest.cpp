@@ -0,0 +1,103 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/pawns.hpp"
+#include "../chessGameHeader/perft.hpp"
+
+static PawnEntry pawnsOf(const char* fen)
+{
+    Position position;
+    EXPECT_TRUE(position.loadFEN(fen));
+    PawnEntry entry;
+    evaluatePawns(position, entry);
+    return entry;
+}
+
+//Walks the move tree and checks the running pawn key against a full recompute at every node
+static void checkPawnKeys(Position& position, int depth)
+{
+    ASSERT_EQ(position.getPawnKey(), position.computePawnKey());
+    if (depth == 0) {
+        return;
+    }
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves);
+    for (const Move& m : moves) {
+        UndoState undo;
+        position.makeMove(m, undo);
+        checkPawnKeys(position, depth - 1);
+        position.unmakeMove(undo);
+    }
+}
+
+TEST(PawnsTests, testPawnKeyFollowsMoves)
+{
+    for (int i = 0; i < perftSuiteSize; ++i) {
+        Position position;
+        position.loadFEN(perftSuite[i].fen);
+        checkPawnKeys(position, 3);
+    }
+}
+
+TEST(PawnsTests, testPawnKeyIgnoresPieces)
+{
+    Position position;
+    position.loadFEN(perftSuite[0].fen);
+    uint64_t before = position.getPawnKey();
+    UndoState undo;
+    position.makeMove(Move(6, 21), undo);
+
+    ASSERT_EQ(position.getPawnKey(), before);
+}
+
+TEST(PawnsTests, testStartPositionIsEven)
+{
+    PawnEntry entry = pawnsOf(perftSuite[0].fen);
+
+    EXPECT_EQ(entry.midgame, 0);
+    EXPECT_EQ(entry.endgame, 0);
+    ASSERT_EQ(entry.passedPawns[0] | entry.passedPawns[1], 0ULL);
+}
+
+TEST(PawnsTests, testPassedPawnFound)
+{
+    //White's d5 pawn has no black pawn in front of it on c, d or e
+    PawnEntry entry = pawnsOf("4k3/p7/8/3P4/8/8/8/4K3 w - - 0 1");
+
+    EXPECT_EQ(entry.passedPawns[static_cast<int>(Color::White)], squareBit(35));
+    ASSERT_EQ(entry.passedPawns[static_cast<int>(Color::Black)], squareBit(48));
+}
+
+TEST(PawnsTests, testDoubledAndIsolatedPenalised)
+{
+    //Both d pawns are passed and isolated, the second one is also doubled
+    PawnEntry doubled = pawnsOf("4k3/8/8/8/8/3P4/3P4/4K3 w - - 0 1");
+    PawnEntry single = pawnsOf("4k3/8/8/8/8/8/3P4/4K3 w - - 0 1");
+
+    EXPECT_EQ(single.endgame, 10 - 15);
+    ASSERT_EQ(doubled.endgame, 10 + 20 - 2 * 15 - 20);
+}
+
+TEST(PawnsTests, testBackwardPawnPenalised)
+{
+    //d3 cannot be supported by c4 or e4 and d4 is guarded by the pawn on e5
+    PawnEntry backward = pawnsOf("4k3/8/8/4p3/2P5/3P4/8/4K3 w - - 0 1");
+    PawnEntry supported = pawnsOf("4k3/8/8/4p3/2P5/8/3P4/4K3 w - - 0 1");
+
+    ASSERT_EQ(backward.midgame, supported.midgame - 8);
+}
+
+TEST(PawnsTests, testTableHitsOnSameStructure)
+{
+    PawnTable table(1024);
+    Position position;
+    position.loadFEN(perftSuite[0].fen);
+    const PawnEntry& first = table.probe(position);
+    UndoState undo;
+    position.makeMove(Move(6, 21), undo);
+    const PawnEntry& second = table.probe(position);
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ(table.getProbes(), 2u);
+    ASSERT_EQ(table.getHits(), 1u);
+}
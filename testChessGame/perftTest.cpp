@@ -0,0 +1,73 @@
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/perft.hpp"
+
+static uint64_t perftFromFEN(const char* fen, int depth)
+{
+    Position position;
+    EXPECT_TRUE(position.loadFEN(fen));
+    return perft(position, depth);
+}
+
+//Shallow versions of the reference suite, the perft target runs them deeper
+TEST(PerftTests, testStartPosition)
+{
+    EXPECT_EQ(perftFromFEN(perftSuite[0].fen, 1), 20ULL);
+    EXPECT_EQ(perftFromFEN(perftSuite[0].fen, 2), 400ULL);
+    ASSERT_EQ(perftFromFEN(perftSuite[0].fen, 3), 8902ULL);
+}
+
+TEST(PerftTests, testKiwipete)
+{
+    ASSERT_EQ(perftFromFEN(perftSuite[1].fen, 3), 97862ULL);
+}
+
+TEST(PerftTests, testPosition3)
+{
+    ASSERT_EQ(perftFromFEN(perftSuite[2].fen, 4), 43238ULL);
+}
+
+TEST(PerftTests, testPosition4)
+{
+    ASSERT_EQ(perftFromFEN(perftSuite[3].fen, 3), 9467ULL);
+}
+
+TEST(PerftTests, testPosition5)
+{
+    ASSERT_EQ(perftFromFEN(perftSuite[4].fen, 3), 62379ULL);
+}
+
+TEST(PerftTests, testPosition6)
+{
+    ASSERT_EQ(perftFromFEN(perftSuite[5].fen, 3), 89890ULL);
+}
+
+//Divide Tests
+TEST(PerftTests, testDivideTotals)
+{
+    Position position;
+    position.loadFEN(perftSuite[0].fen);
+    std::ostringstream out;
+
+    EXPECT_EQ(perftDivide(position, 2, out), 400ULL);
+    ASSERT_NE(out.str().find("e2e4: 20"), std::string::npos);
+}
+
+//loadFEN Tests
+TEST(PerftTests, testLoadFENState)
+{
+    Position position;
+    position.loadFEN("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR b Kq e3 0 2");
+
+    EXPECT_EQ(position.getSideToMove(), Color::Black);
+    EXPECT_EQ(position.getCastlingRights(), WHITE_KING_SIDE | BLACK_QUEEN_SIDE);
+    ASSERT_EQ(position.getEnPassantSquare(), 20);
+}
+
+TEST(PerftTests, testLoadFENInvalid)
+{
+    Position position;
+    ASSERT_FALSE(position.loadFEN("rnbqkxnr/8/8/8/8/8/8/8 w - -"));
+}
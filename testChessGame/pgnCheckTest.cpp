@@ -0,0 +1,119 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/pgnCheck.hpp"
+#include "../chessGameHeader/boundedQueue.hpp"
+
+TEST(PgnCheckTests, testQueueOrderAndCapacity)
+{
+    BoundedQueue<int> queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+    for (int i = 0; i < 4; ++i){
+        ASSERT_TRUE(queue.tryPush(i));
+    }
+    int value = 99;
+    EXPECT_FALSE(queue.tryPush(value));
+    EXPECT_EQ(value, 99);
+    for (int i = 0; i < 4; ++i){
+        ASSERT_TRUE(queue.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.tryPop(value));
+}
+
+//Several pushers and poppers at once, every value has to come out exactly once
+TEST(PgnCheckTests, testQueueAcrossThreads)
+{
+    BoundedQueue<int> queue(16);
+    const int perThread = 20000;
+    std::vector<std::thread> threads;
+    std::vector<long long> sums(2, 0);
+    for (int t = 0; t < 2; ++t){
+        threads.emplace_back([&queue, t](){
+            for (int i = 1; i <= perThread; ++i){
+                int value = i;
+                while (!queue.tryPush(value)){
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int t = 0; t < 2; ++t){
+        threads.emplace_back([&queue, &sums, t](){
+            int value;
+            for (int taken = 0; taken < perThread;){
+                if (queue.tryPop(value)){
+                    sums[t] += value;
+                    ++taken;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    ASSERT_EQ(sums[0] + sums[1], 2LL * perThread * (perThread + 1) / 2);
+}
+
+TEST(PgnCheckTests, testGameChecker)
+{
+    std::string text =
+        "[Event \"fine\"]\n\n1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 1/2-1/2\n\n"
+        "[Event \"illegal\"]\n\n1. e4 e5 2. Ke3 *\n\n"
+        "[FEN \"8/8/8/8 w - - 0 1\"]\n\n1. e4 *\n\n"
+        "[FEN \"4k3/8/8/8/8/8/4P3/4K3 b - - 0 1\"]\n\n1... Kd7 2. e4 *\n\n";
+    GameChecker checker;
+    std::vector<GameVerdict> verdicts;
+    PgnScanner scanner(text);
+    PgnGameView game;
+    while (scanner.next(game)){
+        verdicts.push_back(checker.check(game, verdicts.size()));
+    }
+    ASSERT_EQ(verdicts.size(), 4u);
+    EXPECT_EQ(verdicts[0].status, GameStatus::Ok);
+    EXPECT_EQ(verdicts[0].plies, 6);
+    EXPECT_EQ(verdicts[1].status, GameStatus::IllegalMove);
+    EXPECT_EQ(verdicts[1].plies, 2);
+    EXPECT_EQ(verdicts[1].index, 1u);
+    EXPECT_EQ(text.substr(verdicts[1].offset, 17), "[Event \"illegal\"]");
+    EXPECT_EQ(verdicts[2].status, GameStatus::BadStart);
+    EXPECT_EQ(verdicts[3].status, GameStatus::Ok);
+    ASSERT_EQ(verdicts[3].plies, 2);
+}
+
+//Verdicts come out in file order however the batches are shared out
+TEST(PgnCheckTests, testPipelineKeepsOrder)
+{
+    std::string text;
+    for (int i = 0; i < 500; ++i){
+        text += "[Round \"" + std::to_string(i) + "\"]\n\n";
+        text += i % 7 == 3 ? "1. d4 d5 2. Bxd5 *\n\n" : "1. d4 d5 2. c4 e6 3. Nc3 Nf6 *\n\n";
+    }
+    PgnCheckOptions options;
+    options.threads = 4;
+    options.batchSize = 3;
+    options.queueSize = 2;
+    std::vector<GameVerdict> verdicts;
+    PgnCheckSummary summary = checkPgn(text, options, [&](const GameVerdict& verdict){
+        verdicts.push_back(verdict);
+    });
+
+    ASSERT_EQ(verdicts.size(), 500u);
+    EXPECT_EQ(summary.games, 500u);
+    EXPECT_EQ(summary.failed, 71u);
+    for (size_t i = 0; i < verdicts.size(); ++i){
+        ASSERT_EQ(verdicts[i].index, i);
+        EXPECT_EQ(text.substr(verdicts[i].offset, 8 + std::to_string(i).size()), "[Round \"" + std::to_string(i));
+        EXPECT_EQ(verdicts[i].status, i % 7 == 3 ? GameStatus::IllegalMove : GameStatus::Ok);
+    }
+    EXPECT_EQ(summary.plies, 71u * 2 + 429u * 6);
+
+    PgnCheckSummary empty = checkPgn("", options, [](const GameVerdict&){});
+    ASSERT_EQ(empty.games, 0u);
+}
@@ -0,0 +1,242 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/pgn.hpp"
+
+static const char* twoGames =
+    "[Event \"Test \\\"one\\\"\"]\n"
+    "[White \"A\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 e5 2. Nf3 {a comment} Nc6 3. Bb5 (3. Bc4 Bc5) a6 $1 4. Ba4 Nf6 5. O-O Be7 1-0\n"
+    "\n"
+    "[Event \"Two\"]\n"
+    "[Result \"1/2-1/2\"]\n"
+    "[FEN \"4k3/P7/8/8/8/8/8/4K3 w - - 0 1\"]\n"
+    "\n"
+    "1.a8=Q+ Kd7 1/2-1/2\n";
+
+static Position fromFEN(const char* fen)
+{
+    Position position;
+    position.loadFEN(fen);
+    return position;
+}
+
+TEST(PgnTests, testReaderSplitsGames)
+{
+    std::istringstream in(twoGames);
+    PgnReader reader(in);
+    PgnGame game;
+
+    ASSERT_TRUE(reader.next(game));
+    EXPECT_EQ(game.tag("Event"), "Test \"one\"");
+    EXPECT_EQ(game.tag("White"), "A");
+    EXPECT_EQ(game.tag("Black"), "");
+    EXPECT_EQ(game.result, GameResult::WhiteWin);
+
+    ASSERT_TRUE(reader.next(game));
+    EXPECT_EQ(game.tag("Event"), "Two");
+    EXPECT_EQ(game.result, GameResult::Draw);
+    ASSERT_FALSE(reader.next(game));
+}
+
+TEST(PgnTests, testParseSan)
+{
+    Position start = fromFEN(START_FEN);
+    EXPECT_EQ(parseSan("e4", start), Move(12, 28, DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(parseSan("Nf3", start), Move(6, 21));
+    EXPECT_TRUE(parseSan("e5", start).isNull());
+    EXPECT_TRUE(parseSan("Ke2", start).isNull());
+
+    //Two knights can reach d2, the file decides
+    Position knights = fromFEN("4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1");
+    EXPECT_TRUE(parseSan("Nd2", knights).isNull());
+    EXPECT_EQ(parseSan("Nbd2", knights), Move(1, 11));
+    EXPECT_EQ(parseSan("Nfd2", knights), Move(5, 11));
+
+    Position castle = fromFEN("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1");
+    EXPECT_EQ(parseSan("O-O-O", castle), Move(60, 58, QUEEN_CASTLE));
+    EXPECT_EQ(parseSan("0-0", castle), Move(60, 62, KING_CASTLE));
+
+    Position promotion = fromFEN("1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(parseSan("axb8=N", promotion), Move(48, 57, PROMOTION_CAPTURE + 0));
+    EXPECT_EQ(parseSan("a8Q+", promotion), Move(48, 56, PROMOTION + 3));
+    ASSERT_TRUE(parseSan("a8", promotion).isNull());
+}
+
+TEST(PgnTests, testPlayMovetext)
+{
+    std::istringstream in(twoGames);
+    PgnReader reader(in);
+    PgnGame game;
+    Position position;
+    std::vector<Move> moves;
+
+    reader.next(game);
+    ASSERT_TRUE(playMovetext(game, position, moves));
+    EXPECT_EQ(moves.size(), 10u);
+    //The variation is skipped, so the last move is black's Be7
+    EXPECT_EQ(moves[4], Move(5, 33));
+    EXPECT_EQ(moves.back(), Move(61, 52));
+    EXPECT_EQ(position.getSideToMove(), Color::White);
+
+    ASSERT_TRUE(playMovetext(game, position, moves, 3));
+    EXPECT_EQ(moves.size(), 3u);
+
+    reader.next(game);
+    ASSERT_TRUE(playMovetext(game, position, moves));
+    EXPECT_EQ(moves.size(), 2u);
+    EXPECT_EQ(position.pieceTypeAt(56), PieceType::Queen);
+
+    game.movetext = "1. e4 e5 2. Ke3 *";
+    game.tags.clear();
+    EXPECT_FALSE(playMovetext(game, position, moves));
+    ASSERT_EQ(moves.size(), 2u);
+}
+
+//Every legal move written as SAN has to read back as the same move
+TEST(PgnTests, testSanRoundTrip)
+{
+    const char* fens[] = {
+        START_FEN,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "1k6/8/8/8/8/8/8/Q3Q1KQ w - - 0 1"
+    };
+    for (const char* fen : fens){
+        Position position = fromFEN(fen);
+        MoveList moves;
+        position.generateLegalMoves(position.getSideToMove(), moves);
+        for (const Move& m : moves){
+            EXPECT_EQ(parseSan(moveToSan(m, position), position), m) << fen << " " << moveToSan(m, position);
+        }
+    }
+}
+
+TEST(PgnTests, testMoveToSan)
+{
+    Position knights = fromFEN("4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1");
+    EXPECT_EQ(moveToSan(Move(1, 11), knights), "Nbd2");
+    EXPECT_EQ(moveToSan(Move(1, 16), knights), "Na3");
+
+    Position rooks = fromFEN("7k/8/R7/8/8/8/R7/4K3 w - - 0 1");
+    EXPECT_EQ(moveToSan(Move(40, 32), rooks), "R6a5");
+
+    //Queens on a1, c1 and a3 can all reach b2
+    Position queens = fromFEN("6k1/8/8/8/8/Q7/8/Q1Q1K3 w - - 0 1");
+    EXPECT_EQ(moveToSan(Move(0, 9), queens), "Qa1b2");
+    EXPECT_EQ(moveToSan(Move(16, 9), queens), "Q3b2");
+
+    Position mate = fromFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+    EXPECT_EQ(moveToSan(Move(0, 56), mate), "Ra8#");
+    EXPECT_EQ(moveToSan(Move(6, 7), mate), "Kh1");
+
+    Position promotion = fromFEN("1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+    EXPECT_EQ(moveToSan(Move(48, 57, PROMOTION_CAPTURE + 3), promotion), "axb8=Q+");
+
+    Position enPassant = fromFEN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+    ASSERT_EQ(moveToSan(Move(36, 45, EN_PASSANT), enPassant), "exf6");
+}
+
+TEST(PgnTests, testScannerViews)
+{
+    std::string text = twoGames;
+    PgnScanner scanner(text);
+    PgnGameView game;
+
+    ASSERT_TRUE(scanner.next(game));
+    EXPECT_EQ(game.offset, 0u);
+    EXPECT_EQ(game.tag("Event"), "Test \\\"one\\\"");
+    EXPECT_EQ(game.tag("White"), "A");
+    EXPECT_EQ(game.result, GameResult::WhiteWin);
+    EXPECT_EQ(game.movetext.substr(0, 8), "1. e4 e5");
+    EXPECT_EQ(game.movetext.substr(game.movetext.size() - 3), "1-0");
+    //Views point into the text, nothing was copied
+    EXPECT_TRUE(game.movetext.data() > text.data() && game.movetext.data() < text.data() + text.size());
+
+    ASSERT_TRUE(scanner.next(game));
+    EXPECT_EQ(text.substr(game.offset, 14), "[Event \"Two\"]\n");
+    Position position;
+    std::vector<Move> moves;
+    ASSERT_TRUE(playMovetext(game, position, moves));
+    EXPECT_EQ(moves.size(), 2u);
+    ASSERT_FALSE(scanner.next(game));
+}
+
+TEST(PgnTests, testScannerEdgeCases)
+{
+    std::string text =
+        "% a comment line\r\n"
+        "[Event \"a\"]\r\n"
+        "\r\n"
+        "1. d4 {a comment\r\n"
+        "[that looks like a tag]} d5 0-1\r\n"
+        "\r\n"
+        "1. c4 *\n";
+    std::vector<std::string> events;
+    std::vector<GameResult> results;
+    std::vector<std::string_view> movetexts;
+    for (const PgnGameView& game : PgnScanner(text)){
+        events.emplace_back(game.tag("Event"));
+        results.push_back(game.result);
+        movetexts.push_back(game.movetext);
+    }
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0], "a");
+    EXPECT_EQ(results[0], GameResult::BlackWin);
+    EXPECT_EQ(movetexts[0].back(), '1');
+    //The termination marker ends the first game, so the second needs no tags
+    EXPECT_EQ(events[1], "");
+    EXPECT_EQ(results[1], GameResult::Unknown);
+    ASSERT_EQ(movetexts[1], "1. c4 *");
+}
+
+TEST(PgnTests, testSplitAtGames)
+{
+    std::string text;
+    for (int i = 0; i < 50; ++i){
+        text += "[Event \"" + std::to_string(i) + "\"]\n[Result \"*\"]\n\n1. e4 {a comment with\n[%clk 0:01:00]} e5 *\n\n";
+    }
+    std::vector<std::string_view> pieces = splitAtGames(text, 7);
+    ASSERT_EQ(pieces.size(), 7u);
+    size_t covered = 0;
+    int games = 0;
+    for (std::string_view piece : pieces){
+        EXPECT_EQ(piece.data(), text.data() + covered);
+        EXPECT_EQ(piece.substr(0, 7), "[Event ");
+        covered += piece.size();
+        PgnScanner scanner(piece);
+        PgnGameView game;
+        while (scanner.next(game)){
+            ++games;
+        }
+    }
+    EXPECT_EQ(covered, text.size());
+    EXPECT_EQ(games, 50);
+
+    EXPECT_EQ(splitAtGames(text.substr(0, 60), 8).size(), 1u);
+    ASSERT_EQ(splitAtGames("", 4).size(), 1u);
+}
+
+TEST(PgnTests, testPgnFile)
+{
+    const char* path = "pgnTest.pgn";
+    {
+        std::ofstream out(path);
+        out << twoGames;
+    }
+    PgnFile file;
+    ASSERT_TRUE(file.load(path));
+    EXPECT_EQ(file.text(), twoGames);
+    int games = 0;
+    for (const PgnGameView& game : PgnScanner(file.text())){
+        games += game.tags.empty() ? 0 : 1;
+    }
+    EXPECT_EQ(games, 2);
+    ASSERT_FALSE(file.load("noSuchGames.pgn"));
+}
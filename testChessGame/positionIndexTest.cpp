@@ -0,0 +1,125 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/positionIndex.hpp"
+
+static const char* indexArchivePath = "positionIndexTest.cga";
+static const char* indexPath = "positionIndexTest.cgp";
+
+static Position playedFrom(std::initializer_list<const char*> sans, std::vector<Move>* moves = nullptr)
+{
+    Position position;
+    position.loadFEN(START_FEN);
+    for (const char* san : sans){
+        Move m = parseSan(san, position);
+        EXPECT_FALSE(m.isNull()) << san;
+        UndoState undo;
+        position.makeMove(m, undo);
+        if (moves){
+            moves->push_back(m);
+        }
+    }
+    return position;
+}
+
+static void writeArchive(const std::vector<std::vector<const char*>>& lines)
+{
+    GameArchiveWriter writer;
+    ASSERT_TRUE(writer.open(indexArchivePath));
+    for (size_t i = 0; i < lines.size(); ++i){
+        ArchiveGame game;
+        game.tags.push_back({"White", "Player " + std::to_string(i)});
+        game.result = GameResult::Draw;
+        Position position;
+        position.loadFEN(START_FEN);
+        for (const char* san : lines[i]){
+            Move m = parseSan(san, position);
+            UndoState undo;
+            position.makeMove(m, undo);
+            game.moves.push_back(m);
+        }
+        ASSERT_TRUE(writer.add(game));
+    }
+    ASSERT_TRUE(writer.close());
+}
+
+static std::string fileBytes(const char* path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+TEST(PositionIndexTests, testBuildAndFind)
+{
+    writeArchive({{"e4", "e6", "d4", "d5"}, {"d4", "e6", "e4", "c5"}, {"c4", "e5"}, {"e4", "e6", "Nf3"}});
+    GameArchive archive;
+    ASSERT_TRUE(archive.load(indexArchivePath));
+
+    PositionIndexOptions options;
+    ASSERT_TRUE(buildPositionIndex(archive, indexPath, options));
+    std::string inMemory = fileBytes(indexPath);
+    //Runs of three entries force the merge to do the sorting
+    options.runEntries = 3;
+    ASSERT_TRUE(buildPositionIndex(archive, indexPath, options));
+    EXPECT_EQ(fileBytes(indexPath), inMemory);
+    EXPECT_EQ(fopen((std::string(indexPath) + ".run0").c_str(), "rb"), nullptr);
+
+    PositionIndex index;
+    ASSERT_TRUE(index.load(indexPath));
+    EXPECT_EQ(index.hits(), 17u);
+    std::vector<PositionHit> hits;
+    EXPECT_EQ(index.find(playedFrom({}), hits), 4u);
+    ASSERT_EQ(hits.size(), 4u);
+    for (uint32_t i = 0; i < 4; ++i){
+        EXPECT_EQ(hits[i].game, i);
+        EXPECT_EQ(hits[i].ply, 0);
+    }
+
+    EXPECT_EQ(index.find(playedFrom({"e4", "e6", "d4"}), hits), 2u);
+    ASSERT_EQ(hits.size(), 2u);
+    EXPECT_EQ(hits[0].game, 0u);
+    EXPECT_EQ(hits[1].game, 1u);
+    EXPECT_EQ(hits[1].ply, 3);
+    EXPECT_EQ(index.count(playedFrom({"e4", "e6"}).getHashKey()), 2u);
+
+    EXPECT_EQ(index.find(playedFrom({"e4", "e6"}), hits, 1), 2u);
+    EXPECT_EQ(hits.size(), 1u);
+    EXPECT_EQ(index.find(playedFrom({"a4"}), hits), 0u);
+    ASSERT_TRUE(hits.empty());
+}
+
+TEST(PositionIndexTests, testMaxPlies)
+{
+    writeArchive({{"e4", "e5", "Nf3", "Nc6"}});
+    GameArchive archive;
+    ASSERT_TRUE(archive.load(indexArchivePath));
+    PositionIndexOptions options;
+    options.maxPlies = 2;
+    ASSERT_TRUE(buildPositionIndex(archive, indexPath, options));
+
+    PositionIndex index;
+    ASSERT_TRUE(index.load(indexPath));
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_EQ(index.count(playedFrom({"e4", "e5"}).getHashKey()), 1u);
+    ASSERT_EQ(index.count(playedFrom({"e4", "e5", "Nf3"}).getHashKey()), 0u);
+}
+
+TEST(PositionIndexTests, testRejectsDamagedFile)
+{
+    writeArchive({{"e4"}});
+    GameArchive archive;
+    ASSERT_TRUE(archive.load(indexArchivePath));
+    ASSERT_TRUE(buildPositionIndex(archive, indexPath, PositionIndexOptions()));
+
+    std::string bytes = fileBytes(indexPath);
+    std::ofstream out(indexPath, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size() - 1);
+    out.close();
+
+    PositionIndex index;
+    ASSERT_FALSE(index.load(indexPath));
+    EXPECT_FALSE(index.isLoaded());
+    ASSERT_FALSE(index.load(indexArchivePath));
+}
@@ -0,0 +1,215 @@
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/chessBoard.hpp"
+#include "../piecesHeader/knight.hpp"
+#include "../piecesHeader/rook.hpp"
+
+//Test Default Constructor
+TEST(PositionTests, testDefaultConstructorEmpty)
+{
+    Position position;
+    EXPECT_EQ(position.getOccupancy(), 0ULL);
+}
+
+//addPiece & removePiece Tests
+TEST(PositionTests, testAddPiece)
+{
+    Position position;
+    position.addPiece(Color::White, PieceType::Knight, squareIndex(7, 1));
+
+    EXPECT_TRUE(position.isOccupied(squareIndex(7, 1)));
+    EXPECT_EQ(position.pieceTypeAt(squareIndex(7, 1)), PieceType::Knight);
+    ASSERT_EQ(position.colorAt(squareIndex(7, 1)), Color::White);
+}
+
+TEST(PositionTests, testRemovePiece)
+{
+    Position position;
+    position.addPiece(Color::Black, PieceType::Rook, 63);
+    position.removePiece(Color::Black, PieceType::Rook, 63);
+
+    EXPECT_EQ(position.getPieces(Color::Black), 0ULL);
+    ASSERT_EQ(position.pieceTypeAt(63), PieceType::none);
+}
+
+TEST(PositionTests, testMovePiece)
+{
+    Position position;
+    position.addPiece(Color::White, PieceType::Rook, 0);
+    position.movePiece(Color::White, PieceType::Rook, 0, 8);
+
+    EXPECT_FALSE(position.isOccupied(0));
+    ASSERT_EQ(position.getPieces(Color::White, PieceType::Rook), squareBit(8));
+}
+
+//chessBoard keeps its bitboards in step with the squares
+TEST(PositionTests, testBoardSetupOccupancy)
+{
+    chessBoard board;
+    board.setupBoard();
+
+    EXPECT_EQ(popCount(board.getPosition().getOccupancy()), 32);
+    EXPECT_EQ(board.getPosition().getPieces(Color::White, PieceType::Pawn), 0xFF00ULL);
+    ASSERT_EQ(board.getPosition().getPieces(Color::Black, PieceType::King), squareBit(60));
+}
+
+TEST(PositionTests, testBoardSetPieceThroughSquare)
+{
+    chessBoard board;
+    board.getSquare(0, 0).setPiece(make_unique<Knight>(Color::White));
+
+    EXPECT_TRUE(board.isOccupied(0, 0));
+
+    board.getSquare(0, 0).clearSquare();
+
+    ASSERT_FALSE(board.isOccupied(0, 0));
+}
+
+TEST(PositionTests, testBoardMovePiece)
+{
+    chessBoard board;
+    board.getSquare(7, 0).setPiece(make_unique<Rook>(Color::White));
+    board.movePiece(7, 0, 3, 0);
+
+    EXPECT_FALSE(board.isOccupied(7, 0));
+    ASSERT_EQ(board.getPosition().pieceTypeAt(squareIndex(3, 0)), PieceType::Rook);
+}
+
+TEST(PositionTests, testPositionIsTriviallyCopyable)
+{
+    static_assert(std::is_trivially_copyable<Position>::value, "Position must copy as plain bytes");
+    static_assert(sizeof(PieceCode) == 1, "a piece code is a single byte");
+}
+
+TEST(PositionTests, testMailboxFollowsBitboards)
+{
+    Position position;
+    position.addPiece(makePieceCode(Color::Black, PieceType::Queen), 27);
+    position.movePiece(Color::Black, PieceType::Queen, 27, 35);
+
+    EXPECT_EQ(position.pieceCodeAt(27), NO_PIECE);
+    EXPECT_EQ(position.pieceTypeAt(35), PieceType::Queen);
+    EXPECT_EQ(position.colorAt(35), Color::Black);
+
+    position.clearSquare(35);
+
+    ASSERT_EQ(position.pieceCodeAt(35), NO_PIECE);
+}
+
+TEST(PositionTests, testPieceCodeTables)
+{
+    PieceCode whiteKnight = makePieceCode(Color::White, PieceType::Knight);
+
+    EXPECT_EQ(pieceTypeOf(whiteKnight), PieceType::Knight);
+    EXPECT_EQ(pieceColorOf(whiteKnight), Color::White);
+    EXPECT_EQ(pieceSymbolTable[whiteKnight], 'N');
+    EXPECT_EQ(pieceValueTable[whiteKnight], 320);
+    EXPECT_EQ(pieceMovementTable[whiteKnight], Movement::Leaper);
+    ASSERT_EQ(pieceColorOf(NO_PIECE), Color::none);
+}
+
+TEST(PositionTests, testFENRoundTrip)
+{
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b Kq e3 0 3",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 17 62"
+    };
+    Position position;
+    char buffer[FEN_MAX_LENGTH];
+    for (const char* fen : fens){
+        ASSERT_TRUE(position.loadFEN(fen));
+        EXPECT_EQ(position.writeFEN(buffer), static_cast<int>(strlen(fen)));
+        EXPECT_STREQ(buffer, fen);
+    }
+    EXPECT_EQ(position.getHalfmoveClock(), 17);
+    ASSERT_EQ(position.getFullmoveNumber(), 62);
+}
+
+TEST(PositionTests, testFENCountersOptional)
+{
+    Position position;
+    ASSERT_TRUE(position.loadFEN("4k3/8/8/8/8/8/8/4K3 b - -"));
+    EXPECT_EQ(position.getHalfmoveClock(), 0);
+    EXPECT_EQ(position.getFullmoveNumber(), 1);
+    ASSERT_EQ(position.toFEN(), "4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+}
+
+TEST(PositionTests, testFENRejectsMalformed)
+{
+    Position position;
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K2 w - - 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K3/8 w - - 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K3 x - - 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K3 w - e9 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 0"));
+    ASSERT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - x 1"));
+}
+
+TEST(PositionTests, testFENRejectsImpossiblePositions)
+{
+    Position position;
+    //Pawns on the first or last rank
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K2p b - - 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k2P/8/8/8/8/8/8/4K3 w - - 0 1"));
+    //Missing or extra kings
+    EXPECT_FALSE(position.loadFEN("8/8/8/8/8/8/8/4K3 w - - 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/3KK3 w - - 0 1"));
+    //Black to move cannot have the white king in check
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/r3K3 b - - 0 1"));
+    //En passant on the wrong rank, without the pawn that moved, or with the squares it crossed taken
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d3 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/8/8/4P3/8/8/8/4K3 w - d6 0 1"));
+    EXPECT_FALSE(position.loadFEN("4k3/3n4/8/3pP3/8/8/8/4K3 w - d6 0 1"));
+    EXPECT_TRUE(position.loadFEN("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1"));
+    //Nothing may follow the move counters
+    ASSERT_FALSE(position.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1 e4"));
+}
+
+//Counters move with the game and come back on unmake
+TEST(PositionTests, testFENCountersFollowMoves)
+{
+    Position position;
+    position.loadFEN("4k3/8/8/8/8/8/4P3/4K3 w - - 5 40");
+    UndoState first, second, third;
+    position.makeMove(Move(4, 3), first);
+    position.makeMove(Move(60, 59), second);
+    EXPECT_EQ(position.toFEN(), "3k4/8/8/8/8/8/4P3/3K4 w - - 7 41");
+    position.makeMove(Move(12, 28, DOUBLE_PAWN_PUSH), third);
+    EXPECT_EQ(position.toFEN(), "3k4/8/8/8/4P3/8/8/3K4 b - e3 0 41");
+    position.unmakeMove(third);
+    position.unmakeMove(second);
+    position.unmakeMove(first);
+    ASSERT_EQ(position.toFEN(), "4k3/8/8/8/8/8/4P3/4K3 w - - 5 40");
+}
+
+TEST(PositionTests, testInsufficientMaterial)
+{
+    const char* dead[] = {
+        "4k3/8/8/8/8/8/8/4K3 w - - 0 1",
+        "4k3/8/8/8/8/8/8/4KN2 w - - 0 1",
+        "4kb2/8/8/8/8/8/8/4K3 w - - 0 1",
+        //Both bishops on dark squares
+        "4k3/8/8/8/8/8/8/2B1K1B1 b - - 0 1",
+    };
+    const char* alive[] = {
+        "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+        "4k3/8/8/8/8/8/8/3RK3 w - - 0 1",
+        "4k3/8/8/8/8/8/8/2B1KB2 w - - 0 1",
+        "4kn2/8/8/8/8/8/8/4KN2 w - - 0 1",
+        "4k3/8/8/8/8/8/8/3NKB2 w - - 0 1",
+    };
+    Position position;
+    for (const char* fen : dead){
+        ASSERT_TRUE(position.loadFEN(fen));
+        EXPECT_TRUE(position.hasInsufficientMaterial()) << fen;
+    }
+    for (const char* fen : alive){
+        ASSERT_TRUE(position.loadFEN(fen));
+        EXPECT_FALSE(position.hasInsufficientMaterial()) << fen;
+    }
+}
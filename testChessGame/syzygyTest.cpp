@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/engine.hpp"
+#include "../chessGameHeader/syzygy.hpp"
+
+static const char* syzygyDirectory = "syzygyTestTables";
+
+static void putLittle(std::vector<uint8_t>& out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static void padTo(std::vector<uint8_t>& out, size_t multiple)
+{
+    while (out.size() % multiple) {
+        out.push_back(0);
+    }
+}
+
+//KQvK WDL file in the real layout. White to move is Huffman coded in 16 byte blocks of
+//the codes 1, 00 and 01 over and over: a pair of pairs, a single value and a pair, every
+//value a win. Black to move is stored as the single value loss, wrong only for the
+//stalemates and the positions where the queen can be taken, which the prober plays out.
+static void writeQueenTable(const std::string& path)
+{
+    const int values = 31332, perBlock = 140, blocks = (values + perBlock - 1) / perBlock, span = 64;
+    std::vector<uint8_t> out = {0x71, 0xE8, 0x23, 0x5D};
+    //Split, no pawns, one group of order 0, then K, Q, k for both sides
+    out.insert(out.end(), {0x01, 0x00, 0x66, 0x55, 0xEE});
+    padTo(out, 2);
+
+    out.insert(out.end(), {0, 4, 6, 0});
+    putLittle(out, blocks, 4);
+    //Symbol lengths 1 to 2, the lowest symbol of each length, then three symbols: a win,
+    //a pair of it and a pair of that pair
+    out.insert(out.end(), {2, 1});
+    putLittle(out, 2, 2);
+    putLittle(out, 0, 2);
+    putLittle(out, 3, 2);
+    out.insert(out.end(), {4, 0xF0, 0xFF, 0, 0, 0, 1, 0x10, 0, 0});
+    out.insert(out.end(), {128, 0});
+
+    for (int k = 0; k < (values + span - 1) / span; ++k) {
+        int middle = k * span + span / 2;
+        putLittle(out, middle / perBlock, 4);
+        putLittle(out, middle % perBlock, 2);
+    }
+    for (int block = 0; block < blocks; ++block) {
+        int count = block + 1 < blocks ? perBlock : values - block * perBlock;
+        putLittle(out, count - 1, 2);
+    }
+    padTo(out, 64);
+    for (int block = 0; block < blocks; ++block) {
+        int count = block + 1 < blocks ? perBlock : values - block * perBlock;
+        //Seven values in 5 bits: 1 00 01
+        uint8_t bits[16] = {};
+        for (int bit = 0; bit < count / 7 * 5; ++bit) {
+            int place = bit % 5;
+            if (place == 0 || place == 4) {
+                bits[bit / 8] |= 0x80 >> (bit % 8);
+            }
+        }
+        out.insert(out.end(), bits, bits + 16);
+    }
+    padTo(out, 64);
+    out.resize(out.size() + 16);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+}
+
+static const SyzygyTablebases& testTables()
+{
+    static SyzygyTablebases tables;
+    static bool loaded = false;
+    if (!loaded) {
+        mkdir(syzygyDirectory, 0755);
+        std::string directory = syzygyDirectory;
+        writeQueenTable(directory + "/KQvK.rtbw");
+        std::ofstream(directory + "/KRvK.rtbw") << "not a table";
+        std::ofstream(directory + "/KQ.rtbw") << "no side";
+        std::ofstream(directory + "/KQvK.txt") << "not a table name";
+        loaded = true;
+        tables.load("missingSyzygyDirectory:" + directory);
+    }
+    return tables;
+}
+
+static bool probeFEN(const SyzygyTablebases& tables, const char* fen, WDLScore& result)
+{
+    Position position;
+    EXPECT_TRUE(position.loadFEN(fen));
+    return tables.probeWDL(position, result);
+}
+
+TEST(SyzygyTests, testLoadRegistersTableNames)
+{
+    SyzygyTablebases none;
+    EXPECT_EQ(none.load("missingSyzygyDirectory"), 0);
+    EXPECT_EQ(none.getMaxPieces(), 0);
+
+    const SyzygyTablebases& tables = testTables();
+    EXPECT_EQ(tables.size(), 2u);
+    ASSERT_EQ(tables.getMaxPieces(), 3);
+}
+
+TEST(SyzygyTests, testProbeFailsWithoutTheFile)
+{
+    WDLScore result;
+    //Named right but not a table, mapped and rejected on the first probe
+    EXPECT_FALSE(probeFEN(testTables(), "8/8/8/4k3/8/8/8/R3K3 w - - 0 1", result));
+    EXPECT_FALSE(probeFEN(testTables(), "8/8/8/4k3/8/8/8/1R2K3 b - - 0 1", result));
+    EXPECT_FALSE(probeFEN(testTables(), "8/8/8/4k3/8/8/8/N3K3 w - - 0 1", result));
+    //Castling rights are never in the files
+    EXPECT_FALSE(probeFEN(testTables(), "4k3/8/8/8/8/8/8/R3K3 w Q - 0 1", result));
+
+    ASSERT_TRUE(probeFEN(testTables(), "8/8/8/4k3/8/8/8/4K3 w - - 0 1", result));
+    ASSERT_EQ(result, WDLScore::Draw);
+}
+
+//Every queen and black king square against a fixed white king, with either side to move
+//and with the colors swapped, which looks the same values up through every symmetry
+TEST(SyzygyTests, testProbeQueenAgainstKing)
+{
+    const SyzygyTablebases& tables = testTables();
+    for (int queen = 0; queen < 64; ++queen) {
+        for (int king = 0; king < 64; ++king) {
+            for (Color strong : {Color::White, Color::Black}) {
+                for (Color side : {Color::White, Color::Black}) {
+                    const int strongKing = 19;
+                    int kingGap = std::max(std::abs((king & 7) - (strongKing & 7)), std::abs((king >> 3) - (strongKing >> 3)));
+                    if (queen == strongKing || king == strongKing || queen == king || kingGap < 2) {
+                        continue;
+                    }
+                    Position position;
+                    position.clear();
+                    position.addPiece(strong, PieceType::King, strongKing);
+                    position.addPiece(strong, PieceType::Queen, queen);
+                    position.addPiece(opposite(strong), PieceType::King, king);
+                    position.setSideToMove(side);
+                    if (position.isInCheck(opposite(side))) {
+                        continue;
+                    }
+                    MoveList moves;
+                    position.generateLegalMoves(side, moves);
+                    bool takesQueen = false;
+                    for (int i = 0; i < moves.size(); ++i) {
+                        takesQueen |= moves[i].isCapture();
+                    }
+                    if (moves.size() == 0 && !position.isInCheck(side)) {
+                        continue;
+                    }
+
+                    WDLScore result;
+                    ASSERT_TRUE(tables.probeWDL(position, result));
+                    WDLScore expected = side == strong ? WDLScore::Win : takesQueen ? WDLScore::Draw : WDLScore::Loss;
+                    char fen[FEN_MAX_LENGTH];
+                    position.writeFEN(fen);
+                    ASSERT_EQ(result, expected) << fen;
+                }
+            }
+        }
+    }
+}
+
+TEST(SyzygyTests, testDtzNeedsItsFile)
+{
+    Position position;
+    position.loadFEN("8/8/8/4k3/8/8/8/KQ6 w - - 0 1");
+    int dtz;
+    Move best;
+    WDLScore result;
+    EXPECT_FALSE(testTables().probeDTZ(position, dtz));
+    ASSERT_FALSE(testTables().probeRoot(position, best, result));
+}
+
+TEST(SyzygyTests, testEngineScoresCaptureIntoTables)
+{
+    Engine engine(1);
+    engine.setSyzygy(&testTables());
+    Position position;
+    position.loadFEN("8/8/8/4k3/8/3n4/8/KQ6 w - - 0 1");
+    engine.setPosition(position);
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    SearchResult result = engine.search(limits);
+    EXPECT_EQ(moveToString(result.bestMove), "b1d3");
+    ASSERT_EQ(result.score, SYZYGY_WIN_SCORE);
+}
+
+//Real tables from SYZYGY_PATH, skipped without them
+TEST(SyzygyTests, testProbeDownloadedTables)
+{
+    const char* path = std::getenv("SYZYGY_PATH");
+    SyzygyTablebases tables;
+    if (!path || tables.load(path) == 0) {
+        GTEST_SKIP() << "SYZYGY_PATH has no Syzygy tables";
+    }
+    WDLScore result;
+    ASSERT_TRUE(probeFEN(tables, "8/8/8/4k3/8/8/8/R3K3 w - - 0 1", result));
+    EXPECT_EQ(result, WDLScore::Win);
+    ASSERT_TRUE(probeFEN(tables, "8/4k3/8/4K3/4P3/8/8/8 w - - 0 1", result));
+    EXPECT_EQ(result, WDLScore::Draw);
+    ASSERT_TRUE(probeFEN(tables, "8/4k3/8/4K3/4P3/8/8/8 b - - 0 1", result));
+    EXPECT_EQ(result, WDLScore::Loss);
+
+    //The root move brings the rook mate one move closer, give or take the rounding
+    Position position;
+    position.loadFEN("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+    int dtz, childDtz;
+    Move best;
+    ASSERT_TRUE(tables.probeDTZ(position, dtz));
+    ASSERT_GT(dtz, 0);
+    ASSERT_TRUE(tables.probeRoot(position, best, result));
+    EXPECT_EQ(result, WDLScore::Win);
+    UndoState undo;
+    position.makeMove(best, undo);
+    ASSERT_TRUE(tables.probeDTZ(position, childDtz));
+    EXPECT_LT(childDtz, 0);
+    ASSERT_LE(std::abs(-childDtz - (dtz - 1)), 1);
+}
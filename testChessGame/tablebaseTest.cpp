@@ -0,0 +1,203 @@
+#include <iostream>
+
+#include <sys/stat.h>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/engine.hpp"
+#include "../chessGameHeader/tablebase.hpp"
+
+static const char* tableDirectory = "tablebaseTestTables";
+
+//KPvK pulls in every three piece table it promotes to, about a second to build
+static const Tablebases& testTables()
+{
+    static Tablebases tables;
+    static bool generated = false;
+    if (!generated) {
+        mkdir(tableDirectory, 0755);
+        generated = generateTablebase("KPvK", tableDirectory, 2);
+        tables.load(tableDirectory);
+    }
+    return tables;
+}
+
+static TBResult probeFEN(const char* fen, bool& found)
+{
+    Position position;
+    EXPECT_TRUE(position.loadFEN(fen));
+    TBResult result = {TBOutcome::Draw, 0};
+    found = testTables().probe(position, result);
+    return result;
+}
+
+TEST(TablebaseTests, testCanonicalNames)
+{
+    EXPECT_EQ(canonicalTablebaseName("KvKQ"), "KQvK");
+    EXPECT_EQ(canonicalTablebaseName("KRvKRP"), "KRPvKR");
+    EXPECT_EQ(canonicalTablebaseName("KPvKN"), "KNvKP");
+    EXPECT_EQ(canonicalTablebaseName("KQ"), "");
+    EXPECT_EQ(canonicalTablebaseName("KKvK"), "");
+    ASSERT_EQ(canonicalTablebaseName("KQRBvKN"), "");
+}
+
+TEST(TablebaseTests, testLongestMates)
+{
+    const Tablebases& tables = testTables();
+    ASSERT_TRUE(tables.contains("KQvK"));
+    ASSERT_TRUE(tables.contains("KRvK"));
+    ASSERT_TRUE(tables.contains("KBvK"));
+    ASSERT_TRUE(tables.contains("KNvK"));
+    ASSERT_EQ(tables.getMaxPieces(), 3);
+
+    //Known longest mates: 10 moves with the queen, 16 with the rook, counted from the side mated
+    TablebaseFile queen, rook;
+    ASSERT_TRUE(queen.load(std::string(tableDirectory) + "/KQvK.cgtb"));
+    ASSERT_TRUE(rook.load(std::string(tableDirectory) + "/KRvK.cgtb"));
+    EXPECT_EQ(queen.getLongestMate(), 20);
+    ASSERT_EQ(rook.getLongestMate(), 32);
+}
+
+//Header plus a byte for each side to move, king pair and square of the other pieces
+TEST(TablebaseTests, testTablesAreReducedBySymmetry)
+{
+    testTables();
+    struct stat queen, pawn;
+    ASSERT_EQ(stat((std::string(tableDirectory) + "/KQvK.cgtb").c_str(), &queen), 0);
+    ASSERT_EQ(stat((std::string(tableDirectory) + "/KPvK.cgtb").c_str(), &pawn), 0);
+    EXPECT_EQ(queen.st_size, 32 + 2 * 462 * 64);
+    ASSERT_EQ(pawn.st_size, 32 + 2 * 1806 * 48);
+
+    //Every symmetry of a position without pawns, and the mirror of one with, agree
+    bool found;
+    TBResult corner = probeFEN("8/8/8/8/8/2k5/8/K6Q w - - 0 1", found);
+    ASSERT_TRUE(found);
+    for (const char* fen : {"K6Q/8/2k5/8/8/8/8/8 w - - 0 1", "8/8/8/8/8/5k2/8/Q6K w - - 0 1",
+                            "Q7/8/8/8/8/2k5/8/K7 w - - 0 1", "7Q/8/8/8/8/5k2/8/7K w - - 0 1"}){
+        TBResult turned = probeFEN(fen, found);
+        EXPECT_TRUE(found);
+        EXPECT_EQ(turned.outcome, corner.outcome);
+        EXPECT_EQ(turned.plies, corner.plies);
+    }
+    TBResult pawnLeft = probeFEN("8/8/8/2k5/8/8/1P6/1K6 b - - 0 1", found);
+    TBResult pawnRight = probeFEN("8/8/8/5k2/8/8/6P1/6K1 b - - 0 1", found);
+    EXPECT_EQ(pawnLeft.outcome, pawnRight.outcome);
+    ASSERT_EQ(pawnLeft.plies, pawnRight.plies);
+}
+
+TEST(TablebaseTests, testProbeKnownPositions)
+{
+    bool found;
+    TBResult mated = probeFEN("k7/1Q6/1K6/8/8/8/8/8 b - - 0 1", found);
+    EXPECT_TRUE(found);
+    EXPECT_EQ(mated.outcome, TBOutcome::Loss);
+    EXPECT_EQ(mated.plies, 0);
+
+    TBResult mateInOne = probeFEN("k7/8/1K6/8/8/8/7Q/8 w - - 0 1", found);
+    EXPECT_TRUE(found);
+    EXPECT_EQ(mateInOne.outcome, TBOutcome::Win);
+    EXPECT_EQ(mateInOne.plies, 1);
+
+    //Same mate with the colors swapped and the board mirrored
+    TBResult mirrored = probeFEN("8/8/8/8/8/1k6/1q6/K7 w - - 0 1", found);
+    EXPECT_TRUE(found);
+    EXPECT_EQ(mirrored.outcome, TBOutcome::Loss);
+    ASSERT_EQ(mirrored.plies, 0);
+}
+
+TEST(TablebaseTests, testKingAndPawnOpposition)
+{
+    //Black holds the opposition with White to move, loses it with Black to move
+    bool found;
+    TBResult whiteToMove = probeFEN("8/4k3/8/4K3/4P3/8/8/8 w - - 0 1", found);
+    EXPECT_TRUE(found);
+    EXPECT_EQ(whiteToMove.outcome, TBOutcome::Draw);
+
+    TBResult blackToMove = probeFEN("8/4k3/8/4K3/4P3/8/8/8 b - - 0 1", found);
+    EXPECT_TRUE(found);
+    ASSERT_EQ(blackToMove.outcome, TBOutcome::Loss);
+}
+
+TEST(TablebaseTests, testProbeSkipsCastlingRights)
+{
+    bool found;
+    probeFEN("4k3/8/8/8/8/8/8/4K2R w K - 0 1", found);
+    EXPECT_FALSE(found);
+    probeFEN("4k3/8/8/8/8/8/8/4K2R w - - 0 1", found);
+    ASSERT_TRUE(found);
+}
+
+//Every rook square against fixed kings: a win in n must have a move to a loss in n - 1
+//and none to anything shorter, a loss in n only moves to wins of at most n - 1
+TEST(TablebaseTests, testRookResultsAgreeWithTheirMoves)
+{
+    const Tablebases& tables = testTables();
+    for (int rook = 0; rook < 64; ++rook) {
+        for (Color side : {Color::White, Color::Black}) {
+            Position position;
+            position.clear();
+            if (rook == 4 || rook == 60) {
+                continue;
+            }
+            position.addPiece(Color::White, PieceType::King, 4);
+            position.addPiece(Color::Black, PieceType::King, 60);
+            position.addPiece(Color::White, PieceType::Rook, rook);
+            position.setSideToMove(side);
+            if (position.isInCheck(opposite(side))) {
+                continue;
+            }
+            TBResult result;
+            ASSERT_TRUE(tables.probe(position, result));
+
+            MoveList moves;
+            position.generateLegalMoves(side, moves);
+            int bestWin = 1000, longestLoss = -1;
+            bool draw = false;
+            for (int i = 0; i < moves.size(); ++i) {
+                UndoState undo;
+                TBResult child;
+                position.makeMove(moves[i], undo);
+                ASSERT_TRUE(tables.probe(position, child));
+                position.unmakeMove(undo);
+                if (child.outcome == TBOutcome::Loss && child.plies + 1 < bestWin) {
+                    bestWin = child.plies + 1;
+                }
+                if (child.outcome == TBOutcome::Win && child.plies + 1 > longestLoss) {
+                    longestLoss = child.plies + 1;
+                }
+                draw |= child.outcome == TBOutcome::Draw;
+            }
+            if (result.outcome == TBOutcome::Win) {
+                ASSERT_EQ(result.plies, bestWin);
+            }
+            else if (result.outcome == TBOutcome::Loss) {
+                ASSERT_FALSE(draw);
+                ASSERT_EQ(bestWin, 1000);
+                ASSERT_EQ(result.plies, moves.size() ? longestLoss : 0);
+            }
+        }
+    }
+}
+
+TEST(TablebaseTests, testEnginePlaysFromTables)
+{
+    Position position;
+    position.loadFEN("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+    TBResult expected;
+    ASSERT_TRUE(testTables().probe(position, expected));
+    ASSERT_EQ(expected.outcome, TBOutcome::Win);
+
+    Engine engine(1);
+    engine.setTablebases(&testTables());
+    engine.setPosition(position);
+    SearchLimits limits;
+    limits.maxDepth = 1;
+    SearchResult result = engine.search(limits);
+    EXPECT_EQ(result.score, MATE_SCORE - expected.plies);
+
+    UndoState undo;
+    TBResult after;
+    position.makeMove(result.bestMove, undo);
+    ASSERT_TRUE(testTables().probe(position, after));
+    EXPECT_EQ(after.outcome, TBOutcome::Loss);
+    ASSERT_EQ(after.plies, expected.plies - 1);
+}
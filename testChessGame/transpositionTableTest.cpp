@@ -0,0 +1,58 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/transpositionTable.hpp"
+
+TEST(TranspositionTableTests, testSizeInMegabytes)
+{
+    TranspositionTable table(2);
+
+    EXPECT_EQ(table.getSizeInBytes(), 2u * 1024 * 1024);
+    ASSERT_EQ(table.getEntryCount(), 2u * 1024 * 1024 / 16);
+}
+
+TEST(TranspositionTableTests, testStoreThenProbe)
+{
+    TranspositionTable table(1);
+    table.store(0x123456789ABCDEFULL, Move(12, 28, DOUBLE_PAWN_PUSH), -250, 7, BOUND_EXACT);
+
+    TTData entry;
+    ASSERT_TRUE(table.probe(0x123456789ABCDEFULL, entry));
+    EXPECT_EQ(entry.move, Move(12, 28, DOUBLE_PAWN_PUSH));
+    EXPECT_EQ(entry.score, -250);
+    EXPECT_EQ(entry.depth, 7);
+    ASSERT_EQ(entry.bound, BOUND_EXACT);
+}
+
+TEST(TranspositionTableTests, testProbeMissesOtherKey)
+{
+    TranspositionTable table(1);
+    table.store(42, Move(1, 18), 10, 3, BOUND_LOWER);
+
+    TTData entry;
+    ASSERT_FALSE(table.probe(43, entry));
+}
+
+TEST(TranspositionTableTests, testStoreWithoutMoveKeepsOldMove)
+{
+    TranspositionTable table(1);
+    table.store(99, Move(6, 21), 30, 2, BOUND_LOWER);
+    table.store(99, Move(), -5, 4, BOUND_UPPER);
+
+    TTData entry;
+    ASSERT_TRUE(table.probe(99, entry));
+    EXPECT_EQ(entry.move, Move(6, 21));
+    EXPECT_EQ(entry.depth, 4);
+    ASSERT_EQ(entry.bound, BOUND_UPPER);
+}
+
+TEST(TranspositionTableTests, testClearEmptiesTable)
+{
+    TranspositionTable table(1);
+    table.store(7, Move(1, 2), 0, 1, BOUND_EXACT);
+    table.clear();
+
+    TTData entry;
+    EXPECT_FALSE(table.probe(7, entry));
+    ASSERT_EQ(table.hashfull(), 0);
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+
+#include "gtest/gtest.h"
+#include "../chessGameHeader/chessBoard.hpp"
+#include "../chessGameHeader/perft.hpp"
+#include "../chessGameHeader/pgn.hpp"
+
+//Walks the move tree and checks the incremental key against a full recompute at every node
+static void checkKeys(Position& position, int depth)
+{
+    ASSERT_EQ(position.getHashKey(), position.computeHashKey());
+    if (depth == 0) {
+        return;
+    }
+    MoveList moves;
+    position.generateLegalMoves(position.getSideToMove(), moves);
+    for (const Move& m : moves) {
+        uint64_t before = position.getHashKey();
+        UndoState undo;
+        position.makeMove(m, undo);
+        checkKeys(position, depth - 1);
+        position.unmakeMove(undo);
+        ASSERT_EQ(position.getHashKey(), before);
+    }
+}
+
+//Incremental update Tests
+TEST(ZobristTests, testIncrementalMatchesFull)
+{
+    for (int i = 0; i < perftSuiteSize; ++i) {
+        Position position;
+        position.loadFEN(perftSuite[i].fen);
+        checkKeys(position, 3);
+    }
+}
+
+TEST(ZobristTests, testTransposition)
+{
+    //1. Nf3 Nf6 2. Nc3 and 1. Nc3 Nf6 2. Nf3 reach the same position
+    Position first;
+    Position second;
+    first.loadFEN(perftSuite[0].fen);
+    second.loadFEN(perftSuite[0].fen);
+    UndoState undo[3];
+    first.makeMove(Move(6, 21), undo[0]);
+    first.makeMove(Move(62, 45), undo[1]);
+    first.makeMove(Move(1, 18), undo[2]);
+    second.makeMove(Move(1, 18), undo[0]);
+    second.makeMove(Move(62, 45), undo[1]);
+    second.makeMove(Move(6, 21), undo[2]);
+
+    ASSERT_EQ(first.getHashKey(), second.getHashKey());
+}
+
+TEST(ZobristTests, testSideToMoveChangesKey)
+{
+    Position white;
+    Position black;
+    white.loadFEN("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    black.loadFEN("4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+
+    ASSERT_NE(white.getHashKey(), black.getHashKey());
+}
+
+static Position playedFrom(std::initializer_list<Move> moves)
+{
+    Position position;
+    position.loadFEN(START_FEN);
+    for (Move m : moves) {
+        UndoState undo;
+        position.makeMove(m, undo);
+    }
+    return position;
+}
+
+TEST(ZobristTests, testUselessEnPassantIgnored)
+{
+    //1. e4 e6 2. d4 and 1. d4 e6 2. e4, black has no pawn to take on d3 or e3
+    Position first = playedFrom({Move(12, 28, DOUBLE_PAWN_PUSH), Move(52, 44), Move(11, 27, DOUBLE_PAWN_PUSH)});
+    Position second = playedFrom({Move(11, 27, DOUBLE_PAWN_PUSH), Move(52, 44), Move(12, 28, DOUBLE_PAWN_PUSH)});
+    EXPECT_EQ(first.getHashKey(), second.getHashKey());
+
+    //Here white can take en passant, so the square matters
+    Position withCapture = playedFrom({Move(12, 28, DOUBLE_PAWN_PUSH), Move(48, 40), Move(28, 36),
+                                       Move(51, 35, DOUBLE_PAWN_PUSH)});
+    Position withoutCapture;
+    withoutCapture.loadFEN("rnbqkbnr/1pp1pppp/p7/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3");
+    EXPECT_EQ(withCapture.getHashKey(), withCapture.computeHashKey());
+    ASSERT_NE(withCapture.getHashKey(), withoutCapture.getHashKey());
+}
+
+//chessBoard keeps the key through the square view too
+TEST(ZobristTests, testBoardKeyMatchesFull)
+{
+    chessBoard board;
+    board.setupBoard();
+    board.movePiece(6, 4, 4, 4);
+
+    EXPECT_EQ(board.getHashKey(), board.getPosition().computeHashKey());
+    board.makeMove(Move(52, 36, DOUBLE_PAWN_PUSH));
+    board.unmakeMove();
+    ASSERT_EQ(board.getHashKey(), board.getPosition().computeHashKey());
+}
+
+TEST(ZobristTests, testKeyAfterMatchesMadeMove)
+{
+    Position position;
+    position.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    //A quiet knight move and a capture, neither touches castling or en passant
+    Move moves[2] = {Move(18, 24), Move(36, 53, CAPTURE)};
+
+    for (Move m : moves){
+        uint64_t predicted = position.keyAfter(m);
+        UndoState undo;
+        position.makeMove(m, undo);
+        EXPECT_EQ(predicted, position.getHashKey());
+        position.unmakeMove(undo);
+    }
+}